@@ -0,0 +1,68 @@
+#include "bench.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "bul/jobs.h"
+
+#include "gltf.h"
+
+#define THREAD_COUNTS 1, 4, 16
+
+// Bumpy grids of 64x64 quads, 64 of them are about as many vertices as Sponza
+static constexpr uint32_t GRID_SIZE = 64;
+static constexpr uint32_t PRIMITIVE_COUNT = 64;
+
+static void add_grid(uint32_t seed, std::vector<gltf::Primitive>& primitives, std::vector<gltf::Vertex>& vertices,
+                     std::vector<uint32_t>& indices)
+{
+    gltf::Primitive& primitive = primitives.emplace_back();
+    primitive.vertex_start = (uint32_t)vertices.size();
+    primitive.vertex_count = (GRID_SIZE + 1) * (GRID_SIZE + 1);
+    primitive.index_start = (uint32_t)indices.size();
+    primitive.index_count = GRID_SIZE * GRID_SIZE * 6;
+
+    for (uint32_t y = 0; y <= GRID_SIZE; ++y)
+    {
+        for (uint32_t x = 0; x <= GRID_SIZE; ++x)
+        {
+            float height = std::sin(x * 0.3f + seed) * std::cos(y * 0.2f);
+            gltf::Vertex& vertex = vertices.emplace_back();
+            vertex.position = {(float)x, height, (float)y, 1.0f};
+            bul::vec3f normal{-0.3f * std::cos(x * 0.3f + seed), 1.0f, 0.2f * std::sin(y * 0.2f)};
+            vertex.normal = bul::vec4f{normal / bul::length(normal), 0.0f};
+            vertex.uv_0 = {(float)x / GRID_SIZE, (float)y / GRID_SIZE};
+        }
+    }
+
+    for (uint32_t y = 0; y < GRID_SIZE; ++y)
+    {
+        for (uint32_t x = 0; x < GRID_SIZE; ++x)
+        {
+            uint32_t corner = primitive.vertex_start + y * (GRID_SIZE + 1) + x;
+            uint32_t quad[6] = {corner, corner + GRID_SIZE + 1, corner + 1,
+                                corner + 1, corner + GRID_SIZE + 1, corner + GRID_SIZE + 2};
+            indices.insert(indices.end(), quad, quad + 6);
+        }
+    }
+}
+
+BENCHMARK(gltf_generate_tangents, THREAD_COUNTS)
+{
+    bul::jobs::init(uint32_t(state.arg()));
+    std::vector<gltf::Primitive> primitives;
+    std::vector<gltf::Vertex> vertices;
+    std::vector<uint32_t> indices;
+    for (uint32_t i = 0; i < PRIMITIVE_COUNT; ++i)
+    {
+        add_grid(i, primitives, vertices, indices);
+    }
+
+    state.set_items(vertices.size());
+    state.measure([&]() {
+        gltf::generate_tangents(primitives, vertices, indices);
+        bench::do_not_optimize(vertices.data());
+    });
+    bul::jobs::shutdown();
+}
@@ -0,0 +1,139 @@
+#include "bench.h"
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+
+#include "texture.h"
+
+// The Sponza textures when the model is there, like the renderer expects it, synthetic ones otherwise
+static constexpr const char* SPONZA_DIR = "../models/Sponza/glTF";
+
+struct Image
+{
+    std::vector<uint8_t> rgba;
+    uint32_t width;
+    uint32_t height;
+};
+
+static std::vector<Image> load_images()
+{
+    std::vector<Image> images;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(SPONZA_DIR, error))
+    {
+        int width, height, channels;
+        uint8_t* rgba = stbi_load(entry.path().string().c_str(), &width, &height, &channels, STBI_rgb_alpha);
+        if (rgba == nullptr)
+        {
+            continue;
+        }
+        images.push_back({std::vector<uint8_t>(rgba, rgba + width * height * 4), (uint32_t)width, (uint32_t)height});
+        stbi_image_free(rgba);
+    }
+
+    if (images.empty())
+    {
+        // Gradients, a high frequency pattern and an alpha ramp
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            Image& image = images.emplace_back(Image{{}, 512, 512});
+            image.rgba.resize(image.width * image.height * 4);
+            for (uint32_t y = 0; y < image.height; ++y)
+            {
+                for (uint32_t x = 0; x < image.width; ++x)
+                {
+                    uint8_t* pixel = &image.rgba[(y * image.width + x) * 4];
+                    pixel[0] = uint8_t(128 + 120 * std::sin(x * 0.02f * (i + 1)));
+                    pixel[1] = uint8_t(y / 2);
+                    pixel[2] = uint8_t(((x ^ y) >> i) * 16);
+                    pixel[3] = i % 2 ? uint8_t(x / 2) : 255;
+                }
+            }
+        }
+    }
+    return images;
+}
+
+static const std::vector<Image>& images()
+{
+    static const std::vector<Image> images = load_images();
+    return images;
+}
+
+static uint64_t image_bytes()
+{
+    uint64_t bytes = 0;
+    for (const Image& image : images())
+    {
+        bytes += image.rgba.size();
+    }
+    return bytes;
+}
+
+// Mean PSNR of the first level over the images, BC5 only keeps red and green
+static double mean_psnr(const texture::ImportOptions& options)
+{
+    double sum = 0;
+    for (const Image& image : images())
+    {
+        texture::Texture texture = texture::import(image.rgba.data(), image.width, image.height, options);
+        std::vector<uint8_t> reference = image.rgba;
+        if (texture.format == texture::Format::BC5)
+        {
+            for (size_t i = 0; i < reference.size(); i += 4)
+            {
+                reference[i + 2] = 0;
+                reference[i + 3] = 255;
+            }
+        }
+        std::vector<uint8_t> decoded = texture::decode(texture, 0);
+        sum += std::min(texture::psnr(decoded.data(), reference.data(), reference.size()), 100.0);
+    }
+    return sum / images().size();
+}
+
+static void import_images(bench::State& state, const texture::ImportOptions& options)
+{
+    state.set_bytes(image_bytes());
+    if (options.compress)
+    {
+        state.set_counter("psnr_db", mean_psnr(options));
+    }
+    state.measure([&]() {
+        for (const Image& image : images())
+        {
+            bench::do_not_optimize(texture::import(image.rgba.data(), image.width, image.height, options));
+        }
+    });
+}
+
+// BC1, or BC3 for the images with alpha
+BENCHMARK(texture_encode_bc1_bc3)
+{
+    import_images(state, {.generate_mips = false});
+}
+
+BENCHMARK(texture_encode_bc5)
+{
+    import_images(state, {.normal_map = true, .generate_mips = false});
+}
+
+BENCHMARK(texture_encode_bc7)
+{
+    import_images(state, {.bc7 = true, .generate_mips = false});
+}
+
+BENCHMARK(texture_mips_box)
+{
+    import_images(state, {.mip_filter = texture::MipFilter::Box, .compress = false});
+}
+
+BENCHMARK(texture_mips_kaiser)
+{
+    import_images(state, {.mip_filter = texture::MipFilter::Kaiser, .compress = false});
+}
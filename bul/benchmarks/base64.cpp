@@ -0,0 +1,42 @@
+#include "bench.h"
+
+#include <random>
+#include <string>
+
+#include "bul/base64.h"
+
+#define BASE64_SIZES 1'024, 65'536, 1'048'576, 16'777'216
+
+static std::string random_base64(size_t decoded_size)
+{
+    constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::mt19937 rng(1);
+    std::string str((decoded_size + 2) / 3 * 4, 'A');
+    for (char& c : str)
+    {
+        c = alphabet[rng() % 64];
+    }
+    return str;
+}
+
+BENCHMARK(base64_decode, BASE64_SIZES)
+{
+    std::string str = random_base64(state.arg());
+    std::vector<uint8_t> data(bul::base64_decoded_size(str));
+    state.set_bytes(str.size());
+    state.measure([&]() {
+        bool valid = bul::base64_decode(str, data.data());
+        bench::do_not_optimize(valid);
+    });
+}
+
+BENCHMARK(base64_decode_scalar, BASE64_SIZES)
+{
+    std::string str = random_base64(state.arg());
+    std::vector<uint8_t> data(bul::base64_decoded_size(str));
+    state.set_bytes(str.size());
+    state.measure([&]() {
+        bool valid = bul::base64_decode_scalar(str, data.data());
+        bench::do_not_optimize(valid);
+    });
+}
@@ -0,0 +1,209 @@
+#include "bench.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+
+namespace bench
+{
+struct Benchmark
+{
+    std::string name;
+    Function fn;
+    int64_t arg;
+};
+
+static std::vector<Benchmark>& registry()
+{
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+Registration::Registration(const char* name, Function fn, std::vector<int64_t> args)
+{
+    if (args.empty())
+    {
+        registry().push_back(Benchmark{name, fn, 0});
+        return;
+    }
+    for (int64_t arg : args)
+    {
+        registry().push_back(Benchmark{std::string(name) + "/" + std::to_string(arg), fn, arg});
+    }
+}
+
+State::State(std::string name, int64_t arg, uint32_t max_repetitions, double min_repetition_ns, double budget_ns)
+    : arg_{arg}
+    , max_repetitions_{max_repetitions}
+    , min_repetition_ns_{min_repetition_ns}
+    , budget_ns_{budget_ns}
+{
+    result_.name = std::move(name);
+}
+
+static double percentile(const std::vector<double>& sorted, double p)
+{
+    double rank = p * (sorted.size() - 1);
+    size_t low = size_t(rank);
+    size_t high = std::min(low + 1, sorted.size() - 1);
+    return sorted[low] + (sorted[high] - sorted[low]) * (rank - low);
+}
+
+void State::finish(std::vector<double>& samples, uint64_t iterations)
+{
+    std::sort(samples.begin(), samples.end());
+
+    result_.iterations = iterations;
+    result_.repetitions = uint32_t(samples.size());
+    result_.min = samples.front();
+    result_.max = samples.back();
+    result_.median = percentile(samples, 0.5);
+    result_.p90 = percentile(samples, 0.9);
+    result_.p99 = percentile(samples, 0.99);
+    result_.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+
+    double variance = 0;
+    for (double sample : samples)
+    {
+        variance += (sample - result_.mean) * (sample - result_.mean);
+    }
+    result_.stddev = std::sqrt(variance / samples.size());
+
+    result_.items_per_second = items_ ? items_ * 1e9 / result_.median : 0;
+    result_.bytes_per_second = bytes_ ? bytes_ * 1e9 / result_.median : 0;
+}
+
+static void print_time(double ns)
+{
+    if (ns < 1e3)
+    {
+        printf("%10.2f ns", ns);
+    }
+    else if (ns < 1e6)
+    {
+        printf("%10.2f us", ns / 1e3);
+    }
+    else
+    {
+        printf("%10.2f ms", ns / 1e6);
+    }
+}
+
+static void print_result(const Result& result)
+{
+    printf("%-48s", result.name.c_str());
+    print_time(result.median);
+    print_time(result.p90);
+    print_time(result.p99);
+    printf("  %6.2f%%", result.median > 0 ? 100.0 * result.stddev / result.mean : 0.0);
+    if (result.bytes_per_second > 0)
+    {
+        printf("  %8.2f GB/s", result.bytes_per_second / 1e9);
+    }
+    else if (result.items_per_second > 0)
+    {
+        printf("  %8.2f M/s", result.items_per_second / 1e6);
+    }
+    for (const auto& [name, value] : result.counters)
+    {
+        printf("  %s %.2f", name.c_str(), value);
+    }
+    printf("\n");
+}
+
+static void write_json(const char* path, const std::vector<Result>& results)
+{
+    FILE* file = fopen(path, "w");
+    if (file == nullptr)
+    {
+        fprintf(stderr, "Could not open %s\n", path);
+        return;
+    }
+
+    fprintf(file, "{\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Result& r = results[i];
+        fprintf(file,
+                "    {\"name\": \"%s\", \"iterations\": %llu, \"repetitions\": %u, \"unit\": \"ns\", "
+                "\"min\": %.3f, \"median\": %.3f, \"mean\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f, "
+                "\"stddev\": %.3f, \"items_per_second\": %.1f, \"bytes_per_second\": %.1f",
+                r.name.c_str(), (unsigned long long)r.iterations, r.repetitions, r.min, r.median, r.mean, r.p90, r.p99,
+                r.max, r.stddev, r.items_per_second, r.bytes_per_second);
+        for (const auto& [name, value] : r.counters)
+        {
+            fprintf(file, ", \"%s\": %.3f", name.c_str(), value);
+        }
+        fprintf(file, "}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+}
+
+static void usage(const char* program)
+{
+    printf("usage: %s [--filter substring] [--json path] [--repetitions n] [--min-time-ms ms] [--budget-ms ms]\n",
+           program);
+}
+} // namespace bench
+
+int main(int argc, char** argv)
+{
+    const char* filter = nullptr;
+    const char* json_path = nullptr;
+    uint32_t repetitions = 30;
+    double min_time_ms = 2.0;
+    double budget_ms = 2000.0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--filter") == 0 && has_value)
+        {
+            filter = argv[++i];
+        }
+        else if (strcmp(argv[i], "--json") == 0 && has_value)
+        {
+            json_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--repetitions") == 0 && has_value)
+        {
+            repetitions = std::max(1, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--min-time-ms") == 0 && has_value)
+        {
+            min_time_ms = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--budget-ms") == 0 && has_value)
+        {
+            budget_ms = atof(argv[++i]);
+        }
+        else
+        {
+            bench::usage(argv[0]);
+            return 1;
+        }
+    }
+
+    printf("%-48s%13s%13s%13s%9s\n", "benchmark", "median", "p90", "p99", "cv");
+    std::vector<bench::Result> results;
+    for (const auto& benchmark : bench::registry())
+    {
+        if (filter && benchmark.name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+        bench::State state{benchmark.name, benchmark.arg, repetitions, min_time_ms * 1e6, budget_ms * 1e6};
+        benchmark.fn(state);
+        bench::print_result(state.result());
+        results.push_back(state.result());
+    }
+
+    if (json_path)
+    {
+        bench::write_json(json_path, results);
+    }
+    return 0;
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace bench
+{
+// Forces the compiler to materialize value without emitting any instruction
+template <typename T>
+inline void do_not_optimize(T const& value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    static volatile const void* sink;
+    sink = &value;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+// Forces pending writes to memory to be considered observable
+inline void clobber_memory()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : : "memory");
+#endif
+}
+
+struct Result
+{
+    std::string name;
+    uint64_t iterations = 0;
+    uint32_t repetitions = 0;
+    // Nanoseconds per call of the measured function
+    double min = 0;
+    double median = 0;
+    double mean = 0;
+    double p90 = 0;
+    double p99 = 0;
+    double max = 0;
+    double stddev = 0;
+    double items_per_second = 0;
+    double bytes_per_second = 0;
+    // Measurements other than time, such as the quality of a lossy encoder
+    std::vector<std::pair<std::string, double>> counters;
+};
+
+class State
+{
+public:
+    State(std::string name, int64_t arg, uint32_t max_repetitions, double min_repetition_ns, double budget_ns);
+
+    int64_t arg() const
+    {
+        return arg_;
+    }
+
+    // Items or bytes processed by one call, reported as throughput
+    void set_items(uint64_t items)
+    {
+        items_ = items;
+    }
+
+    void set_bytes(uint64_t bytes)
+    {
+        bytes_ = bytes;
+    }
+
+    void set_counter(std::string name, double value)
+    {
+        result_.counters.emplace_back(std::move(name), value);
+    }
+
+    // Calls fn in batches long enough to be timed reliably, after a warmup
+    template <typename F>
+    void measure(F&& fn)
+    {
+        measure_impl([]() {}, std::forward<F>(fn), true);
+    }
+
+    // setup runs outside of the timed region before every call of fn, for operations that consume their input
+    template <typename Setup, typename F>
+    void measure(Setup&& setup, F&& fn)
+    {
+        measure_impl(std::forward<Setup>(setup), std::forward<F>(fn), false);
+    }
+
+    const Result& result() const
+    {
+        return result_;
+    }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    template <typename Setup, typename F>
+    void measure_impl(Setup&& setup, F&& fn, bool batch)
+    {
+        auto run = [&](uint64_t iterations) {
+            setup();
+            auto start = clock::now();
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                fn();
+            }
+            clobber_memory();
+            return double(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count());
+        };
+
+        // Warmup and calibration, batched measurements grow until a repetition lasts long enough
+        uint64_t iterations = 1;
+        double elapsed = run(iterations);
+        while (batch && elapsed < min_repetition_ns_ && iterations < (1ull << 30))
+        {
+            iterations *= 2;
+            elapsed = run(iterations);
+        }
+
+        uint32_t repetitions = max_repetitions_;
+        if (elapsed * repetitions > budget_ns_)
+        {
+            repetitions = std::max(3u, uint32_t(budget_ns_ / elapsed));
+        }
+
+        std::vector<double> samples(repetitions);
+        for (auto& sample : samples)
+        {
+            sample = run(iterations) / double(iterations);
+        }
+        finish(samples, iterations);
+    }
+
+    void finish(std::vector<double>& samples, uint64_t iterations);
+
+    int64_t arg_;
+    uint32_t max_repetitions_;
+    double min_repetition_ns_;
+    double budget_ns_;
+    uint64_t items_ = 0;
+    uint64_t bytes_ = 0;
+    Result result_;
+};
+
+using Function = void (*)(State&);
+
+struct Registration
+{
+    Registration(const char* name, Function fn, std::vector<int64_t> args = {});
+};
+} // namespace bench
+
+#define BENCH_CONCAT_(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_(a, b)
+
+// Registers a benchmark, the optional arguments instantiate it once per value, available through State::arg
+#define BENCHMARK(NAME, ...)                                                                                           \
+    static void NAME(bench::State& state);                                                                             \
+    static bench::Registration BENCH_CONCAT(NAME, _registration){#NAME, NAME, {__VA_ARGS__}};                          \
+    static void NAME(bench::State& state)
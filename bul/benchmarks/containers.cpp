@@ -0,0 +1,395 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <unordered_map>
+
+#include "bul/containers/map.h"
+#include "bul/containers/swiss_map.h"
+#include "bul/containers/pool.h"
+#include "bul/containers/small_vector.h"
+#include "bul/containers/static_vector.h"
+#include "bul/containers/static_queue.h"
+
+#define MAP_SIZES 1'000, 10'000, 100'000, 1'000'000, 10'000'000
+#define POOL_SIZES 1'000, 100'000, 1'000'000
+#define SMALL_SIZES 1, 2, 4, 8, 16
+
+static std::vector<uint64_t> random_keys(size_t count, uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<uint64_t> keys(count);
+    for (auto& key : keys)
+    {
+        key = rng();
+    }
+    return keys;
+}
+
+/* Maps */
+
+template <typename M>
+struct MapOps;
+
+template <typename K, typename V>
+struct MapOps<bul::Map<K, V>>
+{
+    static void insert(bul::Map<K, V>& m, K key, V val)
+    {
+        m.insert(key, val);
+    }
+
+    static bool contains(bul::Map<K, V>& m, K key)
+    {
+        return m[key] != nullptr;
+    }
+
+    static void erase(bul::Map<K, V>& m, K key)
+    {
+        m.erase(key);
+    }
+};
+
+template <typename K, typename V>
+struct MapOps<bul::SwissMap<K, V>>
+{
+    static void insert(bul::SwissMap<K, V>& m, K key, V val)
+    {
+        m.insert(key, val);
+    }
+
+    static bool contains(bul::SwissMap<K, V>& m, K key)
+    {
+        return m[key] != nullptr;
+    }
+
+    static void erase(bul::SwissMap<K, V>& m, K key)
+    {
+        m.erase(key);
+    }
+};
+
+template <typename K, typename V>
+struct MapOps<std::unordered_map<K, V>>
+{
+    static void insert(std::unordered_map<K, V>& m, K key, V val)
+    {
+        m.emplace(key, val);
+    }
+
+    static bool contains(std::unordered_map<K, V>& m, K key)
+    {
+        return m.find(key) != m.end();
+    }
+
+    static void erase(std::unordered_map<K, V>& m, K key)
+    {
+        m.erase(key);
+    }
+};
+
+template <typename M>
+static M make_map(const std::vector<uint64_t>& keys)
+{
+    M m;
+    for (uint64_t key : keys)
+    {
+        MapOps<M>::insert(m, key, key);
+    }
+    return m;
+}
+
+template <typename M>
+static void map_insert(bench::State& state)
+{
+    auto keys = random_keys(state.arg(), 1);
+    std::optional<M> m;
+    state.set_items(keys.size());
+    state.measure([&]() { m.emplace(); },
+                  [&]() {
+                      for (uint64_t key : keys)
+                      {
+                          MapOps<M>::insert(*m, key, key);
+                      }
+                  });
+}
+
+template <typename M>
+static void map_lookup(bench::State& state, bool hit)
+{
+    auto keys = random_keys(state.arg(), 1);
+    M m = make_map<M>(keys);
+    auto lookups = hit ? keys : random_keys(state.arg(), 2);
+    std::shuffle(lookups.begin(), lookups.end(), std::mt19937_64(3));
+    state.set_items(lookups.size());
+    state.measure([&]() {
+        size_t found = 0;
+        for (uint64_t key : lookups)
+        {
+            found += MapOps<M>::contains(m, key);
+        }
+        bench::do_not_optimize(found);
+    });
+}
+
+template <typename M>
+static void map_erase(bench::State& state)
+{
+    auto keys = random_keys(state.arg(), 1);
+    const M full = make_map<M>(keys);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(3));
+    std::optional<M> m;
+    state.set_items(keys.size());
+    state.measure([&]() { m.emplace(full); },
+                  [&]() {
+                      for (uint64_t key : keys)
+                      {
+                          MapOps<M>::erase(*m, key);
+                      }
+                  });
+}
+
+using Map = bul::Map<uint64_t, uint64_t>;
+using SwissMap = bul::SwissMap<uint64_t, uint64_t>;
+using UnorderedMap = std::unordered_map<uint64_t, uint64_t>;
+
+BENCHMARK(map_insert, MAP_SIZES)
+{
+    map_insert<Map>(state);
+}
+
+BENCHMARK(swiss_map_insert, MAP_SIZES)
+{
+    map_insert<SwissMap>(state);
+}
+
+BENCHMARK(unordered_map_insert, MAP_SIZES)
+{
+    map_insert<UnorderedMap>(state);
+}
+
+BENCHMARK(map_lookup_hit, MAP_SIZES)
+{
+    map_lookup<Map>(state, true);
+}
+
+BENCHMARK(swiss_map_lookup_hit, MAP_SIZES)
+{
+    map_lookup<SwissMap>(state, true);
+}
+
+BENCHMARK(unordered_map_lookup_hit, MAP_SIZES)
+{
+    map_lookup<UnorderedMap>(state, true);
+}
+
+BENCHMARK(map_lookup_miss, MAP_SIZES)
+{
+    map_lookup<Map>(state, false);
+}
+
+BENCHMARK(swiss_map_lookup_miss, MAP_SIZES)
+{
+    map_lookup<SwissMap>(state, false);
+}
+
+BENCHMARK(unordered_map_lookup_miss, MAP_SIZES)
+{
+    map_lookup<UnorderedMap>(state, false);
+}
+
+BENCHMARK(map_erase, MAP_SIZES)
+{
+    map_erase<Map>(state);
+}
+
+BENCHMARK(swiss_map_erase, MAP_SIZES)
+{
+    map_erase<SwissMap>(state);
+}
+
+BENCHMARK(unordered_map_erase, MAP_SIZES)
+{
+    map_erase<UnorderedMap>(state);
+}
+
+/* Pool */
+
+BENCHMARK(pool_insert, POOL_SIZES)
+{
+    std::optional<bul::Pool<uint64_t>> pool;
+    state.set_items(state.arg());
+    state.measure([&]() { pool.emplace(); },
+                  [&]() {
+                      for (int64_t i = 0; i < state.arg(); ++i)
+                      {
+                          pool->insert(uint64_t(i));
+                      }
+                  });
+}
+
+BENCHMARK(pool_get, POOL_SIZES)
+{
+    bul::Pool<uint64_t> pool;
+    std::vector<bul::Handle<uint64_t>> handles;
+    for (int64_t i = 0; i < state.arg(); ++i)
+    {
+        handles.push_back(pool.insert(uint64_t(i)));
+    }
+    std::shuffle(handles.begin(), handles.end(), std::mt19937_64(3));
+    state.set_items(handles.size());
+    state.measure([&]() {
+        uint64_t sum = 0;
+        for (const auto& handle : handles)
+        {
+            sum += pool.get(handle);
+        }
+        bench::do_not_optimize(sum);
+    });
+}
+
+BENCHMARK(pool_erase_insert, POOL_SIZES)
+{
+    bul::Pool<uint64_t> pool;
+    std::vector<bul::Handle<uint64_t>> handles;
+    for (int64_t i = 0; i < state.arg(); ++i)
+    {
+        handles.push_back(pool.insert(uint64_t(i)));
+    }
+    state.set_items(handles.size());
+    state.measure([&]() {
+        for (auto& handle : handles)
+        {
+            pool.erase(handle);
+        }
+        for (auto& handle : handles)
+        {
+            handle = pool.insert(0);
+        }
+    });
+}
+
+BENCHMARK(pool_iterate, POOL_SIZES)
+{
+    bul::Pool<uint64_t> pool;
+    std::vector<bul::Handle<uint64_t>> handles;
+    for (int64_t i = 0; i < state.arg(); ++i)
+    {
+        handles.push_back(pool.insert(uint64_t(i)));
+    }
+    // Leave holes in the pool
+    for (size_t i = 0; i < handles.size(); i += 3)
+    {
+        pool.erase(handles[i]);
+    }
+    state.set_items(handles.size());
+    state.measure([&]() {
+        uint64_t sum = 0;
+        for (uint64_t value : pool)
+        {
+            sum += value;
+        }
+        bench::do_not_optimize(sum);
+    });
+}
+
+/* Small vectors */
+
+// Builds and destroys many short lists, like the children of a node or the writes of a descriptor set
+template <typename V>
+static void small_vector_build(bench::State& state)
+{
+    constexpr size_t VECTORS = 1024;
+    state.set_items(VECTORS);
+    state.measure([&]() {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < VECTORS; ++i)
+        {
+            V vector;
+            for (int64_t j = 0; j < state.arg(); ++j)
+            {
+                vector.push_back(i + j);
+            }
+            bench::do_not_optimize(vector);
+            sum += vector.back();
+        }
+        bench::do_not_optimize(sum);
+    });
+}
+
+BENCHMARK(small_vector_build, SMALL_SIZES)
+{
+    small_vector_build<bul::SmallVector<uint64_t, 8>>(state);
+}
+
+BENCHMARK(std_vector_build, SMALL_SIZES)
+{
+    small_vector_build<std::vector<uint64_t>>(state);
+}
+
+BENCHMARK(std_vector_reserved_build, SMALL_SIZES)
+{
+    struct Reserved : std::vector<uint64_t>
+    {
+        Reserved()
+        {
+            reserve(8);
+        }
+    };
+    small_vector_build<Reserved>(state);
+}
+
+/* Static containers */
+
+BENCHMARK(static_vector_push_clear)
+{
+    bul::StaticVector<uint64_t, 1024> vector;
+    state.set_items(vector.capacity());
+    state.measure([&]() {
+        for (uint64_t i = 0; i < vector.capacity(); ++i)
+        {
+            vector.push_back(i);
+        }
+        bench::do_not_optimize(vector);
+        vector.clear();
+    });
+}
+
+BENCHMARK(static_vector_iterate)
+{
+    bul::StaticVector<uint64_t, 1024> vector;
+    vector.resize(vector.capacity());
+    std::iota(vector.begin(), vector.end(), 0);
+    state.set_items(vector.size());
+    state.measure([&]() {
+        uint64_t sum = 0;
+        for (uint64_t value : vector)
+        {
+            sum += value;
+        }
+        bench::do_not_optimize(sum);
+    });
+}
+
+BENCHMARK(static_queue_push_pop)
+{
+    bul::StaticQueue<uint64_t, 1024> queue;
+    // Half full so that the ring wraps around
+    for (uint64_t i = 0; i < queue.capacity() / 2; ++i)
+    {
+        queue.push_back(i);
+    }
+    state.set_items(queue.capacity());
+    state.measure([&]() {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < queue.capacity(); ++i)
+        {
+            queue.push_back(i);
+            sum += queue.front();
+            queue.pop_front();
+        }
+        bench::do_not_optimize(sum);
+    });
+}
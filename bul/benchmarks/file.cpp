@@ -0,0 +1,112 @@
+#include "bench.h"
+
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+
+#include "bul/file.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define FILE_SIZES 1'048'576, 16'777'216, 268'435'456
+
+// Written once per size and left in the temp directory for the next runs, writing them takes longer than the benchmarks
+static std::string asset_path(size_t size)
+{
+    std::string path = (std::filesystem::temp_directory_path() / ("bul_bench_asset_" + std::to_string(size))).string();
+    if (bul::file_size(path.c_str()) != size)
+    {
+        std::vector<uint8_t> data(size);
+        std::mt19937 rng(1);
+        for (auto& byte : data)
+        {
+            byte = uint8_t(rng());
+        }
+        bul::write_file(path.c_str(), data.data(), data.size());
+    }
+    return path;
+}
+
+// Stands in for parsing: every byte is read once, so a mapping pays for all of its page faults
+static uint64_t consume(std::span<const uint8_t> bytes)
+{
+    uint64_t sum = 0;
+    for (size_t i = 0; i + 8 <= bytes.size(); i += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, bytes.data() + i, 8);
+        sum += word;
+    }
+    return sum;
+}
+
+BENCHMARK(file_read_warm, FILE_SIZES)
+{
+    std::string path = asset_path(state.arg());
+    state.set_bytes(state.arg());
+    state.measure([&]() {
+        std::vector<uint8_t> data;
+        bul::read_file(path.c_str(), data);
+        bench::do_not_optimize(consume(data));
+    });
+}
+
+BENCHMARK(file_mapped_warm, FILE_SIZES)
+{
+    std::string path = asset_path(state.arg());
+    state.set_bytes(state.arg());
+    state.measure([&]() {
+        bul::MappedFile file(path.c_str(), bul::MappedFile::Access::Sequential);
+        bench::do_not_optimize(consume(file));
+    });
+}
+
+// Cold runs evict the file from the page cache before every load. Only clean pages are dropped, which is the case
+// once asset_path has returned. Windows has no unprivileged way to do that for a single file.
+#if !defined(_WIN32)
+static void evict(const std::string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+BENCHMARK(file_read_cold, FILE_SIZES)
+{
+    std::string path = asset_path(state.arg());
+    state.set_bytes(state.arg());
+    state.measure([&]() { evict(path); },
+                  [&]() {
+                      std::vector<uint8_t> data;
+                      bul::read_file(path.c_str(), data);
+                      bench::do_not_optimize(consume(data));
+                  });
+}
+
+BENCHMARK(file_mapped_cold, FILE_SIZES)
+{
+    std::string path = asset_path(state.arg());
+    state.set_bytes(state.arg());
+    state.measure([&]() { evict(path); },
+                  [&]() {
+                      bul::MappedFile file(path.c_str(), bul::MappedFile::Access::Sequential);
+                      bench::do_not_optimize(consume(file));
+                  });
+}
+
+BENCHMARK(file_mapped_cold_random_hint, FILE_SIZES)
+{
+    std::string path = asset_path(state.arg());
+    state.set_bytes(state.arg());
+    state.measure([&]() { evict(path); },
+                  [&]() {
+                      bul::MappedFile file(path.c_str(), bul::MappedFile::Access::Random);
+                      bench::do_not_optimize(consume(file));
+                  });
+}
+#endif
@@ -0,0 +1,73 @@
+#include "bench.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <vector>
+
+#include "bul/format.h"
+
+static constexpr int MESSAGES = 256;
+
+// The formatter as it was before: vsnprintf once to measure, once to write
+static const char* format_two_pass(const char* fmt, ...)
+{
+    static thread_local std::vector<char> buffer;
+    std::va_list args;
+    va_start(args, fmt);
+    std::va_list args_copy;
+    va_copy(args_copy, args);
+    size_t size = vsnprintf(nullptr, 0, fmt, args);
+    if (size >= buffer.size())
+    {
+        buffer.resize(size + 1);
+    }
+    vsnprintf(buffer.data(), buffer.size(), fmt, args_copy);
+    va_end(args_copy);
+    va_end(args);
+    return buffer.data();
+}
+
+BENCHMARK(format_vsnprintf_two_pass)
+{
+    state.set_items(MESSAGES);
+    state.measure([&]() {
+        for (int i = 0; i < MESSAGES; ++i)
+        {
+            bench::do_not_optimize(format_two_pass("frame %d took %.3fms in %s", i, 16.6f, "render"));
+        }
+    });
+}
+
+BENCHMARK(format_vsnprintf)
+{
+    state.set_items(MESSAGES);
+    state.measure([&]() {
+        for (int i = 0; i < MESSAGES; ++i)
+        {
+            bench::do_not_optimize(bul::formatf("frame %d took %.3fms in %s", i, 16.6f, "render"));
+        }
+    });
+}
+
+BENCHMARK(format_to_chars)
+{
+    state.set_items(MESSAGES);
+    state.measure([&]() {
+        for (int i = 0; i < MESSAGES; ++i)
+        {
+            bench::do_not_optimize(bul::format("frame {} took {:.3}ms in {}", i, 16.6f, "render"));
+        }
+    });
+}
+
+// Shortest round trip floats, what %g can't do without 17 digits
+BENCHMARK(format_to_chars_shortest_float)
+{
+    state.set_items(MESSAGES);
+    state.measure([&]() {
+        for (int i = 0; i < MESSAGES; ++i)
+        {
+            bench::do_not_optimize(bul::format("position {} {} {}", 0.1f * i, 1.5f, -3.25f));
+        }
+    });
+}
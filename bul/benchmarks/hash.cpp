@@ -0,0 +1,108 @@
+#include "bench.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "bul/hash.h"
+#include "xxhash/xxhash.h"
+
+// Key sizes in bytes, the small ones are the usual map keys and descriptor contents
+#define HASH_SIZES 4, 8, 16, 32, 64, 256, 4'096
+static constexpr int KEYS = 1024;
+
+static std::vector<uint8_t> keys(size_t size)
+{
+    std::vector<uint8_t> data(size * KEYS);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = uint8_t(i * 131 + 7);
+    }
+    return data;
+}
+
+// What bul::hash was before
+BENCHMARK(hash_xxh64, HASH_SIZES)
+{
+    size_t size = size_t(state.arg());
+    std::vector<uint8_t> data = keys(size);
+    state.set_items(KEYS);
+    state.set_bytes(data.size());
+    state.measure([&]() {
+        for (int i = 0; i < KEYS; ++i)
+        {
+            bench::do_not_optimize(XXH64(data.data() + i * size, size, 0));
+        }
+    });
+}
+
+BENCHMARK(hash_xxh3, HASH_SIZES)
+{
+    size_t size = size_t(state.arg());
+    std::vector<uint8_t> data = keys(size);
+    state.set_items(KEYS);
+    state.set_bytes(data.size());
+    state.measure([&]() {
+        for (int i = 0; i < KEYS; ++i)
+        {
+            bench::do_not_optimize(bul::hash(data.data() + i * size, size));
+        }
+    });
+}
+
+BENCHMARK(hash_xxh3_128, HASH_SIZES)
+{
+    size_t size = size_t(state.arg());
+    std::vector<uint8_t> data = keys(size);
+    state.set_items(KEYS);
+    state.set_bytes(data.size());
+    state.measure([&]() {
+        for (int i = 0; i < KEYS; ++i)
+        {
+            bench::do_not_optimize(bul::hash128(data.data() + i * size, size));
+        }
+    });
+}
+
+// Three fields of a key, chained through the seed or streamed
+struct Key
+{
+    uint64_t a;
+    uint32_t b;
+    uint32_t c;
+};
+
+BENCHMARK(hash_combine_seeded)
+{
+    std::vector<Key> data(KEYS);
+    for (int i = 0; i < KEYS; ++i)
+    {
+        data[i] = {uint64_t(i) * 31, uint32_t(i), uint32_t(i) ^ 0xff};
+    }
+    state.set_items(KEYS);
+    state.measure([&]() {
+        for (const Key& key : data)
+        {
+            uint64_t seed = bul::hash(key.a);
+            seed = bul::hash_seeded(key.b, seed);
+            bench::do_not_optimize(bul::hash_seeded(key.c, seed));
+        }
+    });
+}
+
+BENCHMARK(hash_combine_streamed)
+{
+    std::vector<Key> data(KEYS);
+    for (int i = 0; i < KEYS; ++i)
+    {
+        data[i] = {uint64_t(i) * 31, uint32_t(i), uint32_t(i) ^ 0xff};
+    }
+    state.set_items(KEYS);
+    state.measure([&]() {
+        for (const Key& key : data)
+        {
+            bul::Hasher hasher;
+            hasher.add(key.a).add(key.b).add(key.c);
+            bench::do_not_optimize(hasher.digest());
+        }
+    });
+}
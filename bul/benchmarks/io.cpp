@@ -0,0 +1,164 @@
+#include "bench.h"
+
+#include <atomic>
+#include <filesystem>
+#include <random>
+#include <string>
+
+#include "bul/file.h"
+#include "bul/io.h"
+#include "bul/jobs.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// A directory of texture files, the argument is the size of one file
+#define TEXTURE_SIZES 65'536, 524'288
+static constexpr uint32_t TEXTURE_COUNT = 300;
+
+static std::string texture_path(size_t size, uint32_t index)
+{
+    return (std::filesystem::temp_directory_path() / ("bul_bench_textures_" + std::to_string(size))
+            / (std::to_string(index) + ".png"))
+        .string();
+}
+
+// Written once and left in the temp directory for the next runs
+static void create_textures(size_t size)
+{
+    std::filesystem::create_directories(std::filesystem::path(texture_path(size, 0)).parent_path());
+    std::mt19937 rng(1);
+    std::vector<uint8_t> data(size);
+    for (uint32_t i = 0; i < TEXTURE_COUNT; ++i)
+    {
+        std::string path = texture_path(size, i);
+        if (bul::file_size(path.c_str()) != size)
+        {
+            for (auto& byte : data)
+            {
+                byte = uint8_t(rng());
+            }
+            bul::write_file(path.c_str(), data.data(), data.size());
+        }
+    }
+}
+
+// Stands in for an image decoder, FNV-1a runs at a few hundred MB/s like stb_image on png
+static uint64_t decode(std::span<const uint8_t> data)
+{
+    uint64_t hash = 0xcbf29ce484222325;
+    for (uint8_t byte : data)
+    {
+        hash = (hash ^ byte) * 0x100000001b3;
+    }
+    return hash;
+}
+
+#if !defined(_WIN32)
+static void evict(size_t size)
+{
+    for (uint32_t i = 0; i < TEXTURE_COUNT; ++i)
+    {
+        int fd = open(texture_path(size, i).c_str(), O_RDONLY);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+#else
+static void evict(size_t)
+{}
+#endif
+
+// What the engine did: every worker reads then decodes its textures with blocking reads
+static void load_parallel_for(size_t size)
+{
+    std::atomic<uint64_t> sum = 0;
+    bul::jobs::parallel_for(TEXTURE_COUNT, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            std::vector<uint8_t> data;
+            bul::read_file(texture_path(size, i).c_str(), data);
+            sum += decode(data);
+        }
+    });
+    bench::do_not_optimize(sum.load());
+}
+
+static void load_async(size_t size)
+{
+    std::atomic<uint64_t> sum = 0;
+    bul::jobs::Counter counter;
+    for (uint32_t i = 0; i < TEXTURE_COUNT; ++i)
+    {
+        bul::io::read(
+            texture_path(size, i), [&sum](std::span<const uint8_t> data, bool) { sum += decode(data); }, &counter);
+    }
+    bul::jobs::wait(counter);
+    bench::do_not_optimize(sum.load());
+}
+
+enum class Loader
+{
+    ParallelFor,
+    ThreadPool,
+    IoUring,
+};
+
+static void bench_textures(bench::State& state, Loader loader, bool cold)
+{
+    size_t size = size_t(state.arg());
+    create_textures(size);
+    bul::jobs::init();
+    if (loader != Loader::ParallelFor)
+    {
+        bul::io::init(64, loader == Loader::IoUring ? bul::io::Backend::IoUring : bul::io::Backend::ThreadPool);
+    }
+    auto load = loader == Loader::ParallelFor ? load_parallel_for : load_async;
+
+    state.set_bytes(size * TEXTURE_COUNT);
+    state.set_items(TEXTURE_COUNT);
+    if (cold)
+    {
+        state.measure([&]() { evict(size); }, [&]() { load(size); });
+    }
+    else
+    {
+        state.measure([&]() { load(size); });
+    }
+
+    bul::io::shutdown();
+    bul::jobs::shutdown();
+}
+
+BENCHMARK(textures_parallel_for_warm, TEXTURE_SIZES)
+{
+    bench_textures(state, Loader::ParallelFor, false);
+}
+
+BENCHMARK(textures_io_thread_pool_warm, TEXTURE_SIZES)
+{
+    bench_textures(state, Loader::ThreadPool, false);
+}
+
+BENCHMARK(textures_io_uring_warm, TEXTURE_SIZES)
+{
+    bench_textures(state, Loader::IoUring, false);
+}
+
+// Cold runs evict the files from the page cache first, Windows has no unprivileged way to do it so they are warm there
+BENCHMARK(textures_parallel_for_cold, TEXTURE_SIZES)
+{
+    bench_textures(state, Loader::ParallelFor, true);
+}
+
+BENCHMARK(textures_io_thread_pool_cold, TEXTURE_SIZES)
+{
+    bench_textures(state, Loader::ThreadPool, true);
+}
+
+BENCHMARK(textures_io_uring_cold, TEXTURE_SIZES)
+{
+    bench_textures(state, Loader::IoUring, true);
+}
@@ -0,0 +1,70 @@
+#include "bench.h"
+
+#include <cmath>
+#include <vector>
+
+#include "bul/jobs.h"
+
+#define THREAD_COUNTS 1, 2, 4, 8, 16, 32, 64
+
+// Same work for every thread count, so the time shows the scaling directly
+BENCHMARK(jobs_parallel_for, THREAD_COUNTS)
+{
+    bul::jobs::init(uint32_t(state.arg()));
+    std::vector<float> values(1 << 22);
+    state.set_items(values.size());
+    state.measure([&]() {
+        bul::jobs::parallel_for(
+            uint32_t(values.size()),
+            [&](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    values[i] = std::sqrt(float(i)) * std::sin(float(i));
+                }
+            },
+            1024);
+        bench::do_not_optimize(values.data());
+    });
+    bul::jobs::shutdown();
+}
+
+// Uneven work per element, where static partitioning would leave threads idle
+BENCHMARK(jobs_parallel_for_unbalanced, THREAD_COUNTS)
+{
+    bul::jobs::init(uint32_t(state.arg()));
+    constexpr uint32_t COUNT = 4096;
+    std::vector<float> values(COUNT);
+    state.set_items(COUNT);
+    state.measure([&]() {
+        bul::jobs::parallel_for(COUNT, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                float sum = 0;
+                for (uint32_t j = 0; j < i; ++j)
+                {
+                    sum += std::sqrt(float(j));
+                }
+                values[i] = sum;
+            }
+        });
+        bench::do_not_optimize(values.data());
+    });
+    bul::jobs::shutdown();
+}
+
+// Overhead of scheduling, every job is empty
+BENCHMARK(jobs_run_empty, THREAD_COUNTS)
+{
+    bul::jobs::init(uint32_t(state.arg()));
+    constexpr uint32_t COUNT = 10'000;
+    state.set_items(COUNT);
+    state.measure([&]() {
+        bul::jobs::Counter counter;
+        for (uint32_t i = 0; i < COUNT; ++i)
+        {
+            bul::jobs::run([]() {}, &counter);
+        }
+        bul::jobs::wait(counter);
+    });
+    bul::jobs::shutdown();
+}
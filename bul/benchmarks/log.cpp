@@ -0,0 +1,67 @@
+#include "bench.h"
+
+#include <cstdarg>
+#include <cstdio>
+
+#include "bul/format.h"
+#include "bul/log.h"
+
+#if defined(_WIN32)
+static const char* NULL_FILE = "NUL";
+#else
+static const char* NULL_FILE = "/dev/null";
+#endif
+
+// The logger as it was before: formatted on the calling thread then written right away
+static void log_sync(FILE* file, const char* fmt, ...)
+{
+    std::va_list args;
+    va_start(args, fmt);
+    const char* text = bul::formatf(fmt, args);
+    va_end(args);
+    fprintf(file, "%s %s\n", "[INFO]", text);
+}
+
+// Bursts that fit in the ring of the thread, flushed in between outside of the timed region. Logging nonstop faster
+// than the background thread writes ends up waiting on it, it measures the writes rather than the calls.
+static constexpr int BURST = 256;
+
+// Time spent by the calling thread, the writes to the null device are what the background thread saves it
+BENCHMARK(log_sync_call)
+{
+    FILE* file = fopen(NULL_FILE, "w");
+    state.set_items(BURST);
+    state.measure([&]() { fflush(file); },
+                  [&]() {
+                      for (int i = 0; i < BURST; ++i)
+                      {
+                          log_sync(file, "frame %d took %.3fms in %s", i, 16.6f, "render");
+                      }
+                  });
+    fclose(file);
+}
+
+BENCHMARK(log_async_call)
+{
+    FILE* file = fopen(NULL_FILE, "w");
+    bul::set_log_file(file);
+    state.set_items(BURST);
+    state.measure([&]() { bul::log_flush(); },
+                  [&]() {
+                      for (int i = 0; i < BURST; ++i)
+                      {
+                          bul::log_info("frame %d took %.3fms in %s", i, 16.6f, "render");
+                      }
+                  });
+    bul::set_log_file(stdout);
+    fclose(file);
+}
+
+// Filtered at runtime, a relaxed load and a branch
+BENCHMARK(log_async_filtered)
+{
+    bul::set_log_level(bul::LogLevel::Warning);
+    state.set_items(1);
+    state.measure([&]() { bul::log_info("frame %d took %.3fms in %s", 42, 16.6f, "render"); });
+    bul::set_log_level(bul::LogLevel::Debug);
+}
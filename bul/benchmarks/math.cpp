@@ -0,0 +1,467 @@
+#include "bench.h"
+
+#include <cmath>
+#include <random>
+
+#include "bul/math/aabb.h"
+#include "bul/math/fast.h"
+#include "bul/math/matrix.h"
+#include "bul/math/vector.h"
+#include "bul/math/wide.h"
+
+static constexpr size_t COUNT = 1024;
+
+static std::vector<bul::mat4f> random_matrices(size_t count)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<bul::mat4f> matrices(count);
+    for (auto& m : matrices)
+    {
+        for (float& f : m.data)
+        {
+            f = dist(rng);
+        }
+        // Keep the matrices well conditioned for the inverse
+        for (size_t i = 0; i < 4; ++i)
+        {
+            m[i][i] += 4.0f;
+        }
+    }
+    return matrices;
+}
+
+template <typename V>
+static std::vector<V> random_vectors(size_t count)
+{
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<V> vectors(count);
+    for (auto& v : vectors)
+    {
+        for (size_t i = 0; i < V::SIZE; ++i)
+        {
+            v[i] = dist(rng);
+        }
+    }
+    return vectors;
+}
+
+BENCHMARK(mat4f_multiply)
+{
+    auto a = random_matrices(COUNT);
+    auto b = random_matrices(COUNT);
+    std::vector<bul::mat4f> res(COUNT);
+    state.set_items(COUNT);
+    state.measure([&]() {
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            res[i] = a[i] * b[i];
+        }
+        bench::do_not_optimize(res.data());
+    });
+}
+
+BENCHMARK(mat4f_multiply_scalar)
+{
+    auto a = random_matrices(COUNT);
+    auto b = random_matrices(COUNT);
+    std::vector<bul::mat4f> res(COUNT);
+    state.set_items(COUNT);
+    state.measure([&]() {
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            res[i] = bul::scalar::mul(a[i], b[i]);
+        }
+        bench::do_not_optimize(res.data());
+    });
+}
+
+BENCHMARK(mat4f_inverse)
+{
+    auto m = random_matrices(COUNT);
+    std::vector<bul::mat4f> res(COUNT);
+    state.set_items(COUNT);
+    state.measure([&]() {
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            res[i] = bul::inverse(m[i]);
+        }
+        bench::do_not_optimize(res.data());
+    });
+}
+
+BENCHMARK(mat4f_inverse_scalar)
+{
+    auto m = random_matrices(COUNT);
+    std::vector<bul::mat4f> res(COUNT);
+    state.set_items(COUNT);
+    state.measure([&]() {
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            res[i] = bul::scalar::inverse(m[i]);
+        }
+        bench::do_not_optimize(res.data());
+    });
+}
+
+BENCHMARK(mat4f_transpose)
+{
+    auto m = random_matrices(COUNT);
+    std::vector<bul::mat4f> res(COUNT);
+    state.set_items(COUNT);
+    state.measure([&]() {
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            res[i] = bul::transpose(m[i]);
+        }
+        bench::do_not_optimize(res.data());
+    });
+}
+
+BENCHMARK(mat4f_transpose_scalar)
+{
+    auto m = random_matrices(COUNT);
+    std::vector<bul::mat4f> res(COUNT);
+    state.set_items(COUNT);
+    state.measure([&]() {
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            res[i] = bul::scalar::transpose(m[i]);
+        }
+        bench::do_not_optimize(res.data());
+    });
+}
+
+BENCHMARK(mat4f_transform_vec4f)
+{
+    bul::mat4f m = random_matrices(1)[0];
+    auto v = random_vectors<bul::vec4f>(COUNT);
+    std::vector<bul::vec4f> res(COUNT);
+    state.set_items(COUNT);
+    state.measure([&]() {
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            res[i] = m * v[i];
+        }
+        bench::do_not_optimize(res.data());
+    });
+}
+
+BENCHMARK(mat4f_transform_vec4f_scalar)
+{
+    bul::mat4f m = random_matrices(1)[0];
+    auto v = random_vectors<bul::vec4f>(COUNT);
+    std::vector<bul::vec4f> res(COUNT);
+    state.set_items(COUNT);
+    state.measure([&]() {
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            res[i] = bul::scalar::mul(m, v[i]);
+        }
+        bench::do_not_optimize(res.data());
+    });
+}
+
+BENCHMARK(mat4f_transform_array)
+{
+    bul::mat4f m = random_matrices(1)[0];
+    auto v = random_vectors<bul::vec4f>(COUNT);
+    std::vector<bul::vec4f> res(COUNT);
+    state.set_items(COUNT);
+    state.measure([&]() {
+        bul::transform(m, v.data(), res.data(), COUNT);
+        bench::do_not_optimize(res.data());
+    });
+}
+
+BENCHMARK(mat4f_transform_array_scalar)
+{
+    bul::mat4f m = random_matrices(1)[0];
+    auto v = random_vectors<bul::vec4f>(COUNT);
+    std::vector<bul::vec4f> res(COUNT);
+    state.set_items(COUNT);
+    state.measure([&]() {
+        bul::scalar::transform(m, v.data(), res.data(), COUNT);
+        bench::do_not_optimize(res.data());
+    });
+}
+
+BENCHMARK(mat4f_transform_points)
+{
+    bul::mat4f m = random_matrices(1)[0];
+    auto v = random_vectors<bul::vec3f>(COUNT);
+    std::vector<bul::vec3f> res(COUNT);
+    state.set_items(COUNT);
+    state.measure([&]() {
+        bul::transform_points(m, v.data(), res.data(), COUNT);
+        bench::do_not_optimize(res.data());
+    });
+}
+
+BENCHMARK(mat4f_transform_points_scalar)
+{
+    bul::mat4f m = random_matrices(1)[0];
+    auto v = random_vectors<bul::vec3f>(COUNT);
+    std::vector<bul::vec3f> res(COUNT);
+    state.set_items(COUNT);
+    state.measure([&]() {
+        bul::scalar::transform_points(m, v.data(), res.data(), COUNT);
+        bench::do_not_optimize(res.data());
+    });
+}
+
+BENCHMARK(aabb_transform)
+{
+    bul::mat4f m = random_matrices(1)[0];
+    auto min = random_vectors<bul::vec3f>(COUNT);
+    std::vector<bul::aabb> boxes(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        boxes[i] = {min[i], min[i] + bul::vec3f{1.0f}};
+    }
+    std::vector<bul::aabb> res(COUNT);
+    state.set_items(COUNT);
+    state.measure([&]() {
+        bul::transform(m, boxes.data(), res.data(), COUNT);
+        bench::do_not_optimize(res.data());
+    });
+}
+
+BENCHMARK(aabb_transform_scalar)
+{
+    bul::mat4f m = random_matrices(1)[0];
+    auto min = random_vectors<bul::vec3f>(COUNT);
+    std::vector<bul::aabb> boxes(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        boxes[i] = {min[i], min[i] + bul::vec3f{1.0f}};
+    }
+    std::vector<bul::aabb> res(COUNT);
+    state.set_items(COUNT);
+    state.measure([&]() {
+        bul::scalar::transform(m, boxes.data(), res.data(), COUNT);
+        bench::do_not_optimize(res.data());
+    });
+}
+
+BENCHMARK(vec3f_normalize)
+{
+    auto v = random_vectors<bul::vec3f>(COUNT);
+    std::vector<bul::vec3f> res(COUNT);
+    state.set_items(COUNT);
+    state.measure([&]() {
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            res[i] = bul::normalize(v[i]);
+        }
+        bench::do_not_optimize(res.data());
+    });
+}
+
+BENCHMARK(vec3f_cross_dot)
+{
+    auto a = random_vectors<bul::vec3f>(COUNT);
+    auto b = random_vectors<bul::vec3f>(COUNT);
+    state.set_items(COUNT);
+    state.measure([&]() {
+        float sum = 0;
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            sum += bul::dot(bul::cross(a[i], b[i]), a[i]);
+        }
+        bench::do_not_optimize(sum);
+    });
+}
+
+template <typename V>
+static std::vector<V> to_wide(const std::vector<bul::vec3f>& vectors)
+{
+    std::vector<V> res(vectors.size() / V::WIDTH);
+    for (size_t i = 0; i < res.size(); ++i)
+    {
+        res[i] = V::load(vectors.data() + i * V::WIDTH);
+    }
+    return res;
+}
+
+template <typename V>
+static void wide_cross_dot(bench::State& state)
+{
+    auto a = to_wide<V>(random_vectors<bul::vec3f>(COUNT));
+    auto b = to_wide<V>(random_vectors<bul::vec3f>(COUNT));
+    state.set_items(COUNT);
+    state.measure([&]() {
+        decltype(V::x) sum;
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            sum = sum + bul::dot(bul::cross(a[i], b[i]), a[i]);
+        }
+        bench::do_not_optimize(sum);
+    });
+}
+
+BENCHMARK(vec3x4_cross_dot)
+{
+    wide_cross_dot<bul::vec3x4>(state);
+}
+
+BENCHMARK(vec3x8_cross_dot)
+{
+    wide_cross_dot<bul::vec3x8>(state);
+}
+
+// Slab test of one box against COUNT rays, the kind of loop a ray packet or a culling pass runs
+BENCHMARK(ray_aabb_vec3f)
+{
+    auto origins = random_vectors<bul::vec3f>(COUNT);
+    auto inv_dirs = random_vectors<bul::vec3f>(COUNT);
+    bul::vec3f box_min{-0.5f};
+    bul::vec3f box_max{0.5f};
+    state.set_items(COUNT);
+    state.measure([&]() {
+        uint32_t hits = 0;
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            bul::vec3f t0 = (box_min - origins[i]) * inv_dirs[i];
+            bul::vec3f t1 = (box_max - origins[i]) * inv_dirs[i];
+            float t_near = 0.0f;
+            float t_far = 1e30f;
+            for (size_t c = 0; c < 3; ++c)
+            {
+                t_near = std::max(t_near, std::min(t0[c], t1[c]));
+                t_far = std::min(t_far, std::max(t0[c], t1[c]));
+            }
+            hits += t_near <= t_far;
+        }
+        bench::do_not_optimize(hits);
+    });
+}
+
+template <typename V>
+static void wide_ray_aabb(bench::State& state)
+{
+    using F = decltype(V::x);
+    auto origins = to_wide<V>(random_vectors<bul::vec3f>(COUNT));
+    auto inv_dirs = to_wide<V>(random_vectors<bul::vec3f>(COUNT));
+    V box_min{bul::vec3f{-0.5f}};
+    V box_max{bul::vec3f{0.5f}};
+    state.set_items(COUNT);
+    state.measure([&]() {
+        uint32_t hits = 0;
+        for (size_t i = 0; i < origins.size(); ++i)
+        {
+            V t0 = (box_min - origins[i]) * inv_dirs[i];
+            V t1 = (box_max - origins[i]) * inv_dirs[i];
+            V t_min = bul::min(t0, t1);
+            V t_max = bul::max(t0, t1);
+            F t_near = bul::max(bul::max(t_min.x, t_min.y), bul::max(t_min.z, F{0.0f}));
+            F t_far = bul::min(bul::min(t_max.x, t_max.y), bul::min(t_max.z, F{1e30f}));
+            hits += std::popcount(bul::mask_bits(t_near <= t_far));
+        }
+        bench::do_not_optimize(hits);
+    });
+}
+
+BENCHMARK(ray_aabb_vec3x4)
+{
+    wide_ray_aabb<bul::vec3x4>(state);
+}
+
+BENCHMARK(ray_aabb_vec3x8)
+{
+    wide_ray_aabb<bul::vec3x8>(state);
+}
+
+static std::vector<float> random_floats(size_t count, float min, float max)
+{
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> dist(min, max);
+    std::vector<float> res(count);
+    for (float& f : res)
+    {
+        f = dist(rng);
+    }
+    return res;
+}
+
+template <typename F>
+static void unary(bench::State& state, float min, float max, F fn)
+{
+    auto x = random_floats(COUNT, min, max);
+    std::vector<float> res(COUNT);
+    state.set_items(COUNT);
+    state.measure([&]() {
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            res[i] = fn(x[i]);
+        }
+        bench::do_not_optimize(res.data());
+    });
+}
+
+BENCHMARK(exp2_std)
+{
+    unary(state, -20.0f, 20.0f, [](float x) { return std::exp2(x); });
+}
+
+BENCHMARK(exp2_fast)
+{
+    unary(state, -20.0f, 20.0f, [](float x) { return bul::fast::exp2(x); });
+}
+
+BENCHMARK(log2_std)
+{
+    unary(state, 1e-3f, 1e3f, [](float x) { return std::log2(x); });
+}
+
+BENCHMARK(log2_fast)
+{
+    unary(state, 1e-3f, 1e3f, [](float x) { return bul::fast::log2(x); });
+}
+
+BENCHMARK(pow_std)
+{
+    unary(state, 1e-3f, 1.0f, [](float x) { return std::pow(x, 2.2f); });
+}
+
+BENCHMARK(pow_fast)
+{
+    unary(state, 1e-3f, 1.0f, [](float x) { return bul::fast::pow(x, 2.2f); });
+}
+
+BENCHMARK(rsqrt_std)
+{
+    unary(state, 1e-3f, 1e3f, [](float x) { return 1.0f / std::sqrt(x); });
+}
+
+BENCHMARK(rsqrt_fast)
+{
+    unary(state, 1e-3f, 1e3f, [](float x) { return bul::fast::rsqrt(x); });
+}
+
+BENCHMARK(sincos_std)
+{
+    unary(state, -10.0f, 10.0f, [](float x) { return std::sin(x) + std::cos(x); });
+}
+
+BENCHMARK(sincos_fast)
+{
+    unary(state, -10.0f, 10.0f, [](float x) {
+        float s;
+        float c;
+        bul::fast::sincos(x, s, c);
+        return s + c;
+    });
+}
+
+BENCHMARK(linear_to_srgb_std)
+{
+    unary(state, 0.0f, 1.0f,
+          [](float x) { return x <= 0.0031308f ? x * 12.92f : 1.055f * std::pow(x, 1.0f / 2.4f) - 0.055f; });
+}
+
+BENCHMARK(linear_to_srgb_fast)
+{
+    unary(state, 0.0f, 1.0f, [](float x) { return bul::fast::linear_to_srgb(x); });
+}
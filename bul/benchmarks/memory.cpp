@@ -0,0 +1,65 @@
+#include "bench.h"
+
+#include <cstdlib>
+
+#include "bul/memory.h"
+
+// Allocations per run, freed in the same run
+static constexpr int ALLOCATIONS = 1024;
+#define ALLOCATION_SIZES 16, 256, 4096
+
+BENCHMARK(malloc_free, ALLOCATION_SIZES)
+{
+    size_t size = size_t(state.arg());
+    void* ptrs[ALLOCATIONS];
+    state.set_items(ALLOCATIONS);
+    state.measure([&]() {
+        for (void*& ptr : ptrs)
+        {
+            ptr = malloc(size);
+            bench::do_not_optimize(ptr);
+        }
+        for (void* ptr : ptrs)
+        {
+            free(ptr);
+        }
+    });
+}
+
+// The header and the atomic counters of the tag on top of malloc
+BENCHMARK(tracked_allocate_deallocate, ALLOCATION_SIZES)
+{
+    size_t size = size_t(state.arg());
+    void* ptrs[ALLOCATIONS];
+    state.set_items(ALLOCATIONS);
+    state.measure([&]() {
+        for (void*& ptr : ptrs)
+        {
+            ptr = bul::memory::allocate(size, 8, bul::memory::Tag::Loaders);
+            bench::do_not_optimize(ptr);
+        }
+        for (void* ptr : ptrs)
+        {
+            bul::memory::deallocate(ptr);
+        }
+    });
+}
+
+// Tracked when built with BUL_TRACK_ALLOCATIONS
+BENCHMARK(new_delete, ALLOCATION_SIZES)
+{
+    size_t size = size_t(state.arg());
+    char* ptrs[ALLOCATIONS];
+    state.set_items(ALLOCATIONS);
+    state.measure([&]() {
+        for (char*& ptr : ptrs)
+        {
+            ptr = new char[size];
+            bench::do_not_optimize(ptr);
+        }
+        for (char* ptr : ptrs)
+        {
+            delete[] ptr;
+        }
+    });
+}
@@ -0,0 +1,44 @@
+#include "bench.h"
+
+#include "bul/profiler.h"
+#include "bul/time.h"
+
+// Scopes per run, collected in between outside of the timed region so the ring of the thread never fills
+static constexpr int SCOPES = 1024;
+
+BENCHMARK(profile_scope)
+{
+    state.set_items(SCOPES);
+    state.measure([]() { bul::profiler::frame(); },
+                  []() {
+                      for (int i = 0; i < SCOPES; ++i)
+                      {
+                          bul::profiler::Scope scope{"bench scope"};
+                      }
+                  });
+}
+
+// Most of a scope is reading the clock twice
+BENCHMARK(profile_ticks)
+{
+    state.set_items(SCOPES);
+    state.measure([]() {
+        for (int i = 0; i < SCOPES; ++i)
+        {
+            bench::do_not_optimize(bul::time::ticks());
+        }
+    });
+}
+
+BENCHMARK(profile_frame_collect)
+{
+    state.set_items(SCOPES);
+    state.measure(
+        []() {
+            for (int i = 0; i < SCOPES; ++i)
+            {
+                bul::profiler::Scope scope{"bench scope"};
+            }
+        },
+        []() { bul::profiler::frame(); });
+}
@@ -0,0 +1,105 @@
+#include "bench.h"
+
+#include <atomic>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+#include "bul/containers/mpmc_queue.h"
+#include "bul/containers/spsc_queue.h"
+
+#define THREAD_COUNTS 1, 2, 4, 8
+
+static constexpr uint64_t ITEMS = 100'000;
+
+// Baseline the lock-free queues are measured against
+template <typename T, size_t CAPACITY>
+class MutexQueue
+{
+public:
+    bool push_back(T val)
+    {
+        std::lock_guard lock{mutex_};
+        if (queue_.size() == CAPACITY)
+        {
+            return false;
+        }
+        queue_.push(val);
+        return true;
+    }
+
+    bool pop_front(T& val)
+    {
+        std::lock_guard lock{mutex_};
+        if (queue_.empty())
+        {
+            return false;
+        }
+        val = queue_.front();
+        queue_.pop();
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    std::queue<T> queue_;
+};
+
+// ITEMS values go through the queue, split between state.arg() producers and as many consumers
+template <typename Q>
+static void queue_throughput(bench::State& state, uint32_t producers, uint32_t consumers)
+{
+    state.set_items(ITEMS);
+    state.measure([&]() {
+        Q queue;
+        std::atomic<uint64_t> popped = 0;
+        std::vector<std::thread> threads;
+        for (uint32_t p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&, p]() {
+                for (uint64_t i = p; i < ITEMS; i += producers)
+                {
+                    while (!queue.push_back(i))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (uint32_t c = 0; c < consumers; ++c)
+        {
+            threads.emplace_back([&]() {
+                uint64_t sum = 0;
+                while (popped.load(std::memory_order_relaxed) < ITEMS)
+                {
+                    uint64_t val;
+                    if (queue.pop_front(val))
+                    {
+                        sum += val;
+                        popped.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                bench::do_not_optimize(sum);
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    });
+}
+
+BENCHMARK(spsc_queue_throughput)
+{
+    queue_throughput<bul::SpscQueue<uint64_t, 1024>>(state, 1, 1);
+}
+
+BENCHMARK(mpmc_queue_throughput, THREAD_COUNTS)
+{
+    queue_throughput<bul::MpmcQueue<uint64_t, 1024>>(state, uint32_t(state.arg()), uint32_t(state.arg()));
+}
+
+BENCHMARK(mutex_queue_throughput, THREAD_COUNTS)
+{
+    queue_throughput<MutexQueue<uint64_t, 1024>>(state, uint32_t(state.arg()), uint32_t(state.arg()));
+}
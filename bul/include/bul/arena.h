@@ -0,0 +1,190 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "bul/bul.h"
+
+namespace bul
+{
+/*
+ * Linear allocator: allocations bump a pointer through a chain of blocks and are all released at once by reset or
+ * rewind, nothing is freed individually and no destructor runs. Blocks are kept across resets, so an arena used the
+ * same way every frame stops touching the heap after the first one.
+ */
+class Arena
+{
+public:
+    struct Stats
+    {
+        // Since the last reset
+        size_t allocations = 0;
+        size_t bytes = 0;
+        // Since construction
+        size_t peak_bytes = 0;
+        size_t heap_allocations = 0;
+        size_t capacity = 0;
+    };
+
+    struct Marker
+    {
+        void* block;
+        uint8_t* top;
+        size_t bytes;
+    };
+
+    explicit Arena(size_t block_size = 64_KB);
+    // Allocations are served from buffer first, it is not owned by the arena
+    Arena(void* buffer, size_t size, size_t block_size = 64_KB);
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena(Arena&& other);
+    Arena& operator=(Arena&& other);
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+    {
+        uint8_t* ptr = top_ != nullptr ? align(top_, alignment) : nullptr;
+        if (ptr == nullptr || ptr + size > end_)
+        {
+            ptr = allocate_slow(size, alignment);
+        }
+        top_ = ptr + size;
+        stats_.allocations += 1;
+        stats_.bytes += size;
+        stats_.peak_bytes = stats_.bytes > stats_.peak_bytes ? stats_.bytes : stats_.peak_bytes;
+        return ptr;
+    }
+
+    template <typename T>
+    T* allocate(size_t count)
+    {
+        return (T*)allocate(count * sizeof(T), alignof(T));
+    }
+
+    template <typename T, typename... Args>
+    requires std::is_trivially_destructible_v<T>
+    T* create(Args&&... args)
+    {
+        return new (allocate(sizeof(T), alignof(T))) T{std::forward<Args>(args)...};
+    }
+
+    Marker mark() const
+    {
+        return Marker{current_, top_, stats_.bytes};
+    }
+
+    // Releases everything allocated after the marker was taken
+    void rewind(const Marker& marker);
+    void reset();
+
+    const Stats& stats() const
+    {
+        return stats_;
+    }
+
+private:
+    struct Block;
+
+    static uint8_t* align(uint8_t* ptr, size_t alignment)
+    {
+        return (uint8_t*)(((uintptr_t)ptr + alignment - 1) & ~(uintptr_t)(alignment - 1));
+    }
+
+    uint8_t* allocate_slow(size_t size, size_t alignment);
+    void use_block(Block* block);
+    void release();
+
+    size_t block_size_;
+    Block* first_ = nullptr;
+    Block* current_ = nullptr;
+    uint8_t* top_ = nullptr;
+    uint8_t* end_ = nullptr;
+    Stats stats_;
+};
+
+// Lets standard containers allocate from an arena, deallocation is a no-op so reserve when the size is known
+template <typename T>
+struct ArenaAllocator
+{
+    using value_type = T;
+
+    ArenaAllocator(Arena& arena)
+        : arena{&arena}
+    {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other)
+        : arena{other.arena}
+    {}
+
+    T* allocate(size_t count)
+    {
+        return arena->allocate<T>(count);
+    }
+
+    void deallocate(T*, size_t)
+    {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const
+    {
+        return arena == other.arena;
+    }
+
+    Arena* arena;
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+/*
+ * Scratch memory for data that lives until the end of the frame. The arenas are double-buffered like the frame
+ * contexts: begin_frame only resets the arena of the frame that is about to be recorded, so what the previous frame
+ * allocated is still valid while the GPU consumes it.
+ */
+class FrameArena
+{
+public:
+    static constexpr uint32_t FRAMES = 2;
+
+    explicit FrameArena(size_t block_size = 256_KB);
+
+    void begin_frame();
+
+    Arena& arena()
+    {
+        return arenas_[current_];
+    }
+
+    template <typename T>
+    ArenaAllocator<T> allocator()
+    {
+        return ArenaAllocator<T>{arenas_[current_]};
+    }
+
+    template <typename T>
+    ArenaVector<T> vector()
+    {
+        return ArenaVector<T>{allocator<T>()};
+    }
+
+    // Allocations made during the last completed frame and heap blocks allocated by both arenas, once the frames have
+    // reached their steady state heap_allocations stops changing
+    size_t last_frame_allocations() const
+    {
+        return last_frame_allocations_;
+    }
+
+    size_t heap_allocations() const;
+
+private:
+    Arena arenas_[FRAMES];
+    uint32_t current_ = 0;
+    size_t last_frame_allocations_ = 0;
+};
+} // namespace bul
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace bul
+{
+size_t base64_decoded_size(std::string_view str);
+
+// dst must be able to hold base64_decoded_size(str) bytes
+bool base64_decode(std::string_view str, uint8_t* dst);
+bool base64_decode(std::string_view str, std::vector<uint8_t>& data);
+
+// Reference implementation without SIMD, used for the tail of the input and for error reporting
+bool base64_decode_scalar(std::string_view str, uint8_t* dst);
+} // namespace bul
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 #define _BUL_CONCAT(a, b) a##b
@@ -15,28 +16,31 @@
 #define ENSURE(EXPR) [[maybe_unused]] bool BUL_CONCAT(_, __COUNTER__) = (EXPR)
 #endif
 
-inline uint64_t operator"" _KB(uint64_t bytes)
+constexpr uint64_t operator"" _KB(unsigned long long bytes)
 {
     return bytes << 10;
 }
 
-inline uint64_t operator"" _MB(uint64_t bytes)
+constexpr uint64_t operator"" _MB(unsigned long long bytes)
 {
     return bytes << 20;
 }
 
-inline uint64_t operator"" _GB(uint64_t bytes)
+constexpr uint64_t operator"" _GB(unsigned long long bytes)
 {
     return bytes << 30;
 }
 
-inline uint64_t operator"" _TB(uint64_t bytes)
+constexpr uint64_t operator"" _TB(unsigned long long bytes)
 {
     return bytes << 40;
 }
 
 namespace bul
 {
+// Padding between data written by different threads
+inline constexpr size_t CACHE_LINE_SIZE = 64;
+
 void _assert(bool cond, const char* cond_str, const char* msg, const char* file, unsigned line);
 
 template <typename Dst = void*>
@@ -1,8 +1,9 @@
 #pragma once
 
 #include "bul/bul.h"
+#include "bul/memory.h"
 
-#include <cstdlib>
+#include <utility>
 
 namespace bul
 {
@@ -14,7 +15,7 @@ public:
 
     Buffer(size_t size)
     {
-        data_ = (T*)malloc(1, size * sizeof(T));
+        data_ = (T*)memory::allocate(size * sizeof(T), alignof(T), memory::tag_or(memory::Tag::Containers));
         ASSERT(data_ != nullptr);
         size_ = size;
     }
@@ -29,7 +30,7 @@ public:
 
     Buffer<T>& operator=(Buffer<T>&& other)
     {
-        free(data_);
+        memory::deallocate(data_);
         data_ = other.data_;
         size_ = other.size_;
         other.data_ = nullptr;
@@ -39,14 +40,16 @@ public:
 
     ~Buffer()
     {
-        free(data_);
+        memory::deallocate(data_);
         data_ = nullptr;
         size_ = 0;
     }
 
     void resize(size_t size)
     {
-        data_ = (T*)realloc(data_, size * sizeof(T));
+        data_ = (T*)(data_ != nullptr ? memory::reallocate(data_, size * sizeof(T))
+                                      : memory::allocate(size * sizeof(T), alignof(T),
+                                                         memory::tag_or(memory::Tag::Containers)));
         ASSERT(data_ != nullptr);
         size_ = size;
     }
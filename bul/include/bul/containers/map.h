@@ -5,6 +5,7 @@
 
 #include <utility>
 #include <concepts>
+#include <cstring>
 #include <vector>
 #include <bit>
 
@@ -78,10 +79,10 @@ public:
                 return nullptr;
             }
 
+            // The displaced slot carries on one further from its home, like the one that took its place
             if (slot.psl > cur_slot.psl)
             {
                 std::swap(cur_slot, slot);
-                continue;
             }
 
             slot.psl += 1;
@@ -158,7 +159,7 @@ public:
 
     const Entry* operator[](const KEY_T& key) const
     {
-        return const_cast<Map<KEY_T, VAL_T>*>(this)->find_(key);
+        return (*const_cast<Map<KEY_T, VAL_T>*>(this))[key];
     }
 
     size_t size() const
@@ -261,7 +262,6 @@ private:
                 if (slot.psl > cur_slot.psl)
                 {
                     std::swap(cur_slot, slot);
-                    continue;
                 }
 
                 slot.psl += 1;
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "bul/bul.h"
+
+namespace bul
+{
+/*
+ * Bounded queue for any number of producer and consumer threads (Dmitry Vyukov's design). Every cell has a sequence
+ * number telling whether it is ready to be written or read for a given position: threads claim a position with a CAS
+ * on the enqueue or dequeue index, then publish the cell by bumping its sequence, without ever waiting on each other.
+ */
+template <typename T, size_t CAPACITY>
+class MpmcQueue
+{
+    static_assert(std::has_single_bit(CAPACITY) && CAPACITY >= 2, "Capacity must be a power of 2");
+
+public:
+    MpmcQueue()
+    {
+        for (size_t i = 0; i < CAPACITY; ++i)
+        {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MpmcQueue()
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            size_t enqueue_pos = enqueue_pos_.load(std::memory_order_relaxed);
+            for (size_t pos = dequeue_pos_.load(std::memory_order_relaxed); pos != enqueue_pos; ++pos)
+            {
+                std::launder(reinterpret_cast<T*>(cells_[pos & (CAPACITY - 1)].storage))->~T();
+            }
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    bool push_back(const T& val)
+    {
+        return emplace_back(val);
+    }
+
+    bool push_back(T&& val)
+    {
+        return emplace_back(std::move(val));
+    }
+
+    template <typename... Args>
+    bool emplace_back(Args&&... args)
+    {
+        Cell* cell = nullptr;
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &cells_[pos & (CAPACITY - 1)];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = intptr_t(sequence) - intptr_t(pos);
+            if (diff == 0)
+            {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // The cell still holds the value pushed one lap ago
+                return false;
+            }
+            else
+            {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        new (cell->storage) T(std::forward<Args>(args)...);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop_front(T& val)
+    {
+        Cell* cell = nullptr;
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &cells_[pos & (CAPACITY - 1)];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = intptr_t(sequence) - intptr_t(pos + 1);
+            if (diff == 0)
+            {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // Nothing was pushed at this position yet
+                return false;
+            }
+            else
+            {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        T* value = std::launder(reinterpret_cast<T*>(cell->storage));
+        val = std::move(*value);
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            value->~T();
+        }
+        cell->sequence.store(pos + CAPACITY, std::memory_order_release);
+        return true;
+    }
+
+    // Only a snapshot when other threads are running
+    size_t size() const
+    {
+        size_t enqueue_pos = enqueue_pos_.load(std::memory_order_relaxed);
+        size_t dequeue_pos = dequeue_pos_.load(std::memory_order_relaxed);
+        return enqueue_pos > dequeue_pos ? enqueue_pos - dequeue_pos : 0;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    constexpr size_t capacity() const
+    {
+        return CAPACITY;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueue_pos_ = 0;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeue_pos_ = 0;
+    alignas(CACHE_LINE_SIZE) Cell cells_[CAPACITY];
+};
+} // namespace bul
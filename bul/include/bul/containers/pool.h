@@ -235,48 +235,63 @@ private:
 };
 } // namespace bul
  */
-
 #pragma once
 
+#include <atomic>
+#include <bit>
 #include <iterator>
+#include <new>
+#include <utility>
 
 #include "bul/bul.h"
-#include "bul/containers/buffer.h"
 #include "bul/containers/handle.h"
 
 namespace bul
 {
+/*
+ * Slots live in chunks that are never moved or freed before the pool is destroyed, so references returned by get
+ * stay valid across inserts. Chunk k holds first_chunk_size << k slots: a fixed table of chunk pointers covers the
+ * whole 32 bit index space and finding a slot is a shift and a bit scan.
+ *
+ * insert, erase, is_valid and get can be called from multiple threads at once. Free slots form a lock-free LIFO list
+ * whose head is tagged with a counter against ABA, fresh slots are claimed with an atomic bump index. clear, moves and
+ * iteration must not run concurrently with anything else.
+ */
 template <typename T>
 class Pool
 {
 private:
-    struct Data
+    static inline constexpr uint32_t NONE = UINT32_MAX;
+    static inline constexpr uint32_t MAX_CHUNKS = 33;
+
+    struct Slot
     {
-        uint32_t full : 1;
-        uint32_t version : 31;
-        union
+        // version << 1 | full
+        std::atomic<uint32_t> state{0};
+        std::atomic<uint32_t> next{NONE};
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* value()
         {
-            T value;
-            uint32_t next;
-        };
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+
+        bool full() const
+        {
+            return state.load(std::memory_order_acquire) & 1;
+        }
     };
 
 public:
     Pool()
-        : Pool(1)
+        : Pool(64)
     {}
 
+    // Capacity is rounded up to a power of 2 and allocated upfront as the first chunk
     explicit Pool(size_t capacity)
+        : first_chunk_shift_{uint32_t(std::bit_width(std::bit_ceil(capacity > 0 ? capacity : 1)) - 1)}
     {
-        data_.resize(capacity);
-        free_ = 0;
-        for (uint32_t i = 0; i < data_.size(); ++i)
-        {
-            data_[i].full = 0;
-            data_[i].version = 0;
-            data_[i].next = i + 1;
-        }
-        data_[data_.size() - 1].next = UINT32_MAX;
+        ensure_chunk(0);
     }
 
     Pool(const Pool<T>&) = delete;
@@ -289,75 +304,99 @@ public:
 
     ~Pool()
     {
-        clear();
+        destroy();
     }
 
     Pool<T>& operator=(Pool<T>&& other)
     {
-        data_ = std::move(other.data_);
-        free_ = other.free_;
+        if (this != &other)
+        {
+            destroy();
+            first_chunk_shift_ = other.first_chunk_shift_;
+            for (uint32_t i = 0; i < MAX_CHUNKS; ++i)
+            {
+                chunks_[i].store(other.chunks_[i].exchange(nullptr, std::memory_order_relaxed),
+                                 std::memory_order_relaxed);
+            }
+            size_.store(other.size_.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+            free_.store(other.free_.exchange(NONE, std::memory_order_relaxed), std::memory_order_relaxed);
+        }
         return *this;
     }
 
     Handle<T> insert(T&& val)
     {
-        Data* free_data = nullptr;
-        uint32_t free_index = get_next_free_slot(free_data);
-        memset(&free_data->value, 0, sizeof(T));
-        free_data->value = std::move(val);
-        return Handle<T>{free_index, free_data->version};
+        uint32_t index = pop_free_slot();
+        if (index == NONE)
+        {
+            index = size_.fetch_add(1, std::memory_order_relaxed);
+            ASSERT(index != NONE);
+            ensure_chunk(chunk_index(index));
+        }
+
+        Slot& s = slot(index);
+        new (s.storage) T(std::move(val));
+        uint32_t version = s.state.load(std::memory_order_relaxed) >> 1;
+        s.state.store(version << 1 | 1, std::memory_order_release);
+        return Handle<T>{index, version};
     }
 
     void erase(Handle<T> handle)
     {
         ASSERT(is_valid(handle));
-        uint32_t free_index = free_;
-        free_ = handle.value;
-        Data& data = data_[free_];
+        Slot& s = slot(handle.value);
         if constexpr (!std::is_trivially_destructible_v<T>)
         {
-            data.value.~T();
+            s.value()->~T();
         }
-        data.next = free_index;
-        ++data.version;
-        data.full = 0;
+        // Versions are 31 bits like before, wrapping around after 2^31 reuses of a slot
+        s.state.store(((handle.version + 1) & 0x7fffffff) << 1, std::memory_order_relaxed);
+        push_free_slot(handle.value);
     }
 
     bool is_valid(Handle<T> handle) const
     {
-        return handle.value < data_.size() && handle.version == data_[handle.value].version
-            && data_[handle.value].full == 1;
+        // Another thread may have claimed the index without having allocated its chunk yet
+        if (handle.value >= size_.load(std::memory_order_acquire)
+            || chunks_[chunk_index(handle.value)].load(std::memory_order_acquire) == nullptr)
+        {
+            return false;
+        }
+        uint32_t state = slot(handle.value).state.load(std::memory_order_acquire);
+        return (state & 1) && (state >> 1) == handle.version;
     }
 
     const T& get(Handle<T> handle) const
     {
         ASSERT(is_valid(handle));
-        return data_[handle.value].value;
+        return *slot(handle.value).value();
     }
 
     T& get(Handle<T> handle)
     {
         ASSERT(is_valid(handle));
-        return data_[handle.value].value;
+        return *slot(handle.value).value();
     }
 
+    // Keeps the chunks around, the next inserts reuse them from index 0
     void clear()
     {
-        free_ = 0;
-        for (size_t i = 0; i < data_.size(); ++i)
+        uint32_t size = size_.load(std::memory_order_relaxed);
+        for (uint32_t i = 0; i < size; ++i)
         {
+            Slot& s = slot(i);
             if constexpr (!std::is_trivially_destructible_v<T>)
             {
-                if (data_[i].full)
+                if (s.full())
                 {
-                    data_[i].value.~T();
+                    s.value()->~T();
                 }
             }
-            data_[i].full = 0;
-            data_[i].version = 0;
-            data_[i].next = i + 1;
+            s.state.store(0, std::memory_order_relaxed);
+            s.next.store(NONE, std::memory_order_relaxed);
         }
-        data_[data_.size() - 1].next = UINT32_MAX;
+        size_.store(0, std::memory_order_relaxed);
+        free_.store(NONE, std::memory_order_relaxed);
     }
 
     struct Iterator
@@ -368,28 +407,24 @@ public:
         using pointer = T*;
         using reference = T&;
 
-        Iterator(size_t index, Buffer<Data>& data)
+        Iterator(uint32_t index, Pool<T>& pool)
             : index_(index)
-            , data_(data)
+            , pool_(&pool)
         {}
 
         reference operator*() const
         {
-            return data_[index_].value;
+            return *pool_->slot(index_).value();
         }
 
         pointer operator->()
         {
-            return &data_[index_].value;
+            return pool_->slot(index_).value();
         }
 
         Iterator& operator++()
         {
-            ++index_;
-            while (index_ < data_.size() && data_[index_].full == 0)
-            {
-                ++index_;
-            }
+            index_ = pool_->next_full(index_ + 1);
             return *this;
         }
 
@@ -402,7 +437,7 @@ public:
 
         friend bool operator==(const Iterator& a, const Iterator& b)
         {
-            return a.data_.data() == b.data_.data() && a.index_ == b.index_;
+            return a.pool_ == b.pool_ && a.index_ == b.index_;
         }
 
         friend bool operator!=(const Iterator& a, const Iterator& b)
@@ -411,53 +446,98 @@ public:
         }
 
     private:
-        size_t index_;
-        Buffer<Data>& data_;
+        uint32_t index_;
+        Pool<T>* pool_;
     };
 
     Iterator begin()
     {
-        size_t i = 0;
-        for (; i < data_.size(); ++i)
-        {
-            if (data_[i].full)
-            {
-                break;
-            }
-        }
-        return Iterator{i, data_};
+        return Iterator{next_full(0), *this};
     }
 
     Iterator end()
     {
-        return Iterator{data_.size(), data_};
+        return Iterator{size_.load(std::memory_order_relaxed), *this};
     }
 
 private:
-    uint32_t get_next_free_slot(Data*& free_data)
+    uint32_t chunk_index(uint32_t index) const
     {
-        if (free_ == UINT32_MAX)
+        return uint32_t(std::bit_width((uint64_t(index) >> first_chunk_shift_) + 1) - 1);
+    }
+
+    Slot& slot(uint32_t index) const
+    {
+        uint32_t i_chunk = chunk_index(index);
+        uint64_t chunk_start = ((uint64_t(1) << i_chunk) - 1) << first_chunk_shift_;
+        return chunks_[i_chunk].load(std::memory_order_acquire)[index - chunk_start];
+    }
+
+    // Threads that claimed indices in the same new chunk race to allocate it, the losers free their copy
+    void ensure_chunk(uint32_t i_chunk)
+    {
+        if (chunks_[i_chunk].load(std::memory_order_acquire) != nullptr)
+        {
+            return;
+        }
+        Slot* chunk = new Slot[size_t(1) << (first_chunk_shift_ + i_chunk)];
+        Slot* expected = nullptr;
+        if (!chunks_[i_chunk].compare_exchange_strong(expected, chunk, std::memory_order_acq_rel))
         {
-            size_t current_size = data_.size();
-            data_.resize(current_size * 2);
-            free_ = current_size;
-            for (uint32_t i = current_size; i < data_.size(); ++i)
+            delete[] chunk;
+        }
+    }
+
+    // The head of the free list packs a tag in its upper half, bumped by every push and pop
+    uint32_t pop_free_slot()
+    {
+        uint64_t head = free_.load(std::memory_order_acquire);
+        while (uint32_t(head) != NONE)
+        {
+            uint32_t next = slot(uint32_t(head)).next.load(std::memory_order_relaxed);
+            uint64_t new_head = ((head >> 32) + 1) << 32 | next;
+            if (free_.compare_exchange_weak(head, new_head, std::memory_order_acquire))
             {
-                data_[i].full = 0;
-                data_[i].version = 0;
-                data_[i].next = i + 1;
+                return uint32_t(head);
             }
-            data_[data_.size() - 1].next = UINT32_MAX;
         }
+        return NONE;
+    }
 
-        free_data = &data_[free_];
-        uint32_t free_index = free_;
-        free_ = free_data->next;
-        free_data->full = 1;
-        return free_index;
+    void push_free_slot(uint32_t index)
+    {
+        Slot& s = slot(index);
+        uint64_t head = free_.load(std::memory_order_relaxed);
+        uint64_t new_head;
+        do
+        {
+            s.next.store(uint32_t(head), std::memory_order_relaxed);
+            new_head = ((head >> 32) + 1) << 32 | index;
+        } while (!free_.compare_exchange_weak(head, new_head, std::memory_order_release, std::memory_order_relaxed));
     }
 
-    Buffer<Data> data_;
-    uint32_t free_ = UINT32_MAX;
+    uint32_t next_full(uint32_t index) const
+    {
+        uint32_t size = size_.load(std::memory_order_relaxed);
+        while (index < size && !slot(index).full())
+        {
+            ++index;
+        }
+        return index;
+    }
+
+    void destroy()
+    {
+        clear();
+        for (auto& chunk : chunks_)
+        {
+            delete[] chunk.exchange(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    uint32_t first_chunk_shift_ = 0;
+    std::atomic<Slot*> chunks_[MAX_CHUNKS] = {};
+    std::atomic<uint32_t> size_ = 0;
+    std::atomic<uint64_t> free_ = NONE;
 };
 } // namespace bul
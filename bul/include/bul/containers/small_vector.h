@@ -0,0 +1,313 @@
+#pragma once
+
+#include <cstdlib>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "bul/bul.h"
+#include "bul/memory.h"
+
+namespace bul
+{
+/*
+ * Same interface as StaticVector, but once more than INLINE_CAPACITY elements are pushed they are moved to the heap
+ * instead of the push failing. Unlike StaticVector the inline storage is left uninitialized, so T does not need to be
+ * default constructible.
+ */
+template <typename T, size_t INLINE_CAPACITY>
+class SmallVector
+{
+    static_assert(INLINE_CAPACITY > 0, "Inline capacity must not be 0");
+
+public:
+    SmallVector() = default;
+
+    SmallVector(std::initializer_list<T> vals)
+    {
+        reserve(vals.size());
+        for (const auto& val : vals)
+        {
+            new (data_ + size_) T(val);
+            ++size_;
+        }
+    }
+
+    SmallVector(const SmallVector& other)
+    {
+        *this = other;
+    }
+
+    // Never allocates, an inline source fits in the inline storage
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        *this = std::move(other);
+    }
+
+    ~SmallVector()
+    {
+        clear();
+        free_heap();
+    }
+
+    SmallVector& operator=(const SmallVector& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            reserve(other.size_);
+            for (size_t i = 0; i < other.size_; ++i)
+            {
+                new (data_ + i) T(other.data_[i]);
+            }
+            size_ = other.size_;
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        if (this == &other)
+        {
+            return *this;
+        }
+        clear();
+        if (!other.is_inline())
+        {
+            // Heap storage changes hands, inline elements have to be moved one by one
+            free_heap();
+            data_ = std::exchange(other.data_, other.inline_data());
+            capacity_ = std::exchange(other.capacity_, INLINE_CAPACITY);
+            size_ = std::exchange(other.size_, 0);
+            return *this;
+        }
+        reserve(other.size_);
+        for (size_t i = 0; i < other.size_; ++i)
+        {
+            new (data_ + i) T(std::move(other.data_[i]));
+        }
+        size_ = other.size_;
+        other.clear();
+        return *this;
+    }
+
+    void reserve(size_t new_capacity)
+    {
+        if (new_capacity <= capacity_)
+        {
+            return;
+        }
+        T* new_data =
+            (T*)memory::allocate(new_capacity * sizeof(T), alignof(T), memory::tag_or(memory::Tag::Containers));
+        if (new_data == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        for (size_t i = 0; i < size_; ++i)
+        {
+            new (new_data + i) T(std::move(data_[i]));
+            if constexpr (!std::is_trivially_destructible_v<T>)
+            {
+                data_[i].~T();
+            }
+        }
+        free_heap();
+        data_ = new_data;
+        capacity_ = new_capacity;
+    }
+
+    void resize(size_t new_size)
+    {
+        reserve(new_size);
+        for (size_t i = size_; i < new_size; ++i)
+        {
+            new (data_ + i) T();
+        }
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            for (size_t i = new_size; i < size_; ++i)
+            {
+                data_[i].~T();
+            }
+        }
+        size_ = new_size;
+    }
+
+    void push_back(const T& val)
+    {
+        emplace_back(val);
+    }
+
+    void push_back(T&& val)
+    {
+        emplace_back(std::move(val));
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        if (size_ == capacity_)
+        {
+            // Constructed before growing in case args refer to an element of this vector
+            T val(std::forward<Args>(args)...);
+            reserve(capacity_ * 2);
+            new (data_ + size_) T(std::move(val));
+        }
+        else
+        {
+            new (data_ + size_) T(std::forward<Args>(args)...);
+        }
+        return data_[size_++];
+    }
+
+    bool pop_back()
+    {
+        if (size_ == 0)
+        {
+            return false;
+        }
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            data_[size_ - 1].~T();
+        }
+        --size_;
+        return true;
+    }
+
+    // Keeps the heap storage if there is one
+    void clear()
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            for (size_t i = 0; i < size_; ++i)
+            {
+                data_[i].~T();
+            }
+        }
+        size_ = 0;
+    }
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    bool is_inline() const
+    {
+        return data_ == inline_data();
+    }
+
+    T* begin()
+    {
+        return data_;
+    }
+
+    T* end()
+    {
+        return data_ + size_;
+    }
+
+    const T* begin() const
+    {
+        return data_;
+    }
+
+    const T* end() const
+    {
+        return data_ + size_;
+    }
+
+    const T* data() const
+    {
+        return data_;
+    }
+
+    T* data()
+    {
+        return data_;
+    }
+
+    const T& front() const
+    {
+        return data_[0];
+    }
+
+    T& front()
+    {
+        return data_[0];
+    }
+
+    const T& back() const
+    {
+        return data_[size_ - 1];
+    }
+
+    T& back()
+    {
+        return data_[size_ - 1];
+    }
+
+    const T& operator[](size_t index) const
+    {
+        return data_[index];
+    }
+
+    T& operator[](size_t index)
+    {
+        return data_[index];
+    }
+
+    friend bool operator==(const SmallVector& a, const SmallVector& b)
+    {
+        if (a.size_ != b.size_)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < a.size_; ++i)
+        {
+            if (!(a.data_[i] == b.data_[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    T* inline_data()
+    {
+        return std::launder(reinterpret_cast<T*>(inline_));
+    }
+
+    const T* inline_data() const
+    {
+        return std::launder(reinterpret_cast<const T*>(inline_));
+    }
+
+    void free_heap()
+    {
+        if (!is_inline())
+        {
+            memory::deallocate(data_);
+            data_ = inline_data();
+            capacity_ = INLINE_CAPACITY;
+        }
+    }
+
+    T* data_ = inline_data();
+    size_t size_ = 0;
+    size_t capacity_ = INLINE_CAPACITY;
+    alignas(T) unsigned char inline_[INLINE_CAPACITY * sizeof(T)];
+};
+} // namespace bul
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "bul/bul.h"
+
+namespace bul
+{
+/*
+ * Bounded ring buffer for exactly one producer thread and one consumer thread. Each side owns one index and keeps a
+ * cached copy of the other one, which it only reloads when the queue looks full or empty, so the indices don't bounce
+ * between the two cores on every operation.
+ */
+template <typename T, size_t CAPACITY>
+class SpscQueue
+{
+    static_assert(std::has_single_bit(CAPACITY), "Capacity must be a power of 2");
+
+public:
+    SpscQueue() = default;
+
+    ~SpscQueue()
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            for (size_t i = head_.load(std::memory_order_relaxed); i != tail_.load(std::memory_order_relaxed); ++i)
+            {
+                slot(i)->~T();
+            }
+        }
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side
+
+    bool push_back(const T& val)
+    {
+        return emplace_back(val);
+    }
+
+    bool push_back(T&& val)
+    {
+        return emplace_back(std::move(val));
+    }
+
+    template <typename... Args>
+    bool emplace_back(Args&&... args)
+    {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ == CAPACITY)
+        {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ == CAPACITY)
+            {
+                return false;
+            }
+        }
+        new (slot(tail)) T(std::forward<Args>(args)...);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+
+    bool pop_front(T& val)
+    {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_)
+        {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_)
+            {
+                return false;
+            }
+        }
+        T* front = slot(head);
+        val = std::move(*front);
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            front->~T();
+        }
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Only a snapshot when the other side is running
+    size_t size() const
+    {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    constexpr size_t capacity() const
+    {
+        return CAPACITY;
+    }
+
+private:
+    T* slot(size_t i)
+    {
+        return std::launder(reinterpret_cast<T*>(slots_[i & (CAPACITY - 1)].storage));
+    }
+
+    struct Slot
+    {
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    // Written by the producer
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_ = 0;
+    size_t head_cache_ = 0;
+    // Written by the consumer
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_ = 0;
+    size_t tail_cache_ = 0;
+    alignas(CACHE_LINE_SIZE) Slot slots_[CAPACITY];
+};
+} // namespace bul
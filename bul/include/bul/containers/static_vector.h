@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstddef>
 #include <type_traits>
 #include <initializer_list>
+#include <new>
+#include <utility>
 
 namespace bul
 {
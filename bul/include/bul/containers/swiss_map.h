@@ -0,0 +1,316 @@
+#pragma once
+
+#include "bul/bul.h"
+#include "bul/hash.h"
+
+#include <utility>
+#include <concepts>
+#include <cstring>
+#include <vector>
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BUL_SWISS_MAP_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace bul
+{
+/*
+ * Same interface as Map, but slots are probed 16 at a time: every slot has a control byte holding
+ * 7 bits of the hash, or EMPTY/DELETED, and a whole group of control bytes is compared against the
+ * hash at once. Entries are stored densely and the slots only hold their index.
+ */
+template <typename KEY_T, typename VAL_T>
+requires std::equality_comparable<KEY_T>
+class SwissMap
+{
+public:
+    struct Entry
+    {
+        template <typename... Args>
+        Entry(const KEY_T& k, Args&&... args)
+            : key{k}
+            , val{std::forward<Args>(args)...}
+        {}
+
+        template <typename... Args>
+        Entry(KEY_T&& k, Args&&... args)
+            : key{std::move(k)}
+            , val{std::forward<Args>(args)...}
+        {}
+
+        KEY_T key;
+        VAL_T val;
+    };
+
+    explicit SwissMap(size_t capacity_ = GROUP_SIZE)
+    {
+        ASSERT(std::has_single_bit(capacity_) && capacity_ >= GROUP_SIZE);
+        reset(capacity_);
+        entries_.reserve(growth_left_);
+    }
+
+    template <typename K, typename V>
+    requires std::constructible_from<KEY_T, K> && std::constructible_from<VAL_T, V>
+    Entry* insert(K&& key, V&& val)
+    {
+        return emplace(std::forward<K>(key), std::forward<V>(val));
+    }
+
+    template <typename K, typename... Args>
+    requires std::constructible_from<KEY_T, K> && std::constructible_from<VAL_T, Args...>
+    Entry* emplace(K&& key, Args&&... args)
+    {
+        Entry& entry = entries_.emplace_back(std::forward<K>(key), std::forward<Args>(args)...);
+        uint64_t hash = bul::hash(entry.key);
+        if (find(entry.key, hash) != nullptr)
+        {
+            entries_.pop_back();
+            return nullptr;
+        }
+
+        if (growth_left_ == 0)
+        {
+            // Tombstones count against the growth budget, rehash in place when they make up most of it
+            rehash(size() >= capacity() / 2 ? capacity() * 2 : capacity());
+        }
+
+        size_t i_slot = find_insert_slot(hash);
+        growth_left_ -= ctrl_[i_slot] == EMPTY;
+        ctrl_[i_slot] = h2(hash);
+        slots_[i_slot] = uint32_t(entries_.size() - 1);
+        return &entries_.back();
+    }
+
+    bool erase(const KEY_T& key)
+    {
+        uint32_t* found_slot = find(key, bul::hash(key));
+        if (found_slot == nullptr)
+        {
+            return false;
+        }
+
+        size_t i_slot = found_slot - slots_.data();
+        uint32_t index = *found_slot;
+        uint32_t last_index = uint32_t(entries_.size() - 1);
+
+        if (index != last_index)
+        {
+            entries_[index] = std::move(entries_.back());
+            *find_index(bul::hash(entries_[index].key), last_index) = index;
+        }
+        entries_.pop_back();
+
+        // Lookups stop at the first group with an empty slot, so a group that never filled up can get
+        // its slot back, otherwise a tombstone keeps the probe sequences going through it intact
+        if (match_empty(group_start(i_slot)) != 0)
+        {
+            ctrl_[i_slot] = EMPTY;
+            growth_left_ += 1;
+        }
+        else
+        {
+            ctrl_[i_slot] = DELETED;
+        }
+        return true;
+    }
+
+    Entry* operator[](const KEY_T& key)
+    {
+        uint32_t* slot = find(key, bul::hash(key));
+        if (slot != nullptr)
+        {
+            return &entries_[*slot];
+        }
+        return nullptr;
+    }
+
+    const Entry* operator[](const KEY_T& key) const
+    {
+        return (*const_cast<SwissMap<KEY_T, VAL_T>*>(this))[key];
+    }
+
+    size_t size() const
+    {
+        return entries_.size();
+    }
+
+    size_t capacity() const
+    {
+        return ctrl_.size();
+    }
+
+    const auto begin() const
+    {
+        return entries_.begin();
+    }
+
+    auto begin()
+    {
+        return entries_.begin();
+    }
+
+    const auto end() const
+    {
+        return entries_.end();
+    }
+
+    auto end()
+    {
+        return entries_.end();
+    }
+
+    static inline constexpr size_t GROUP_SIZE = 16;
+
+private:
+    static inline constexpr uint8_t EMPTY = 0x80;
+    static inline constexpr uint8_t DELETED = 0xfe;
+
+    static uint8_t h2(uint64_t hash)
+    {
+        return hash & 0x7f;
+    }
+
+    static size_t h1(uint64_t hash)
+    {
+        return size_t(hash >> 7);
+    }
+
+    size_t group_start(size_t i_slot) const
+    {
+        return i_slot & ~(GROUP_SIZE - 1);
+    }
+
+#if defined(BUL_SWISS_MAP_SSE2)
+    uint32_t match(size_t i_group, uint8_t h) const
+    {
+        __m128i ctrl = _mm_loadu_si128((const __m128i*)(ctrl_.data() + i_group));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(char(h))));
+    }
+
+    // EMPTY and DELETED are the only control bytes with the high bit set
+    uint32_t match_empty_or_deleted(size_t i_group) const
+    {
+        return _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(ctrl_.data() + i_group)));
+    }
+#else
+    uint32_t match(size_t i_group, uint8_t h) const
+    {
+        uint32_t mask = 0;
+        for (uint32_t i = 0; i < GROUP_SIZE; ++i)
+        {
+            mask |= uint32_t(ctrl_[i_group + i] == h) << i;
+        }
+        return mask;
+    }
+
+    uint32_t match_empty_or_deleted(size_t i_group) const
+    {
+        uint32_t mask = 0;
+        for (uint32_t i = 0; i < GROUP_SIZE; ++i)
+        {
+            mask |= uint32_t(ctrl_[i_group + i] >> 7) << i;
+        }
+        return mask;
+    }
+#endif
+
+    uint32_t match_empty(size_t i_group) const
+    {
+        return match(i_group, EMPTY);
+    }
+
+    // Triangular probing over the groups visits every group once when the group count is a power of 2
+    template <typename F>
+    auto probe(uint64_t hash, F&& visit_group) const
+    {
+        size_t group_mask = capacity() / GROUP_SIZE - 1;
+        size_t i_group = h1(hash) & group_mask;
+        for (size_t step = 1;; ++step)
+        {
+            if (auto result = visit_group(i_group * GROUP_SIZE))
+            {
+                return result;
+            }
+            i_group = (i_group + step) & group_mask;
+        }
+    }
+
+    uint32_t* find(const KEY_T& key, uint64_t hash)
+    {
+        uint8_t h = h2(hash);
+        uint32_t* found = nullptr;
+        probe(hash, [&](size_t i_group) {
+            for (uint32_t mask = match(i_group, h); mask != 0; mask &= mask - 1)
+            {
+                size_t i_slot = i_group + std::countr_zero(mask);
+                if (entries_[slots_[i_slot]].key == key)
+                {
+                    found = &slots_[i_slot];
+                    return true;
+                }
+            }
+            return match_empty(i_group) != 0;
+        });
+        return found;
+    }
+
+    uint32_t* find_index(uint64_t hash, uint32_t index)
+    {
+        uint8_t h = h2(hash);
+        uint32_t* found = nullptr;
+        probe(hash, [&](size_t i_group) {
+            for (uint32_t mask = match(i_group, h); mask != 0; mask &= mask - 1)
+            {
+                size_t i_slot = i_group + std::countr_zero(mask);
+                if (slots_[i_slot] == index)
+                {
+                    found = &slots_[i_slot];
+                    return true;
+                }
+            }
+            return false;
+        });
+        return found;
+    }
+
+    size_t find_insert_slot(uint64_t hash) const
+    {
+        size_t i_slot = 0;
+        probe(hash, [&](size_t i_group) {
+            uint32_t mask = match_empty_or_deleted(i_group);
+            i_slot = i_group + std::countr_zero(mask);
+            return mask != 0;
+        });
+        return i_slot;
+    }
+
+    void reset(size_t capacity_)
+    {
+        ctrl_.assign(capacity_, EMPTY);
+        slots_.assign(capacity_, 0);
+        growth_left_ = capacity_ - capacity_ / 8;
+    }
+
+    // The last entry is the one being inserted, it is left for the caller to place
+    void rehash(size_t capacity_)
+    {
+        reset(capacity_);
+        size_t count = entries_.size() - 1;
+        for (size_t i_entry = 0; i_entry < count; ++i_entry)
+        {
+            uint64_t hash = bul::hash(entries_[i_entry].key);
+            size_t i_slot = find_insert_slot(hash);
+            ctrl_[i_slot] = h2(hash);
+            slots_[i_slot] = uint32_t(i_entry);
+        }
+        growth_left_ -= count;
+    }
+
+    std::vector<uint8_t> ctrl_;
+    std::vector<uint32_t> slots_;
+    std::vector<Entry> entries_;
+    size_t growth_left_ = 0;
+};
+} // namespace bul
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <vector>
 
 namespace bul
@@ -8,4 +11,68 @@ size_t file_size(const char* path);
 bool read_file(const char* path, uint8_t* data, size_t size);
 bool read_file(const char* path, std::vector<uint8_t>& data);
 bool write_file(const char* path, const uint8_t* data, size_t size);
+
+/*
+ * Read-only memory mapping of a whole file. Pages are read by the kernel on first access and shared with the page
+ * cache, so nothing is copied or zeroed up front like read_file does. The access pattern tells the kernel how far to
+ * read ahead. Loaders take a std::span<const uint8_t> so that they work the same on a mapping or a buffer.
+ */
+class MappedFile
+{
+public:
+    enum class Access
+    {
+        Normal,
+        // Aggressive read ahead, for files parsed front to back
+        Sequential,
+        // No read ahead, for files that are only partially read
+        Random,
+    };
+
+    MappedFile() = default;
+    explicit MappedFile(const char* path, Access access = Access::Sequential);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other);
+    MappedFile& operator=(MappedFile&& other);
+
+    // Maps path in place of the current mapping, returns false if it cannot be opened. Empty files map to an empty
+    // span and count as open.
+    bool open(const char* path, Access access = Access::Sequential);
+    void close();
+    // Changes the read ahead of the current mapping
+    void advise(Access access);
+
+    bool is_open() const
+    {
+        return open_;
+    }
+
+    const uint8_t* data() const
+    {
+        return data_;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    std::span<const uint8_t> span() const
+    {
+        return {data_, size_};
+    }
+
+    operator std::span<const uint8_t>() const
+    {
+        return span();
+    }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool open_ = false;
+};
 } // namespace bul
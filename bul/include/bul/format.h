@@ -1,9 +1,334 @@
 #pragma once
 
+#include <algorithm>
+#include <charconv>
 #include <cstdarg>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
 
+#include "bul/containers/buffer.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define BUL_PRINTF_FORMAT(FMT, ARGS) __attribute__((format(printf, FMT, ARGS)))
+#else
+#define BUL_PRINTF_FORMAT(FMT, ARGS)
+#endif
+
+/*
+ * Formatting into a thread local buffer, the returned string is valid until the next call on the same thread.
+ *
+ * format replaces every {} with the next argument: integers, floats (shortest representation that reads back the
+ * same), strings, chars, bools and pointers. {:x} writes an integer or a pointer in hexadecimal, {:.N} a float with N
+ * decimals, {{ and }} are literal braces. The format string is checked against the arguments at compile time.
+ */
 namespace bul
 {
-const char* format(const char* fmt, ...);
-const char* format(const char* fmt, va_list args);
+namespace detail
+{
+enum class FormatArg
+{
+    Integer,
+    Float,
+    String,
+    Char,
+    Bool,
+    Pointer,
+};
+
+template <typename T>
+consteval FormatArg format_arg()
+{
+    using U = std::remove_cvref_t<std::decay_t<T>>;
+    if constexpr (std::is_same_v<U, bool>)
+    {
+        return FormatArg::Bool;
+    }
+    else if constexpr (std::is_same_v<U, char>)
+    {
+        return FormatArg::Char;
+    }
+    else if constexpr (std::is_integral_v<U> || std::is_enum_v<U>)
+    {
+        return FormatArg::Integer;
+    }
+    else if constexpr (std::is_floating_point_v<U>)
+    {
+        return FormatArg::Float;
+    }
+    else if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*> || std::is_same_v<U, std::string>
+                       || std::is_same_v<U, std::string_view>)
+    {
+        return FormatArg::String;
+    }
+    else if constexpr (std::is_pointer_v<U> || std::is_null_pointer_v<U>)
+    {
+        return FormatArg::Pointer;
+    }
+    else
+    {
+        static_assert(!sizeof(T), "Type can't be formatted");
+    }
+}
+
+// Not constexpr: reaching it while checking a format string at compile time is the error
+inline void format_error(const char*)
+{}
+
+struct FormatSpec
+{
+    bool hex = false;
+    int precision = -1;
+};
+
+// Parses the spec of the placeholder starting at fmt[i] == '{', i ends after its '}'. Returns false when it is invalid.
+constexpr bool parse_format_spec(std::string_view fmt, size_t& i, FormatSpec& spec)
+{
+    ++i;
+    if (i < fmt.size() && fmt[i] == ':')
+    {
+        ++i;
+        if (i < fmt.size() && fmt[i] == 'x')
+        {
+            spec.hex = true;
+            ++i;
+        }
+        else if (i < fmt.size() && fmt[i] == '.')
+        {
+            ++i;
+            spec.precision = 0;
+            size_t digits = 0;
+            for (; i < fmt.size() && fmt[i] >= '0' && fmt[i] <= '9' && digits < 2; ++i, ++digits)
+            {
+                spec.precision = spec.precision * 10 + (fmt[i] - '0');
+            }
+            if (digits == 0)
+            {
+                return false;
+            }
+        }
+    }
+    if (i >= fmt.size() || fmt[i] != '}')
+    {
+        return false;
+    }
+    ++i;
+    return true;
+}
+
+template <typename... Args>
+consteval void check_format(std::string_view fmt)
+{
+    constexpr FormatArg args[] = {format_arg<Args>()..., FormatArg::Integer};
+    size_t arg = 0;
+    for (size_t i = 0; i < fmt.size();)
+    {
+        if (fmt[i] == '{' && i + 1 < fmt.size() && fmt[i + 1] == '{')
+        {
+            i += 2;
+        }
+        else if (fmt[i] == '}')
+        {
+            if (i + 1 >= fmt.size() || fmt[i + 1] != '}')
+            {
+                format_error("Unmatched } in format string, write }} for a literal brace");
+            }
+            i += 2;
+        }
+        else if (fmt[i] == '{')
+        {
+            FormatSpec spec;
+            if (!parse_format_spec(fmt, i, spec))
+            {
+                format_error("Invalid placeholder in format string, expected {}, {:x} or {:.N}");
+            }
+            if (arg >= sizeof...(Args))
+            {
+                format_error("More placeholders than arguments in format string");
+            }
+            if (spec.hex && args[arg] != FormatArg::Integer && args[arg] != FormatArg::Pointer)
+            {
+                format_error("{:x} needs an integer or a pointer");
+            }
+            if (spec.precision >= 0 && args[arg] != FormatArg::Float)
+            {
+                format_error("{:.N} needs a float");
+            }
+            ++arg;
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    if (arg != sizeof...(Args))
+    {
+        format_error("More arguments than placeholders in format string");
+    }
+}
+
+Buffer<char>& format_buffer();
+
+// Appends to the thread local buffer
+class FormatWriter
+{
+public:
+    FormatWriter() : buffer_(format_buffer())
+    {}
+
+    // Room for size more characters
+    char* reserve(size_t size)
+    {
+        if (size_ + size > buffer_.size())
+        {
+            buffer_.resize(std::max(size_ + size, buffer_.size() * 2));
+        }
+        return buffer_.data() + size_;
+    }
+
+    void commit(const char* end)
+    {
+        size_ = size_t(end - buffer_.data());
+    }
+
+    void append(std::string_view str)
+    {
+        std::memcpy(reserve(str.size()), str.data(), str.size());
+        size_ += str.size();
+    }
+
+    const char* finish()
+    {
+        *reserve(1) = '\0';
+        return buffer_.data();
+    }
+
+private:
+    Buffer<char>& buffer_;
+    size_t size_ = 0;
+};
+
+// Copies the text up to the next placeholder and parses it, or up to the end. Returns false at the end.
+inline bool format_until_placeholder(FormatWriter& writer, std::string_view fmt, size_t& i, FormatSpec& spec)
+{
+    size_t begin = i;
+    while (i < fmt.size())
+    {
+        char c = fmt[i];
+        if (c != '{' && c != '}')
+        {
+            ++i;
+            continue;
+        }
+        writer.append(fmt.substr(begin, i - begin));
+        // Escaped braces, the first one is kept
+        if (i + 1 < fmt.size() && fmt[i + 1] == c)
+        {
+            begin = i + 1;
+            i += 2;
+            continue;
+        }
+        spec = {};
+        parse_format_spec(fmt, i, spec);
+        return true;
+    }
+    writer.append(fmt.substr(begin));
+    return false;
+}
+
+template <typename T>
+void format_value(FormatWriter& writer, const FormatSpec& spec, const T& value)
+{
+    using U = std::remove_cvref_t<std::decay_t<T>>;
+    constexpr FormatArg kind = format_arg<T>();
+    if constexpr (kind == FormatArg::Bool)
+    {
+        writer.append(value ? "true" : "false");
+    }
+    else if constexpr (kind == FormatArg::Char)
+    {
+        char* out = writer.reserve(1);
+        *out = value;
+        writer.commit(out + 1);
+    }
+    else if constexpr (kind == FormatArg::Integer)
+    {
+        using I = typename std::conditional_t<std::is_enum_v<U>, std::underlying_type<U>, std::type_identity<U>>::type;
+        // Sign and 64 bits in base 10
+        char* out = writer.reserve(24);
+        writer.commit(std::to_chars(out, out + 24, I(value), spec.hex ? 16 : 10).ptr);
+    }
+    else if constexpr (kind == FormatArg::Float)
+    {
+        if (spec.precision >= 0)
+        {
+            // Up to 309 digits before the point for a double
+            size_t size = 320 + size_t(spec.precision);
+            char* out = writer.reserve(size);
+            writer.commit(std::to_chars(out, out + size, value, std::chars_format::fixed, spec.precision).ptr);
+        }
+        else
+        {
+            char* out = writer.reserve(64);
+            writer.commit(std::to_chars(out, out + 64, value).ptr);
+        }
+    }
+    else if constexpr (kind == FormatArg::String)
+    {
+        if constexpr (std::is_pointer_v<U>)
+        {
+            writer.append(value != nullptr ? std::string_view(value) : std::string_view("(null)"));
+        }
+        else
+        {
+            writer.append(value);
+        }
+    }
+    else
+    {
+        char* out = writer.reserve(18);
+        out[0] = '0';
+        out[1] = 'x';
+        writer.commit(std::to_chars(out + 2, out + 18, reinterpret_cast<uintptr_t>(value), 16).ptr);
+    }
+}
+} // namespace detail
+
+template <typename... Args>
+class FormatString
+{
+public:
+    template <typename S>
+        requires std::is_convertible_v<const S&, std::string_view>
+    consteval FormatString(const S& str) : str_(str)
+    {
+        detail::check_format<Args...>(str_);
+    }
+
+    std::string_view get() const
+    {
+        return str_;
+    }
+
+private:
+    std::string_view str_;
+};
+
+template <typename... Args>
+const char* format(FormatString<std::type_identity_t<Args>...> fmt, const Args&... args)
+{
+    std::string_view str = fmt.get();
+    detail::FormatWriter writer;
+    size_t i = 0;
+    detail::FormatSpec spec;
+    ((detail::format_until_placeholder(writer, str, i, spec), detail::format_value(writer, spec, args)), ...);
+    detail::format_until_placeholder(writer, str, i, spec);
+    return writer.finish();
+}
+
+// printf rules, formats in place and only formats again when the result did not fit in the buffer
+const char* formatf(const char* fmt, ...) BUL_PRINTF_FORMAT(1, 2);
+const char* formatf(const char* fmt, va_list args);
 } // namespace bul
@@ -3,7 +3,12 @@
 #include <cstdint>
 #include <string_view>
 #include <concepts>
+#include <type_traits>
 
+/*
+ * XXH3 hashes. Values are hashed by their bytes: strings by their characters, containers by the bytes of their
+ * elements, and any other trivially copyable object by its object representation, padding included.
+ */
 namespace bul
 {
 template <typename T>
@@ -13,27 +18,90 @@ concept is_container = requires(T value)
     { value.size() } -> std::convertible_to<size_t>;
 };
 
-uint64_t hash(const void* data, size_t size);
+struct Hash128
+{
+    uint64_t low = 0;
+    uint64_t high = 0;
+
+    bool operator==(const Hash128& other) const = default;
+};
+
+uint64_t hash(const void* data, size_t size, uint64_t seed = 0);
+Hash128 hash128(const void* data, size_t size, uint64_t seed = 0);
+
+namespace detail
+{
+struct HashBytes
+{
+    const void* data;
+    size_t size;
+};
 
 template <typename T>
-requires(!std::constructible_from<std::string_view, T>)
-uint64_t hash(const T& value)
+HashBytes hash_bytes(const T& value)
 {
-    return hash(&value, sizeof(value));
+    if constexpr (std::constructible_from<std::string_view, T>)
+    {
+        std::string_view sv = value;
+        return {sv.data(), sv.size()};
+    }
+    else if constexpr (is_container<T>)
+    {
+        static_assert(std::is_trivially_copyable_v<std::remove_cvref_t<decltype(*value.data())>>,
+                      "Only containers of trivially copyable values are hashed by their bytes");
+        return {value.data(), value.size() * sizeof(*value.data())};
+    }
+    else
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values are hashed by their bytes");
+        return {&value, sizeof(value)};
+    }
 }
+} // namespace detail
 
 template <typename T>
-requires(!std::constructible_from<std::string_view, T> && is_container<T>)
 uint64_t hash(const T& value)
 {
-    return hash(value.data(), value.size());
+    detail::HashBytes bytes = detail::hash_bytes(value);
+    return hash(bytes.data, bytes.size);
+}
+
+// Not an overload of hash, hash(pointer, size) would be ambiguous
+template <typename T>
+uint64_t hash_seeded(const T& value, uint64_t seed)
+{
+    detail::HashBytes bytes = detail::hash_bytes(value);
+    return hash(bytes.data, bytes.size, seed);
 }
 
 template <typename T>
-requires(std::constructible_from<std::string_view, T>)
-uint64_t hash(const T& value) noexcept
+Hash128 hash128(const T& value)
 {
-    std::string_view sv = value;
-    return hash(sv.data(), sv.size());
+    detail::HashBytes bytes = detail::hash_bytes(value);
+    return hash128(bytes.data, bytes.size);
 }
+
+// Streaming hash of several values, the result is the hash of their bytes one after the other
+class Hasher
+{
+public:
+    explicit Hasher(uint64_t seed = 0);
+
+    Hasher& update(const void* data, size_t size);
+
+    template <typename T>
+    Hasher& add(const T& value)
+    {
+        detail::HashBytes bytes = detail::hash_bytes(value);
+        return update(bytes.data, bytes.size);
+    }
+
+    // Can be called more than once, and more values added in between
+    uint64_t digest() const;
+    Hash128 digest128() const;
+
+private:
+    // The XXH3 state, without pulling xxhash.h in
+    alignas(64) unsigned char state_[576];
+};
 } // namespace bul
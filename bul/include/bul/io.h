@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+
+#include "bul/jobs.h"
+
+/*
+ * Asynchronous whole-file reads. Requests are picked up by an I/O thread that submits all of those that arrived since
+ * its last pass in one io_uring_enter, so many small files cost one syscall rather than one read each. Where io_uring
+ * is not available (other platforms, old kernels, seccomp) a pool of threads reads the files with blocking calls
+ * instead. Completions are handed to bul::jobs, decoding a file runs on the workers while the next ones are read.
+ */
+namespace bul::io
+{
+enum class Backend
+{
+    IoUring,
+    ThreadPool,
+};
+
+// data is only valid during the call, it is empty and ok is false when the file could not be opened or read
+using ReadCallback = std::function<void(std::span<const uint8_t> data, bool ok)>;
+
+// jobs::init has to be called first. queue_depth is the number of reads in flight. IoUring falls back to ThreadPool
+// when the kernel refuses to create a ring.
+void init(uint32_t queue_depth = 64, Backend backend = Backend::IoUring);
+// Waits for the pending reads, their callbacks may still be running as jobs
+void shutdown();
+Backend backend();
+
+// Reads the whole file at path then runs callback as a job. When a counter is given it counts the read and the
+// callback, jobs::wait on it returns once both are done.
+void read(std::string path, ReadCallback callback, jobs::Counter* counter = nullptr);
+} // namespace bul::io
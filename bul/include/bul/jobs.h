@@ -0,0 +1,164 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "bul/bul.h"
+#include "bul/memory.h"
+
+/*
+ * Work-stealing job system. Every worker owns a Chase-Lev deque: it pushes and pops jobs at the bottom while idle
+ * workers steal from the top of the others. The thread calling init is worker 0 and runs jobs while it waits on a
+ * counter, the other workers sleep when there is nothing to steal. Threads that are not workers submit their jobs
+ * through a shared queue.
+ */
+namespace bul::jobs
+{
+struct Job;
+
+// Number of jobs left, a job run with a counter increments it and decrements it when it completes. Jobs can also wait
+// for a counter to reach zero before they are scheduled.
+class Counter
+{
+public:
+    Counter() = default;
+    Counter(const Counter&) = delete;
+    Counter& operator=(const Counter&) = delete;
+
+    bool done() const
+    {
+        return value_.load(std::memory_order_acquire) == 0;
+    }
+
+private:
+    friend struct Access;
+
+    std::atomic<int64_t> value_ = 0;
+    std::mutex mutex_;
+    std::vector<Job*> waiting_;
+};
+
+// 0 starts one worker per hardware thread
+void init(uint32_t thread_count = 0);
+void shutdown();
+uint32_t thread_count();
+// Index of the calling worker, UINT32_MAX on threads that are not workers
+uint32_t worker_index();
+
+// Runs jobs until the counter reaches zero, sleeping while there are none to run
+void wait(Counter& counter);
+
+// Counts work done outside of the job system, like I/O, as one more job on counter until the matching release. Jobs
+// that depend on the counter are scheduled by the release that brings it to zero.
+void acquire(Counter& counter);
+void release(Counter& counter);
+
+namespace detail
+{
+inline constexpr size_t JOB_STORAGE_SIZE = 64;
+} // namespace detail
+
+struct Job
+{
+    void (*invoke)(Job*);
+    Counter* counter;
+    // Of the thread that submitted the job, the job runs with it
+    memory::Tag memory_tag;
+    alignas(std::max_align_t) unsigned char storage[detail::JOB_STORAGE_SIZE];
+};
+
+namespace detail
+{
+Job* allocate_job();
+void submit(Job* job, Counter* counter, Counter* dependency);
+// Jobs in the deque of the calling worker, or in the shared queue for other threads
+size_t local_job_count();
+
+template <typename F>
+void store(Job* job, F&& fn)
+{
+    using Fn = std::decay_t<F>;
+    if constexpr (sizeof(Fn) <= JOB_STORAGE_SIZE && alignof(Fn) <= alignof(std::max_align_t))
+    {
+        new (job->storage) Fn(std::forward<F>(fn));
+        job->invoke = [](Job* job) {
+            Fn* fn = std::launder(reinterpret_cast<Fn*>(job->storage));
+            (*fn)();
+            fn->~Fn();
+        };
+    }
+    else
+    {
+        // Too large to be stored inline
+        new (job->storage) Fn*(new Fn(std::forward<F>(fn)));
+        job->invoke = [](Job* job) {
+            Fn* fn = *std::launder(reinterpret_cast<Fn**>(job->storage));
+            (*fn)();
+            delete fn;
+        };
+    }
+}
+
+template <typename F>
+struct ParallelFor
+{
+    F& fn;
+    uint32_t grain;
+    Counter* counter;
+
+    // The range is only split when the local deque ran dry, meaning other workers took everything that was there and
+    // could use more. Otherwise it is processed grain by grain so that a split can still happen later.
+    void run(uint32_t begin, uint32_t end);
+};
+} // namespace detail
+
+// Schedules fn, once dependency is done when one is given
+template <typename F>
+void run(F&& fn, Counter* counter = nullptr, Counter* dependency = nullptr)
+{
+    Job* job = detail::allocate_job();
+    detail::store(job, std::forward<F>(fn));
+    detail::submit(job, counter, dependency);
+}
+
+// Calls fn(begin, end) on subranges of [0, count) of at least min_grain elements, unless count is smaller, and returns
+// once they are all done
+template <typename F>
+void parallel_for(uint32_t count, F&& fn, uint32_t min_grain = 1)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    Counter counter;
+    detail::ParallelFor<F> context{fn, min_grain > 0 ? min_grain : 1, &counter};
+    context.run(0, count);
+    wait(counter);
+}
+
+template <typename F>
+void detail::ParallelFor<F>::run(uint32_t begin, uint32_t end)
+{
+    // Halves stay at least grain long and the last piece is between grain and 2 * grain
+    while (end - begin >= 2 * grain)
+    {
+        if (local_job_count() == 0)
+        {
+            uint32_t mid = begin + (end - begin) / 2;
+            jobs::run([this, mid, end]() { run(mid, end); }, counter);
+            end = mid;
+        }
+        else
+        {
+            fn(begin, begin + grain);
+            begin += grain;
+        }
+    }
+    fn(begin, end);
+}
+} // namespace bul::jobs
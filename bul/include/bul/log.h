@@ -1,5 +1,25 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+
+// Messages below this level are compiled out, 0 is LogLevel::Debug
+#ifndef BUL_LOG_MIN_LEVEL
+#define BUL_LOG_MIN_LEVEL 0
+#endif
+
+/*
+ * Asynchronous logger. A call only copies the format pointer and its arguments to a ring owned by the calling thread,
+ * a background thread formats them with printf rules and writes them out. Messages of one thread keep their order.
+ * The format has to outlive the message, in practice it is a string literal. Strings passed as const char* are copied
+ * (up to LOG_MAX_STRING bytes), other arguments have to be arithmetic types, enums or pointers.
+ */
 namespace bul
 {
 enum class LogLevel
@@ -11,9 +31,174 @@ enum class LogLevel
     Count,
 };
 
-void log_debug(const char* fmt, ...);
-void log_info(const char* fmt, ...);
-void log_warning(const char* fmt, ...);
-void log_error(const char* fmt, ...);
-void log(LogLevel level, const char* fmt, ...);
+inline constexpr size_t LOG_MAX_STRING = 1024;
+
+void set_log_level(LogLevel level);
+LogLevel log_level();
+// stdout by default, the file is not closed by the logger
+void set_log_file(FILE* file);
+// Blocks until everything logged before the call is written
+void log_flush();
+
+namespace detail
+{
+inline std::atomic<LogLevel> min_log_level = LogLevel::Debug;
+
+using LogFormat = int (*)(char* out, size_t size, const char* fmt, const uint8_t* args);
+
+struct LogHeader
+{
+    // Of the whole record with the arguments, records start 8 bytes aligned. 0 marks the end of the ring.
+    uint32_t size;
+    LogLevel level;
+    const char* fmt;
+    LogFormat format;
+};
+
+// Space for a record in the ring of the calling thread, waits for the background thread when the ring is full
+uint8_t* log_reserve(size_t size);
+// Publishes the record returned by the last log_reserve
+void log_commit();
+
+template <typename T>
+inline constexpr bool is_log_string =
+    std::is_same_v<std::decay_t<T>, const char*> || std::is_same_v<std::decay_t<T>, char*>;
+
+// String literals and char arrays are stored as strings
+template <typename T>
+using log_arg_t = std::conditional_t<is_log_string<T>, const char*, std::decay_t<T>>;
+
+template <typename T>
+size_t log_arg_size(const T& arg)
+{
+    if constexpr (is_log_string<T>)
+    {
+        return sizeof(uint32_t) + std::min(arg != nullptr ? strlen(arg) : 0, LOG_MAX_STRING) + 1;
+    }
+    else
+    {
+        static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>,
+                      "Only arithmetic types, enums, pointers and strings can be logged");
+        return sizeof(T);
+    }
+}
+
+template <typename T>
+uint8_t* log_write_arg(uint8_t* data, const T& arg)
+{
+    if constexpr (is_log_string<T>)
+    {
+        uint32_t length = uint32_t(std::min(arg != nullptr ? strlen(arg) : 0, LOG_MAX_STRING));
+        std::memcpy(data, &length, sizeof(length));
+        std::memcpy(data + sizeof(length), arg, length);
+        data[sizeof(length) + length] = '\0';
+        return data + sizeof(length) + length + 1;
+    }
+    else
+    {
+        std::memcpy(data, &arg, sizeof(T));
+        return data + sizeof(T);
+    }
+}
+
+// Strings are read back as pointers into the record
+template <typename T>
+auto log_read_arg(const uint8_t*& data)
+{
+    if constexpr (is_log_string<T>)
+    {
+        uint32_t length;
+        std::memcpy(&length, data, sizeof(length));
+        const char* str = (const char*)data + sizeof(length);
+        data += sizeof(length) + length + 1;
+        return str;
+    }
+    else
+    {
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+        data += sizeof(T);
+        // Enums are passed to printf as their underlying integer
+        if constexpr (std::is_enum_v<T>)
+        {
+            return std::underlying_type_t<T>(value);
+        }
+        else
+        {
+            return value;
+        }
+    }
+}
+
+// Runs on the background thread, one instantiation per list of argument types
+template <typename... Args>
+int log_format(char* out, size_t size, const char* fmt, const uint8_t* data)
+{
+    // Braced initialization evaluates left to right, the arguments are read in order
+    std::tuple values{log_read_arg<Args>(data)...};
+    return std::apply([&](auto... args) { return snprintf(out, size, fmt, args...); }, values);
+}
+
+template <typename... Args>
+void log_write(LogLevel level, const char* fmt, const Args&... args)
+{
+    static_assert(sizeof...(Args) <= 16, "Too many arguments for one message");
+    if (level < min_log_level.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    size_t size = sizeof(LogHeader) + (size_t(0) + ... + log_arg_size<log_arg_t<Args>>(args));
+    uint8_t* record = log_reserve(size);
+    LogHeader header{uint32_t(size), level, fmt, &log_format<log_arg_t<Args>...>};
+    std::memcpy(record, &header, sizeof(header));
+    uint8_t* data = record + sizeof(header);
+    ((data = log_write_arg<log_arg_t<Args>>(data, args)), ...);
+    log_commit();
+}
+} // namespace detail
+
+template <typename... Args>
+void log(LogLevel level, const char* fmt, const Args&... args)
+{
+    if (int(level) >= BUL_LOG_MIN_LEVEL)
+    {
+        detail::log_write(level, fmt, args...);
+    }
+}
+
+template <typename... Args>
+void log_debug(const char* fmt, const Args&... args)
+{
+    if constexpr (int(LogLevel::Debug) >= BUL_LOG_MIN_LEVEL)
+    {
+        detail::log_write(LogLevel::Debug, fmt, args...);
+    }
+}
+
+template <typename... Args>
+void log_info(const char* fmt, const Args&... args)
+{
+    if constexpr (int(LogLevel::Info) >= BUL_LOG_MIN_LEVEL)
+    {
+        detail::log_write(LogLevel::Info, fmt, args...);
+    }
+}
+
+template <typename... Args>
+void log_warning(const char* fmt, const Args&... args)
+{
+    if constexpr (int(LogLevel::Warning) >= BUL_LOG_MIN_LEVEL)
+    {
+        detail::log_write(LogLevel::Warning, fmt, args...);
+    }
+}
+
+template <typename... Args>
+void log_error(const char* fmt, const Args&... args)
+{
+    if constexpr (int(LogLevel::Error) >= BUL_LOG_MIN_LEVEL)
+    {
+        detail::log_write(LogLevel::Error, fmt, args...);
+    }
+}
 } // namespace bul
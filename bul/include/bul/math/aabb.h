@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+
+#include "bul/math/matrix.h"
+#include "bul/math/simd.h"
+#include "bul/math/vector.h"
+
+namespace bul
+{
+struct aabb
+{
+    vec3f min;
+    vec3f max;
+
+    bool operator==(const aabb& other) const = default;
+};
+
+namespace scalar
+{
+// Arvo, "Transforming Axis-Aligned Bounding Boxes", Graphics Gems 1990. Every column of m scaled by the min and max of
+// its axis contributes its smallest value to the new min and its largest to the new max.
+inline aabb transform(const mat4f& m, const aabb& box)
+{
+    aabb res;
+    for (size_t r = 0; r < 3; ++r)
+    {
+        res.min[r] = m[3][r];
+        res.max[r] = m[3][r];
+        for (size_t c = 0; c < 3; ++c)
+        {
+            float a = m[c][r] * box.min[c];
+            float b = m[c][r] * box.max[c];
+            res.min[r] += std::min(a, b);
+            res.max[r] += std::max(a, b);
+        }
+    }
+    return res;
+}
+
+inline void transform(const mat4f& m, const aabb* boxes, aabb* out, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        out[i] = transform(m, boxes[i]);
+    }
+}
+} // namespace scalar
+
+// Smallest box containing box transformed by m, the last row of m is ignored
+inline void transform(const mat4f& m, const aabb* boxes, aabb* out, size_t count)
+{
+#if defined(BUL_MATH_SSE2)
+    __m128 c0 = _mm_loadu_ps(m[0].data());
+    __m128 c1 = _mm_loadu_ps(m[1].data());
+    __m128 c2 = _mm_loadu_ps(m[2].data());
+    __m128 c3 = _mm_loadu_ps(m[3].data());
+    for (size_t i = 0; i < count; ++i)
+    {
+        const aabb& box = boxes[i];
+        __m128 min = c3;
+        __m128 max = c3;
+
+        __m128 a = _mm_mul_ps(c0, _mm_set1_ps(box.min.x));
+        __m128 b = _mm_mul_ps(c0, _mm_set1_ps(box.max.x));
+        min = _mm_add_ps(min, _mm_min_ps(a, b));
+        max = _mm_add_ps(max, _mm_max_ps(a, b));
+
+        a = _mm_mul_ps(c1, _mm_set1_ps(box.min.y));
+        b = _mm_mul_ps(c1, _mm_set1_ps(box.max.y));
+        min = _mm_add_ps(min, _mm_min_ps(a, b));
+        max = _mm_add_ps(max, _mm_max_ps(a, b));
+
+        a = _mm_mul_ps(c2, _mm_set1_ps(box.min.z));
+        b = _mm_mul_ps(c2, _mm_set1_ps(box.max.z));
+        min = _mm_add_ps(min, _mm_min_ps(a, b));
+        max = _mm_add_ps(max, _mm_max_ps(a, b));
+
+        // Both are read before out is written in case it is the same array
+        simd::store3(out[i].min.data(), min);
+        simd::store3(out[i].max.data(), max);
+    }
+#else
+    scalar::transform(m, boxes, out, count);
+#endif
+}
+
+inline aabb transform(const mat4f& m, const aabb& box)
+{
+    aabb res;
+    transform(m, &box, &res, 1);
+    return res;
+}
+} // namespace bul
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+#include "bul/bul.h"
+
+/*
+ * Approximations of libm functions for code that calls them in loops. They only use arithmetic and bit casts, with no
+ * branches or tables, so the compiler can vectorize the loops that call them. The errors below are the largest
+ * distance to the correctly rounded result, in ULP. tests/fast_math.cpp measures them over every float in the domain.
+ * Inputs outside the domain, NaN and infinities are not handled.
+ */
+namespace bul::fast
+{
+namespace detail
+{
+// Rounds to the nearest integer for |x| < 2^22, adding 1.5 * 2^23 pushes the fraction out of the mantissa
+inline float round(float x)
+{
+    constexpr float MAGIC = 12582912.0f;
+    return (x + MAGIC) - MAGIC;
+}
+
+// cond ? a : b with bit operations, a plain ternary between two floats can end up as a jump
+inline float select(bool cond, float a, float b)
+{
+    uint32_t mask = 0u - uint32_t(cond);
+    return std::bit_cast<float>((std::bit_cast<uint32_t>(a) & mask) | (std::bit_cast<uint32_t>(b) & ~mask));
+}
+
+// 2^n for n in [-126, 127]
+inline float exp2i(int32_t n)
+{
+    return std::bit_cast<float>(uint32_t(n + 127) << 23);
+}
+} // namespace detail
+
+// Max error 1.3 ULP. Domain: [-126, 127].
+inline float exp2(float x)
+{
+    float n = detail::round(x);
+    float f = x - n;
+    // Clamping the exponent rather than x keeps the loops branchless, float min and max can end up as jumps
+    int32_t e = std::min(std::max(int32_t(n), -126), 127);
+    // 2^f - 1 on [-0.5, 0.5]
+    float p = 1.537070350e-4f;
+    p = p * f + 1.339984831e-3f;
+    p = p * f + 9.618373256e-3f;
+    p = p * f + 5.550329035e-2f;
+    p = p * f + 2.402264846e-1f;
+    p = p * f + 6.931472056e-1f;
+    p = p * f;
+    return (p + 1.0f) * detail::exp2i(e);
+}
+
+// Max error 2.1 ULP. Domain: positive normal floats.
+inline float log2(float x)
+{
+    // x = m * 2^e with m in [sqrt(0.5), sqrt(2)) so that the result does not cancel out when e is -1
+    int32_t bits = std::bit_cast<int32_t>(x);
+    int32_t e = (bits - 0x3f3504f3) >> 23;
+    float t = std::bit_cast<float>(bits - (e << 23)) - 1.0f;
+    // log2(1 + t) / t on [sqrt(0.5) - 1, sqrt(2) - 1]
+    float p = 1.228072462e-1f;
+    p = p * t - 2.057065570e-1f;
+    p = p * t + 2.161188312e-1f;
+    p = p * t - 2.391947488e-1f;
+    p = p * t + 2.879017676e-1f;
+    p = p * t - 3.606921155e-1f;
+    p = p * t + 4.809107675e-1f;
+    p = p * t - 7.213474817e-1f;
+    p = p * t + 1.442695004f;
+    return p * t + float(e);
+}
+
+// exp2(y * log2(x)), the error of log2 grows with the exponent: max error 1.5 + 2 * |y * log2(x)| ULP. Domain: x
+// positive normal, y * log2(x) in the domain of exp2.
+inline float pow(float x, float y)
+{
+    return exp2(y * log2(x));
+}
+
+// Max error 3.2 ULP. Domain: positive normal floats.
+inline float rsqrt(float x)
+{
+    float y = std::bit_cast<float>(0x5f375a86 - (std::bit_cast<int32_t>(x) >> 1));
+    float half_x = 0.5f * x;
+    y = y * (1.5f - half_x * y * y);
+    y = y * (1.5f - half_x * y * y);
+    y = y * (1.5f - half_x * y * y);
+    return y;
+}
+
+// Max error 1.5 ULP for |x| <= pi. Further away the error of the range reduction makes results close to 0 lose
+// relative precision, the error stays under 8e-8 absolute. Domain: |x| <= 8192.
+inline void sincos(float x, float& s, float& c)
+{
+    // r = x - k * pi / 2 in [-pi / 4, pi / 4], pi / 2 is split in three so that the first products are exact
+    float k = detail::round(x * 0.636619772f);
+    float r = x - k * 1.5703125f;
+    r = r - k * 4.837512969970703125e-4f;
+    r = r - k * 7.54978995489188216e-8f;
+    float r2 = r * r;
+
+    float sin_r = -1.9515295891e-4f;
+    sin_r = sin_r * r2 + 8.3321608736e-3f;
+    sin_r = sin_r * r2 - 1.6666654611e-1f;
+    sin_r = sin_r * r2 * r + r;
+
+    float cos_r = 2.443315711809948e-5f;
+    cos_r = cos_r * r2 - 1.388731625493765e-3f;
+    cos_r = cos_r * r2 + 4.166664568298827e-2f;
+    cos_r = cos_r * r2 * r2 - 0.5f * r2 + 1.0f;
+
+    // Quadrant k rotates by k * 90 degrees: odd quadrants swap sin and cos, the sign bits come from bits 1 of k and k + 1
+    uint32_t quadrant = uint32_t(int32_t(k));
+    bool swap = (quadrant & 1) != 0;
+    float sin_q = swap ? cos_r : sin_r;
+    float cos_q = swap ? sin_r : cos_r;
+    s = std::bit_cast<float>(std::bit_cast<uint32_t>(sin_q) ^ ((quadrant & 2) << 30));
+    c = std::bit_cast<float>(std::bit_cast<uint32_t>(cos_q) ^ (((quadrant + 1) & 2) << 30));
+}
+
+inline float sin(float x)
+{
+    float s;
+    float c;
+    sincos(x, s, c);
+    return s;
+}
+
+inline float cos(float x)
+{
+    float s;
+    float c;
+    sincos(x, s, c);
+    return c;
+}
+
+// Max error 15 ULP, from pow. Domain: [0, 1].
+inline float srgb_to_linear(float x)
+{
+    float curve = pow((x + 0.055f) * (1.0f / 1.055f), 2.4f);
+    return detail::select(x <= 0.04045f, x * (1.0f / 12.92f), curve);
+}
+
+// Max error 8.5 ULP. Domain: [0, 1].
+inline float linear_to_srgb(float x)
+{
+    float curve = 1.055f * pow(x, 1.0f / 2.4f) - 0.055f;
+    return detail::select(x <= 0.0031308f, x * 12.92f, curve);
+}
+} // namespace bul::fast
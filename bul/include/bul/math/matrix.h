@@ -1,6 +1,7 @@
 #pragma once
 
 #include "bul/bul.h"
+#include "bul/math/simd.h"
 #include "bul/math/vector.h"
 
 #include <cstring>
@@ -111,7 +112,10 @@ inline mat4f operator-(const mat4f& a, const mat4f& b)
     return ret;
 }
 
-inline mat4f operator*(const mat4f& a, const mat4f& b)
+// Plain C++ versions of the kernels below, used when SIMD is not available and as a reference
+namespace scalar
+{
+inline mat4f mul(const mat4f& a, const mat4f& b)
 {
     mat4f res;
     res[0][0] = a[0][0] * b[0][0] + a[1][0] * b[0][1] + a[2][0] * b[0][2] + a[3][0] * b[0][3];
@@ -136,6 +140,146 @@ inline mat4f operator*(const mat4f& a, const mat4f& b)
     return res;
 }
 
+inline vec4f mul(const mat4f& a, const vec4f& v)
+{
+    vec4f ret;
+    ret.x = a[0][0] * v[0] + a[0][1] * v[1] + a[0][2] * v[2] + a[0][3] * v[3];
+    ret.y = a[1][0] * v[0] + a[1][1] * v[1] + a[1][2] * v[2] + a[1][3] * v[3];
+    ret.z = a[2][0] * v[0] + a[2][1] * v[1] + a[2][2] * v[2] + a[2][3] * v[3];
+    ret.w = a[3][0] * v[0] + a[3][1] * v[1] + a[3][2] * v[2] + a[3][3] * v[3];
+    return ret;
+}
+
+inline mat4f transpose(const mat4f& m)
+{
+    mat4f res;
+    for (size_t c = 0; c < 4; ++c)
+    {
+        for (size_t r = 0; r < 4; ++r)
+        {
+            res[c][r] = m[r][c];
+        }
+    }
+    return res;
+}
+
+inline void transform(const mat4f& m, const vec4f* vectors, vec4f* out, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        vec4f v = vectors[i];
+        out[i] = m[0] * v.x + m[1] * v.y + m[2] * v.z + m[3] * v.w;
+    }
+}
+
+inline void transform_points(const mat4f& m, const vec3f* points, vec3f* out, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        vec3f p = points[i];
+        vec4f res = m[0] * p.x + m[1] * p.y + m[2] * p.z + m[3];
+        out[i] = {res.x, res.y, res.z};
+    }
+}
+
+inline void transform_vectors(const mat4f& m, const vec3f* vectors, vec3f* out, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        vec3f v = vectors[i];
+        vec4f res = m[0] * v.x + m[1] * v.y + m[2] * v.z;
+        out[i] = {res.x, res.y, res.z};
+    }
+}
+
+inline mat4f inverse(const mat4f& m)
+{
+    mat4f inv;
+
+    inv[0][0] = m[1][1] * m[2][2] * m[3][3] - m[1][1] * m[2][3] * m[3][2] - m[2][1] * m[1][2] * m[3][3]
+        + m[2][1] * m[1][3] * m[3][2] + m[3][1] * m[1][2] * m[2][3] - m[3][1] * m[1][3] * m[2][2];
+
+    inv[1][0] = -m[1][0] * m[2][2] * m[3][3] + m[1][0] * m[2][3] * m[3][2] + m[2][0] * m[1][2] * m[3][3]
+        - m[2][0] * m[1][3] * m[3][2] - m[3][0] * m[1][2] * m[2][3] + m[3][0] * m[1][3] * m[2][2];
+
+    inv[2][0] = m[1][0] * m[2][1] * m[3][3] - m[1][0] * m[2][3] * m[3][1] - m[2][0] * m[1][1] * m[3][3]
+        + m[2][0] * m[1][3] * m[3][1] + m[3][0] * m[1][1] * m[2][3] - m[3][0] * m[1][3] * m[2][1];
+
+    inv[3][0] = -m[1][0] * m[2][1] * m[3][2] + m[1][0] * m[2][2] * m[3][1] + m[2][0] * m[1][1] * m[3][2]
+        - m[2][0] * m[1][2] * m[3][1] - m[3][0] * m[1][1] * m[2][2] + m[3][0] * m[1][2] * m[2][1];
+
+    inv[0][1] = -m[0][1] * m[2][2] * m[3][3] + m[0][1] * m[2][3] * m[3][2] + m[2][1] * m[0][2] * m[3][3]
+        - m[2][1] * m[0][3] * m[3][2] - m[3][1] * m[0][2] * m[2][3] + m[3][1] * m[0][3] * m[2][2];
+
+    inv[1][1] = m[0][0] * m[2][2] * m[3][3] - m[0][0] * m[2][3] * m[3][2] - m[2][0] * m[0][2] * m[3][3]
+        + m[2][0] * m[0][3] * m[3][2] + m[3][0] * m[0][2] * m[2][3] - m[3][0] * m[0][3] * m[2][2];
+
+    inv[2][1] = -m[0][0] * m[2][1] * m[3][3] + m[0][0] * m[2][3] * m[3][1] + m[2][0] * m[0][1] * m[3][3]
+        - m[2][0] * m[0][3] * m[3][1] - m[3][0] * m[0][1] * m[2][3] + m[3][0] * m[0][3] * m[2][1];
+
+    inv[3][1] = m[0][0] * m[2][1] * m[3][2] - m[0][0] * m[2][2] * m[3][1] - m[2][0] * m[0][1] * m[3][2]
+        + m[2][0] * m[0][2] * m[3][1] + m[3][0] * m[0][1] * m[2][2] - m[3][0] * m[0][2] * m[2][1];
+
+    inv[0][2] = m[0][1] * m[1][2] * m[3][3] - m[0][1] * m[1][3] * m[3][2] - m[1][1] * m[0][2] * m[3][3]
+        + m[1][1] * m[0][3] * m[3][2] + m[3][1] * m[0][2] * m[1][3] - m[3][1] * m[0][3] * m[1][2];
+
+    inv[1][2] = -m[0][0] * m[1][2] * m[3][3] + m[0][0] * m[1][3] * m[3][2] + m[1][0] * m[0][2] * m[3][3]
+        - m[1][0] * m[0][3] * m[3][2] - m[3][0] * m[0][2] * m[1][3] + m[3][0] * m[0][3] * m[1][2];
+
+    inv[2][2] = m[0][0] * m[1][1] * m[3][3] - m[0][0] * m[1][3] * m[3][1] - m[1][0] * m[0][1] * m[3][3]
+        + m[1][0] * m[0][3] * m[3][1] + m[3][0] * m[0][1] * m[1][3] - m[3][0] * m[0][3] * m[1][1];
+
+    inv[3][2] = -m[0][0] * m[1][1] * m[3][2] + m[0][0] * m[1][2] * m[3][1] + m[1][0] * m[0][1] * m[3][2]
+        - m[1][0] * m[0][2] * m[3][1] - m[3][0] * m[0][1] * m[1][2] + m[3][0] * m[0][2] * m[1][1];
+
+    inv[0][3] = -m[0][1] * m[1][2] * m[2][3] + m[0][1] * m[1][3] * m[2][2] + m[1][1] * m[0][2] * m[2][3]
+        - m[1][1] * m[0][3] * m[2][2] - m[2][1] * m[0][2] * m[1][3] + m[2][1] * m[0][3] * m[1][2];
+
+    inv[1][3] = m[0][0] * m[1][2] * m[2][3] - m[0][0] * m[1][3] * m[2][2] - m[1][0] * m[0][2] * m[2][3]
+        + m[1][0] * m[0][3] * m[2][2] + m[2][0] * m[0][2] * m[1][3] - m[2][0] * m[0][3] * m[1][2];
+
+    inv[2][3] = -m[0][0] * m[1][1] * m[2][3] + m[0][0] * m[1][3] * m[2][1] + m[1][0] * m[0][1] * m[2][3]
+        - m[1][0] * m[0][3] * m[2][1] - m[2][0] * m[0][1] * m[1][3] + m[2][0] * m[0][3] * m[1][1];
+
+    inv[3][3] = m[0][0] * m[1][1] * m[2][2] - m[0][0] * m[1][2] * m[2][1] - m[1][0] * m[0][1] * m[2][2]
+        + m[1][0] * m[0][2] * m[2][1] + m[2][0] * m[0][1] * m[1][2] - m[2][0] * m[0][2] * m[1][1];
+
+    float det = m[0][0] * inv[0][0] + m[0][1] * inv[1][0] + m[0][2] * inv[2][0] + m[0][3] * inv[3][0];
+
+    ASSERT(det != 0);
+
+    det = 1.0f / det;
+
+    for (size_t i = 0; i < 16; i++)
+        inv.data[i] *= det;
+
+    return inv;
+}
+} // namespace scalar
+
+inline mat4f operator*(const mat4f& a, const mat4f& b)
+{
+#if defined(BUL_MATH_SSE2)
+    // Every column of the result is a linear combination of the columns of a
+    __m128 a0 = _mm_loadu_ps(a[0].data());
+    __m128 a1 = _mm_loadu_ps(a[1].data());
+    __m128 a2 = _mm_loadu_ps(a[2].data());
+    __m128 a3 = _mm_loadu_ps(a[3].data());
+    mat4f res;
+    for (size_t c = 0; c < 4; ++c)
+    {
+        __m128 col = _mm_loadu_ps(b[c].data());
+        __m128 r = _mm_mul_ps(a0, simd::swizzle<0, 0, 0, 0>(col));
+        r = simd::madd(a1, simd::swizzle<1, 1, 1, 1>(col), r);
+        r = simd::madd(a2, simd::swizzle<2, 2, 2, 2>(col), r);
+        r = simd::madd(a3, simd::swizzle<3, 3, 3, 3>(col), r);
+        _mm_storeu_ps(res[c].data(), r);
+    }
+    return res;
+#else
+    return scalar::mul(a, b);
+#endif
+}
 inline mat4f operator*(const mat4f& a, float f)
 {
     mat4f ret = a;
@@ -143,16 +287,130 @@ inline mat4f operator*(const mat4f& a, float f)
     return ret;
 }
 
+// Multiplies v by the transpose of a, see transform for a * v
 inline vec4f operator*(const mat4f& a, const vec4f& v)
 {
+#if defined(BUL_MATH_SSE2)
+    __m128 r0 = _mm_loadu_ps(a[0].data());
+    __m128 r1 = _mm_loadu_ps(a[1].data());
+    __m128 r2 = _mm_loadu_ps(a[2].data());
+    __m128 r3 = _mm_loadu_ps(a[3].data());
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    __m128 vec = _mm_loadu_ps(v.data());
+    __m128 r = _mm_mul_ps(r0, simd::swizzle<0, 0, 0, 0>(vec));
+    r = simd::madd(r1, simd::swizzle<1, 1, 1, 1>(vec), r);
+    r = simd::madd(r2, simd::swizzle<2, 2, 2, 2>(vec), r);
+    r = simd::madd(r3, simd::swizzle<3, 3, 3, 3>(vec), r);
     vec4f ret;
-    ret.x = a[0][0] * v[0] + a[0][1] * v[1] + a[0][2] * v[2] + a[0][3] * v[3];
-    ret.y = a[1][0] * v[0] + a[1][1] * v[1] + a[1][2] * v[2] + a[1][3] * v[3];
-    ret.z = a[2][0] * v[0] + a[2][1] * v[1] + a[2][2] * v[2] + a[2][3] * v[3];
-    ret.w = a[3][0] * v[0] + a[3][1] * v[1] + a[3][2] * v[2] + a[3][3] * v[3];
+    _mm_storeu_ps(ret.data(), r);
     return ret;
+#else
+    return scalar::mul(a, v);
+#endif
 }
 
+inline mat4f transpose(const mat4f& m)
+{
+#if defined(BUL_MATH_SSE2)
+    __m128 c0 = _mm_loadu_ps(m[0].data());
+    __m128 c1 = _mm_loadu_ps(m[1].data());
+    __m128 c2 = _mm_loadu_ps(m[2].data());
+    __m128 c3 = _mm_loadu_ps(m[3].data());
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    mat4f res;
+    _mm_storeu_ps(res[0].data(), c0);
+    _mm_storeu_ps(res[1].data(), c1);
+    _mm_storeu_ps(res[2].data(), c2);
+    _mm_storeu_ps(res[3].data(), c3);
+    return res;
+#else
+    return scalar::transpose(m);
+#endif
+}
+
+// out[i] = m * vectors[i], in column vector convention like the shaders. out may be the same array as the input.
+inline void transform(const mat4f& m, const vec4f* vectors, vec4f* out, size_t count)
+{
+#if defined(BUL_MATH_SSE2)
+    __m128 c0 = _mm_loadu_ps(m[0].data());
+    __m128 c1 = _mm_loadu_ps(m[1].data());
+    __m128 c2 = _mm_loadu_ps(m[2].data());
+    __m128 c3 = _mm_loadu_ps(m[3].data());
+    size_t i = 0;
+#if defined(BUL_MATH_AVX)
+    // Two vectors at a time, the columns are repeated in both 128 bit lanes
+    __m256 c0x2 = _mm256_insertf128_ps(_mm256_castps128_ps256(c0), c0, 1);
+    __m256 c1x2 = _mm256_insertf128_ps(_mm256_castps128_ps256(c1), c1, 1);
+    __m256 c2x2 = _mm256_insertf128_ps(_mm256_castps128_ps256(c2), c2, 1);
+    __m256 c3x2 = _mm256_insertf128_ps(_mm256_castps128_ps256(c3), c3, 1);
+    for (; i + 2 <= count; i += 2)
+    {
+        __m256 v = _mm256_loadu_ps(vectors[i].data());
+        __m256 r = _mm256_mul_ps(c0x2, _mm256_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0)));
+#if defined(BUL_MATH_FMA)
+        r = _mm256_fmadd_ps(c1x2, _mm256_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1)), r);
+        r = _mm256_fmadd_ps(c2x2, _mm256_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2)), r);
+        r = _mm256_fmadd_ps(c3x2, _mm256_permute_ps(v, _MM_SHUFFLE(3, 3, 3, 3)), r);
+#else
+        r = _mm256_add_ps(r, _mm256_mul_ps(c1x2, _mm256_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1))));
+        r = _mm256_add_ps(r, _mm256_mul_ps(c2x2, _mm256_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2))));
+        r = _mm256_add_ps(r, _mm256_mul_ps(c3x2, _mm256_permute_ps(v, _MM_SHUFFLE(3, 3, 3, 3))));
+#endif
+        _mm256_storeu_ps(out[i].data(), r);
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        __m128 v = _mm_loadu_ps(vectors[i].data());
+        __m128 r = _mm_mul_ps(c0, simd::swizzle<0, 0, 0, 0>(v));
+        r = simd::madd(c1, simd::swizzle<1, 1, 1, 1>(v), r);
+        r = simd::madd(c2, simd::swizzle<2, 2, 2, 2>(v), r);
+        r = simd::madd(c3, simd::swizzle<3, 3, 3, 3>(v), r);
+        _mm_storeu_ps(out[i].data(), r);
+    }
+#else
+    scalar::transform(m, vectors, out, count);
+#endif
+}
+
+// Same as transform with w = 1, the last row of m is ignored
+inline void transform_points(const mat4f& m, const vec3f* points, vec3f* out, size_t count)
+{
+#if defined(BUL_MATH_SSE2)
+    __m128 c0 = _mm_loadu_ps(m[0].data());
+    __m128 c1 = _mm_loadu_ps(m[1].data());
+    __m128 c2 = _mm_loadu_ps(m[2].data());
+    __m128 c3 = _mm_loadu_ps(m[3].data());
+    for (size_t i = 0; i < count; ++i)
+    {
+        __m128 r = simd::madd(c0, _mm_set1_ps(points[i].x), c3);
+        r = simd::madd(c1, _mm_set1_ps(points[i].y), r);
+        r = simd::madd(c2, _mm_set1_ps(points[i].z), r);
+        simd::store3(out[i].data(), r);
+    }
+#else
+    scalar::transform_points(m, points, out, count);
+#endif
+}
+
+// Same as transform with w = 0, the translation and the last row of m are ignored
+inline void transform_vectors(const mat4f& m, const vec3f* vectors, vec3f* out, size_t count)
+{
+#if defined(BUL_MATH_SSE2)
+    __m128 c0 = _mm_loadu_ps(m[0].data());
+    __m128 c1 = _mm_loadu_ps(m[1].data());
+    __m128 c2 = _mm_loadu_ps(m[2].data());
+    for (size_t i = 0; i < count; ++i)
+    {
+        __m128 r = _mm_mul_ps(c0, _mm_set1_ps(vectors[i].x));
+        r = simd::madd(c1, _mm_set1_ps(vectors[i].y), r);
+        r = simd::madd(c2, _mm_set1_ps(vectors[i].z), r);
+        simd::store3(out[i].data(), r);
+    }
+#else
+    scalar::transform_vectors(m, vectors, out, count);
+#endif
+}
 inline mat4f translation(const vec3f& v)
 {
     // clang-format off
@@ -241,70 +499,89 @@ inline mat4f rotation(bul::vec4f quaternion)
     // clang-format on
 }
 
-inline mat4f inverse(const mat4f& m)
+#if defined(BUL_MATH_SSE2)
+namespace simd
 {
-    mat4f inv;
-
-    inv[0][0] = m[1][1] * m[2][2] * m[3][3] - m[1][1] * m[2][3] * m[3][2] - m[2][1] * m[1][2] * m[3][3]
-        + m[2][1] * m[1][3] * m[3][2] + m[3][1] * m[1][2] * m[2][3] - m[3][1] * m[1][3] * m[2][2];
-
-    inv[1][0] = -m[1][0] * m[2][2] * m[3][3] + m[1][0] * m[2][3] * m[3][2] + m[2][0] * m[1][2] * m[3][3]
-        - m[2][0] * m[1][3] * m[3][2] - m[3][0] * m[1][2] * m[2][3] + m[3][0] * m[1][3] * m[2][2];
-
-    inv[2][0] = m[1][0] * m[2][1] * m[3][3] - m[1][0] * m[2][3] * m[3][1] - m[2][0] * m[1][1] * m[3][3]
-        + m[2][0] * m[1][3] * m[3][1] + m[3][0] * m[1][1] * m[2][3] - m[3][0] * m[1][3] * m[2][1];
-
-    inv[3][0] = -m[1][0] * m[2][1] * m[3][2] + m[1][0] * m[2][2] * m[3][1] + m[2][0] * m[1][1] * m[3][2]
-        - m[2][0] * m[1][2] * m[3][1] - m[3][0] * m[1][1] * m[2][2] + m[3][0] * m[1][2] * m[2][1];
-
-    inv[0][1] = -m[0][1] * m[2][2] * m[3][3] + m[0][1] * m[2][3] * m[3][2] + m[2][1] * m[0][2] * m[3][3]
-        - m[2][1] * m[0][3] * m[3][2] - m[3][1] * m[0][2] * m[2][3] + m[3][1] * m[0][3] * m[2][2];
-
-    inv[1][1] = m[0][0] * m[2][2] * m[3][3] - m[0][0] * m[2][3] * m[3][2] - m[2][0] * m[0][2] * m[3][3]
-        + m[2][0] * m[0][3] * m[3][2] + m[3][0] * m[0][2] * m[2][3] - m[3][0] * m[0][3] * m[2][2];
-
-    inv[2][1] = -m[0][0] * m[2][1] * m[3][3] + m[0][0] * m[2][3] * m[3][1] + m[2][0] * m[0][1] * m[3][3]
-        - m[2][0] * m[0][3] * m[3][1] - m[3][0] * m[0][1] * m[2][3] + m[3][0] * m[0][3] * m[2][1];
-
-    inv[3][1] = m[0][0] * m[2][1] * m[3][2] - m[0][0] * m[2][2] * m[3][1] - m[2][0] * m[0][1] * m[3][2]
-        + m[2][0] * m[0][2] * m[3][1] + m[3][0] * m[0][1] * m[2][2] - m[3][0] * m[0][2] * m[2][1];
-
-    inv[0][2] = m[0][1] * m[1][2] * m[3][3] - m[0][1] * m[1][3] * m[3][2] - m[1][1] * m[0][2] * m[3][3]
-        + m[1][1] * m[0][3] * m[3][2] + m[3][1] * m[0][2] * m[1][3] - m[3][1] * m[0][3] * m[1][2];
-
-    inv[1][2] = -m[0][0] * m[1][2] * m[3][3] + m[0][0] * m[1][3] * m[3][2] + m[1][0] * m[0][2] * m[3][3]
-        - m[1][0] * m[0][3] * m[3][2] - m[3][0] * m[0][2] * m[1][3] + m[3][0] * m[0][3] * m[1][2];
-
-    inv[2][2] = m[0][0] * m[1][1] * m[3][3] - m[0][0] * m[1][3] * m[3][1] - m[1][0] * m[0][1] * m[3][3]
-        + m[1][0] * m[0][3] * m[3][1] + m[3][0] * m[0][1] * m[1][3] - m[3][0] * m[0][3] * m[1][1];
-
-    inv[3][2] = -m[0][0] * m[1][1] * m[3][2] + m[0][0] * m[1][2] * m[3][1] + m[1][0] * m[0][1] * m[3][2]
-        - m[1][0] * m[0][2] * m[3][1] - m[3][0] * m[0][1] * m[1][2] + m[3][0] * m[0][2] * m[1][1];
-
-    inv[0][3] = -m[0][1] * m[1][2] * m[2][3] + m[0][1] * m[1][3] * m[2][2] + m[1][1] * m[0][2] * m[2][3]
-        - m[1][1] * m[0][3] * m[2][2] - m[2][1] * m[0][2] * m[1][3] + m[2][1] * m[0][3] * m[1][2];
-
-    inv[1][3] = m[0][0] * m[1][2] * m[2][3] - m[0][0] * m[1][3] * m[2][2] - m[1][0] * m[0][2] * m[2][3]
-        + m[1][0] * m[0][3] * m[2][2] + m[2][0] * m[0][2] * m[1][3] - m[2][0] * m[0][3] * m[1][2];
-
-    inv[2][3] = -m[0][0] * m[1][1] * m[2][3] + m[0][0] * m[1][3] * m[2][1] + m[1][0] * m[0][1] * m[2][3]
-        - m[1][0] * m[0][3] * m[2][1] - m[2][0] * m[0][1] * m[1][3] + m[2][0] * m[0][3] * m[1][1];
-
-    inv[3][3] = m[0][0] * m[1][1] * m[2][2] - m[0][0] * m[1][2] * m[2][1] - m[1][0] * m[0][1] * m[2][2]
-        + m[1][0] * m[0][2] * m[2][1] + m[2][0] * m[0][1] * m[1][2] - m[2][0] * m[0][2] * m[1][1];
-
-    float det = m[0][0] * inv[0][0] + m[0][1] * inv[1][0] + m[0][2] * inv[2][0] + m[0][3] * inv[3][0];
+// 2x2 matrices packed as (m00, m01, m10, m11), # is the adjugate
+// a * b
+inline __m128 mat2_mul(__m128 a, __m128 b)
+{
+    return madd(a, swizzle<0, 3, 0, 3>(b), _mm_mul_ps(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+}
 
-    ASSERT(det != 0);
+// a# * b
+inline __m128 mat2_adj_mul(__m128 a, __m128 b)
+{
+    return _mm_sub_ps(_mm_mul_ps(swizzle<3, 3, 0, 0>(a), b),
+                      _mm_mul_ps(swizzle<1, 1, 2, 2>(a), swizzle<2, 3, 0, 1>(b)));
+}
 
-    det = 1.0f / det;
+// a * b#
+inline __m128 mat2_mul_adj(__m128 a, __m128 b)
+{
+    return _mm_sub_ps(_mm_mul_ps(a, swizzle<3, 0, 3, 0>(b)), _mm_mul_ps(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+}
+} // namespace simd
+#endif
 
-    for (size_t i = 0; i < 16; i++)
-        inv.data[i] *= det;
+inline mat4f inverse(const mat4f& m)
+{
+#if defined(BUL_MATH_SSE2)
+    // Blockwise inversion with 2x2 sub matrices, M = |A B| and M^-1 = 1/|M| * |X# Y#|#
+    //                                                |C D|                     |Z# W# |
+    // It is written for rows but works the same on columns since inverse(transpose(M)) = transpose(inverse(M)).
+    __m128 c0 = _mm_loadu_ps(m[0].data());
+    __m128 c1 = _mm_loadu_ps(m[1].data());
+    __m128 c2 = _mm_loadu_ps(m[2].data());
+    __m128 c3 = _mm_loadu_ps(m[3].data());
+    __m128 A = _mm_movelh_ps(c0, c1);
+    __m128 B = _mm_movehl_ps(c1, c0);
+    __m128 C = _mm_movelh_ps(c2, c3);
+    __m128 D = _mm_movehl_ps(c3, c2);
+
+    // (|A|, |B|, |C|, |D|)
+    __m128 det_sub = _mm_sub_ps(_mm_mul_ps(simd::shuffle<0, 2, 0, 2>(c0, c2), simd::shuffle<1, 3, 1, 3>(c1, c3)),
+                                _mm_mul_ps(simd::shuffle<1, 3, 1, 3>(c0, c2), simd::shuffle<0, 2, 0, 2>(c1, c3)));
+    __m128 det_a = simd::swizzle<0, 0, 0, 0>(det_sub);
+    __m128 det_b = simd::swizzle<1, 1, 1, 1>(det_sub);
+    __m128 det_c = simd::swizzle<2, 2, 2, 2>(det_sub);
+    __m128 det_d = simd::swizzle<3, 3, 3, 3>(det_sub);
+
+    __m128 d_c = simd::mat2_adj_mul(D, C);
+    __m128 a_b = simd::mat2_adj_mul(A, B);
+    // X# = |D|A - B(D#C)
+    __m128 x = _mm_sub_ps(_mm_mul_ps(det_d, A), simd::mat2_mul(B, d_c));
+    // W# = |A|D - C(A#B)
+    __m128 w = _mm_sub_ps(_mm_mul_ps(det_a, D), simd::mat2_mul(C, a_b));
+    // Y# = |B|C - D(A#B)#
+    __m128 y = _mm_sub_ps(_mm_mul_ps(det_b, C), simd::mat2_mul_adj(D, a_b));
+    // Z# = |C|B - A(D#C)#
+    __m128 z = _mm_sub_ps(_mm_mul_ps(det_c, B), simd::mat2_mul_adj(A, d_c));
+
+    // |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+    __m128 tr = _mm_mul_ps(a_b, simd::swizzle<0, 2, 1, 3>(d_c));
+    tr = _mm_add_ps(tr, simd::swizzle<2, 3, 0, 1>(tr));
+    tr = _mm_add_ps(tr, simd::swizzle<1, 0, 3, 2>(tr));
+    __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c)), tr);
+    ASSERT(_mm_cvtss_f32(det) != 0);
+
+    // The signs of the adjugate come with the division
+    __m128 rcp_det = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+    x = _mm_mul_ps(x, rcp_det);
+    y = _mm_mul_ps(y, rcp_det);
+    z = _mm_mul_ps(z, rcp_det);
+    w = _mm_mul_ps(w, rcp_det);
 
+    mat4f inv;
+    _mm_storeu_ps(inv[0].data(), simd::shuffle<3, 1, 3, 1>(x, y));
+    _mm_storeu_ps(inv[1].data(), simd::shuffle<2, 0, 2, 0>(x, y));
+    _mm_storeu_ps(inv[2].data(), simd::shuffle<3, 1, 3, 1>(z, w));
+    _mm_storeu_ps(inv[3].data(), simd::shuffle<2, 0, 2, 0>(z, w));
     return inv;
+#else
+    return scalar::inverse(m);
+#endif
 }
-
 inline mat4f lookat(bul::vec3f pos, bul::vec3f target, bul::vec3f up, mat4f* inv = nullptr)
 {
     vec3f z = normalize(target - pos);
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "bul/bul.h"
+
+/*
+ * Instruction sets the math kernels are compiled for. SSE2 is always there on x64, AVX, AVX2 and FMA are only used
+ * when the compiler targets them (-mavx2 -mfma, /arch:AVX2). Defining BUL_MATH_NO_SIMD falls back to the scalar code.
+ */
+#if !defined(BUL_MATH_NO_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BUL_MATH_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(BUL_MATH_SSE2) && defined(__AVX__)
+#define BUL_MATH_AVX
+#include <immintrin.h>
+#endif
+
+#if defined(BUL_MATH_AVX) && defined(__AVX2__)
+#define BUL_MATH_AVX2
+#endif
+
+// MSVC has no macro for FMA, it comes with /arch:AVX2
+#if defined(BUL_MATH_AVX) && (defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__)))
+#define BUL_MATH_FMA
+#endif
+#endif
+
+#if defined(BUL_MATH_SSE2)
+namespace bul::simd
+{
+template <int X, int Y, int Z, int W>
+inline __m128 swizzle(__m128 v)
+{
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(W, Z, Y, X));
+}
+
+// X and Y come from a, Z and W from b
+template <int X, int Y, int Z, int W>
+inline __m128 shuffle(__m128 a, __m128 b)
+{
+    return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+}
+
+// a * b + c
+inline __m128 madd(__m128 a, __m128 b, __m128 c)
+{
+#if defined(BUL_MATH_FMA)
+    return _mm_fmadd_ps(a, b, c);
+#else
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+
+inline __m128 abs(__m128 v)
+{
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+}
+
+// Only writes x, y and z so that whatever follows in memory is left alone
+inline void store3(float* dst, __m128 v)
+{
+    _mm_storel_pi((__m64*)dst, v);
+    _mm_store_ss(dst + 2, _mm_movehl_ps(v, v));
+}
+} // namespace bul::simd
+#endif
@@ -0,0 +1,718 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include "bul/bul.h"
+#include "bul/math/simd.h"
+#include "bul/math/vector.h"
+
+/*
+ * Structure of arrays types for batches of rays, bounds or vertices. floatx4 and floatx8 hold 4 and 8 floats, vec3x4
+ * and vec3x8 hold as many vec3f with one register per component so that every operation works on all of them at once.
+ * floatx4 uses SSE2 and floatx8 uses AVX, or two floatx4 when AVX is not available.
+ * Comparisons return masks with all bits set in the lanes where they are true, for select, any, all and mask_bits.
+ */
+namespace bul
+{
+struct floatx4
+{
+    static constexpr size_t WIDTH = 4;
+
+#if defined(BUL_MATH_SSE2)
+    __m128 v = _mm_setzero_ps();
+
+    floatx4() = default;
+
+    explicit floatx4(float f)
+        : v(_mm_set1_ps(f))
+    {}
+
+    floatx4(__m128 v_)
+        : v(v_)
+    {}
+
+    static floatx4 load(const float* src)
+    {
+        return _mm_loadu_ps(src);
+    }
+
+    void store(float* dst) const
+    {
+        _mm_storeu_ps(dst, v);
+    }
+#else
+    float v[WIDTH] = {};
+
+    floatx4() = default;
+
+    explicit floatx4(float f)
+        : v{f, f, f, f}
+    {}
+
+    static floatx4 load(const float* src)
+    {
+        floatx4 res;
+        std::copy_n(src, WIDTH, res.v);
+        return res;
+    }
+
+    void store(float* dst) const
+    {
+        std::copy_n(v, WIDTH, dst);
+    }
+#endif
+
+    float operator[](size_t i) const
+    {
+        ASSERT(i < WIDTH);
+        float lanes[WIDTH];
+        store(lanes);
+        return lanes[i];
+    }
+};
+
+#if defined(BUL_MATH_SSE2)
+inline floatx4 operator+(floatx4 a, floatx4 b)
+{
+    return _mm_add_ps(a.v, b.v);
+}
+
+inline floatx4 operator-(floatx4 a, floatx4 b)
+{
+    return _mm_sub_ps(a.v, b.v);
+}
+
+inline floatx4 operator*(floatx4 a, floatx4 b)
+{
+    return _mm_mul_ps(a.v, b.v);
+}
+
+inline floatx4 operator/(floatx4 a, floatx4 b)
+{
+    return _mm_div_ps(a.v, b.v);
+}
+
+inline floatx4 operator-(floatx4 a)
+{
+    return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f));
+}
+
+inline floatx4 operator<(floatx4 a, floatx4 b)
+{
+    return _mm_cmplt_ps(a.v, b.v);
+}
+
+inline floatx4 operator<=(floatx4 a, floatx4 b)
+{
+    return _mm_cmple_ps(a.v, b.v);
+}
+
+inline floatx4 operator>(floatx4 a, floatx4 b)
+{
+    return _mm_cmpgt_ps(a.v, b.v);
+}
+
+inline floatx4 operator>=(floatx4 a, floatx4 b)
+{
+    return _mm_cmpge_ps(a.v, b.v);
+}
+
+inline floatx4 operator&(floatx4 a, floatx4 b)
+{
+    return _mm_and_ps(a.v, b.v);
+}
+
+inline floatx4 operator|(floatx4 a, floatx4 b)
+{
+    return _mm_or_ps(a.v, b.v);
+}
+
+inline floatx4 min(floatx4 a, floatx4 b)
+{
+    return _mm_min_ps(a.v, b.v);
+}
+
+inline floatx4 max(floatx4 a, floatx4 b)
+{
+    return _mm_max_ps(a.v, b.v);
+}
+
+inline floatx4 sqrt(floatx4 a)
+{
+    return _mm_sqrt_ps(a.v);
+}
+
+inline floatx4 abs(floatx4 a)
+{
+    return simd::abs(a.v);
+}
+
+// a * b + c
+inline floatx4 fmadd(floatx4 a, floatx4 b, floatx4 c)
+{
+    return simd::madd(a.v, b.v, c.v);
+}
+
+// mask ? a : b
+inline floatx4 select(floatx4 mask, floatx4 a, floatx4 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v));
+}
+
+// Bit i is set when lane i of the mask is
+inline uint32_t mask_bits(floatx4 mask)
+{
+    return uint32_t(_mm_movemask_ps(mask.v));
+}
+#else
+namespace detail
+{
+template <typename Op>
+floatx4 per_lane(floatx4 a, floatx4 b, Op op)
+{
+    floatx4 res;
+    for (size_t i = 0; i < floatx4::WIDTH; ++i)
+    {
+        res.v[i] = op(a.v[i], b.v[i]);
+    }
+    return res;
+}
+
+inline float lane_mask(bool b)
+{
+    return std::bit_cast<float>(b ? 0xFFFFFFFFu : 0u);
+}
+} // namespace detail
+
+inline floatx4 operator+(floatx4 a, floatx4 b)
+{
+    return detail::per_lane(a, b, [](float x, float y) { return x + y; });
+}
+
+inline floatx4 operator-(floatx4 a, floatx4 b)
+{
+    return detail::per_lane(a, b, [](float x, float y) { return x - y; });
+}
+
+inline floatx4 operator*(floatx4 a, floatx4 b)
+{
+    return detail::per_lane(a, b, [](float x, float y) { return x * y; });
+}
+
+inline floatx4 operator/(floatx4 a, floatx4 b)
+{
+    return detail::per_lane(a, b, [](float x, float y) { return x / y; });
+}
+
+inline floatx4 operator-(floatx4 a)
+{
+    return detail::per_lane(a, a, [](float x, float) { return -x; });
+}
+
+inline floatx4 operator<(floatx4 a, floatx4 b)
+{
+    return detail::per_lane(a, b, [](float x, float y) { return detail::lane_mask(x < y); });
+}
+
+inline floatx4 operator<=(floatx4 a, floatx4 b)
+{
+    return detail::per_lane(a, b, [](float x, float y) { return detail::lane_mask(x <= y); });
+}
+
+inline floatx4 operator>(floatx4 a, floatx4 b)
+{
+    return detail::per_lane(a, b, [](float x, float y) { return detail::lane_mask(x > y); });
+}
+
+inline floatx4 operator>=(floatx4 a, floatx4 b)
+{
+    return detail::per_lane(a, b, [](float x, float y) { return detail::lane_mask(x >= y); });
+}
+
+inline floatx4 operator&(floatx4 a, floatx4 b)
+{
+    return detail::per_lane(a, b, [](float x, float y) {
+        return std::bit_cast<float>(std::bit_cast<uint32_t>(x) & std::bit_cast<uint32_t>(y));
+    });
+}
+
+inline floatx4 operator|(floatx4 a, floatx4 b)
+{
+    return detail::per_lane(a, b, [](float x, float y) {
+        return std::bit_cast<float>(std::bit_cast<uint32_t>(x) | std::bit_cast<uint32_t>(y));
+    });
+}
+
+// Same NaN handling as SSE: b is returned when the comparison is false
+inline floatx4 min(floatx4 a, floatx4 b)
+{
+    return detail::per_lane(a, b, [](float x, float y) { return x < y ? x : y; });
+}
+
+inline floatx4 max(floatx4 a, floatx4 b)
+{
+    return detail::per_lane(a, b, [](float x, float y) { return x > y ? x : y; });
+}
+
+inline floatx4 sqrt(floatx4 a)
+{
+    return detail::per_lane(a, a, [](float x, float) { return std::sqrt(x); });
+}
+
+inline floatx4 abs(floatx4 a)
+{
+    return detail::per_lane(a, a, [](float x, float) { return std::abs(x); });
+}
+
+// a * b + c
+inline floatx4 fmadd(floatx4 a, floatx4 b, floatx4 c)
+{
+    return a * b + c;
+}
+
+// mask ? a : b
+inline floatx4 select(floatx4 mask, floatx4 a, floatx4 b)
+{
+    return (mask & a) | detail::per_lane(mask, b, [](float m, float y) {
+               return std::bit_cast<float>(~std::bit_cast<uint32_t>(m) & std::bit_cast<uint32_t>(y));
+           });
+}
+
+// Bit i is set when lane i of the mask is
+inline uint32_t mask_bits(floatx4 mask)
+{
+    uint32_t bits = 0;
+    for (size_t i = 0; i < floatx4::WIDTH; ++i)
+    {
+        bits |= (std::bit_cast<uint32_t>(mask.v[i]) >> 31) << i;
+    }
+    return bits;
+}
+#endif
+
+struct floatx8
+{
+    static constexpr size_t WIDTH = 8;
+
+#if defined(BUL_MATH_AVX)
+    __m256 v = _mm256_setzero_ps();
+
+    floatx8() = default;
+
+    explicit floatx8(float f)
+        : v(_mm256_set1_ps(f))
+    {}
+
+    floatx8(__m256 v_)
+        : v(v_)
+    {}
+
+    static floatx8 load(const float* src)
+    {
+        return _mm256_loadu_ps(src);
+    }
+
+    void store(float* dst) const
+    {
+        _mm256_storeu_ps(dst, v);
+    }
+#else
+    floatx4 lo;
+    floatx4 hi;
+
+    floatx8() = default;
+
+    explicit floatx8(float f)
+        : lo(f)
+        , hi(f)
+    {}
+
+    floatx8(floatx4 lo_, floatx4 hi_)
+        : lo(lo_)
+        , hi(hi_)
+    {}
+
+    static floatx8 load(const float* src)
+    {
+        return {floatx4::load(src), floatx4::load(src + floatx4::WIDTH)};
+    }
+
+    void store(float* dst) const
+    {
+        lo.store(dst);
+        hi.store(dst + floatx4::WIDTH);
+    }
+#endif
+
+    float operator[](size_t i) const
+    {
+        ASSERT(i < WIDTH);
+        float lanes[WIDTH];
+        store(lanes);
+        return lanes[i];
+    }
+};
+
+#if defined(BUL_MATH_AVX)
+inline floatx8 operator+(floatx8 a, floatx8 b)
+{
+    return _mm256_add_ps(a.v, b.v);
+}
+
+inline floatx8 operator-(floatx8 a, floatx8 b)
+{
+    return _mm256_sub_ps(a.v, b.v);
+}
+
+inline floatx8 operator*(floatx8 a, floatx8 b)
+{
+    return _mm256_mul_ps(a.v, b.v);
+}
+
+inline floatx8 operator/(floatx8 a, floatx8 b)
+{
+    return _mm256_div_ps(a.v, b.v);
+}
+
+inline floatx8 operator-(floatx8 a)
+{
+    return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f));
+}
+
+inline floatx8 operator<(floatx8 a, floatx8 b)
+{
+    return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ);
+}
+
+inline floatx8 operator<=(floatx8 a, floatx8 b)
+{
+    return _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ);
+}
+
+inline floatx8 operator>(floatx8 a, floatx8 b)
+{
+    return _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ);
+}
+
+inline floatx8 operator>=(floatx8 a, floatx8 b)
+{
+    return _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ);
+}
+
+inline floatx8 operator&(floatx8 a, floatx8 b)
+{
+    return _mm256_and_ps(a.v, b.v);
+}
+
+inline floatx8 operator|(floatx8 a, floatx8 b)
+{
+    return _mm256_or_ps(a.v, b.v);
+}
+
+inline floatx8 min(floatx8 a, floatx8 b)
+{
+    return _mm256_min_ps(a.v, b.v);
+}
+
+inline floatx8 max(floatx8 a, floatx8 b)
+{
+    return _mm256_max_ps(a.v, b.v);
+}
+
+inline floatx8 sqrt(floatx8 a)
+{
+    return _mm256_sqrt_ps(a.v);
+}
+
+inline floatx8 abs(floatx8 a)
+{
+    return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v);
+}
+
+// a * b + c
+inline floatx8 fmadd(floatx8 a, floatx8 b, floatx8 c)
+{
+#if defined(BUL_MATH_FMA)
+    return _mm256_fmadd_ps(a.v, b.v, c.v);
+#else
+    return _mm256_add_ps(_mm256_mul_ps(a.v, b.v), c.v);
+#endif
+}
+
+// mask ? a : b
+inline floatx8 select(floatx8 mask, floatx8 a, floatx8 b)
+{
+    return _mm256_blendv_ps(b.v, a.v, mask.v);
+}
+
+// Bit i is set when lane i of the mask is
+inline uint32_t mask_bits(floatx8 mask)
+{
+    return uint32_t(_mm256_movemask_ps(mask.v));
+}
+#else
+inline floatx8 operator+(floatx8 a, floatx8 b)
+{
+    return {a.lo + b.lo, a.hi + b.hi};
+}
+
+inline floatx8 operator-(floatx8 a, floatx8 b)
+{
+    return {a.lo - b.lo, a.hi - b.hi};
+}
+
+inline floatx8 operator*(floatx8 a, floatx8 b)
+{
+    return {a.lo * b.lo, a.hi * b.hi};
+}
+
+inline floatx8 operator/(floatx8 a, floatx8 b)
+{
+    return {a.lo / b.lo, a.hi / b.hi};
+}
+
+inline floatx8 operator-(floatx8 a)
+{
+    return {-a.lo, -a.hi};
+}
+
+inline floatx8 operator<(floatx8 a, floatx8 b)
+{
+    return {a.lo < b.lo, a.hi < b.hi};
+}
+
+inline floatx8 operator<=(floatx8 a, floatx8 b)
+{
+    return {a.lo <= b.lo, a.hi <= b.hi};
+}
+
+inline floatx8 operator>(floatx8 a, floatx8 b)
+{
+    return {a.lo > b.lo, a.hi > b.hi};
+}
+
+inline floatx8 operator>=(floatx8 a, floatx8 b)
+{
+    return {a.lo >= b.lo, a.hi >= b.hi};
+}
+
+inline floatx8 operator&(floatx8 a, floatx8 b)
+{
+    return {a.lo & b.lo, a.hi & b.hi};
+}
+
+inline floatx8 operator|(floatx8 a, floatx8 b)
+{
+    return {a.lo | b.lo, a.hi | b.hi};
+}
+
+inline floatx8 min(floatx8 a, floatx8 b)
+{
+    return {min(a.lo, b.lo), min(a.hi, b.hi)};
+}
+
+inline floatx8 max(floatx8 a, floatx8 b)
+{
+    return {max(a.lo, b.lo), max(a.hi, b.hi)};
+}
+
+inline floatx8 sqrt(floatx8 a)
+{
+    return {sqrt(a.lo), sqrt(a.hi)};
+}
+
+inline floatx8 abs(floatx8 a)
+{
+    return {abs(a.lo), abs(a.hi)};
+}
+
+// a * b + c
+inline floatx8 fmadd(floatx8 a, floatx8 b, floatx8 c)
+{
+    return {fmadd(a.lo, b.lo, c.lo), fmadd(a.hi, b.hi, c.hi)};
+}
+
+// mask ? a : b
+inline floatx8 select(floatx8 mask, floatx8 a, floatx8 b)
+{
+    return {select(mask.lo, a.lo, b.lo), select(mask.hi, a.hi, b.hi)};
+}
+
+// Bit i is set when lane i of the mask is
+inline uint32_t mask_bits(floatx8 mask)
+{
+    return mask_bits(mask.lo) | (mask_bits(mask.hi) << floatx4::WIDTH);
+}
+#endif
+
+template <typename F>
+bool any(F mask)
+{
+    return mask_bits(mask) != 0;
+}
+
+template <typename F>
+bool all(F mask)
+{
+    return mask_bits(mask) == (1u << F::WIDTH) - 1;
+}
+
+template <typename F>
+struct vec3w
+{
+    static constexpr size_t WIDTH = F::WIDTH;
+
+    F x;
+    F y;
+    F z;
+
+    vec3w() = default;
+
+    // Same vector in every lane
+    explicit vec3w(const vec3f& v)
+        : x(v.x)
+        , y(v.y)
+        , z(v.z)
+    {}
+
+    vec3w(F x_, F y_, F z_)
+        : x(x_)
+        , y(y_)
+        , z(z_)
+    {}
+
+    // Reads WIDTH vectors
+    static vec3w load(const vec3f* src)
+    {
+        float xs[WIDTH];
+        float ys[WIDTH];
+        float zs[WIDTH];
+        for (size_t i = 0; i < WIDTH; ++i)
+        {
+            xs[i] = src[i].x;
+            ys[i] = src[i].y;
+            zs[i] = src[i].z;
+        }
+        return {F::load(xs), F::load(ys), F::load(zs)};
+    }
+
+    // Writes WIDTH vectors
+    void store(vec3f* dst) const
+    {
+        float xs[WIDTH];
+        float ys[WIDTH];
+        float zs[WIDTH];
+        x.store(xs);
+        y.store(ys);
+        z.store(zs);
+        for (size_t i = 0; i < WIDTH; ++i)
+        {
+            dst[i] = {xs[i], ys[i], zs[i]};
+        }
+    }
+
+    vec3f operator[](size_t i) const
+    {
+        return {x[i], y[i], z[i]};
+    }
+};
+
+using vec3x4 = vec3w<floatx4>;
+using vec3x8 = vec3w<floatx8>;
+
+template <typename F>
+vec3w<F> operator+(const vec3w<F>& a, const vec3w<F>& b)
+{
+    return {a.x + b.x, a.y + b.y, a.z + b.z};
+}
+
+template <typename F>
+vec3w<F> operator-(const vec3w<F>& a, const vec3w<F>& b)
+{
+    return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+template <typename F>
+vec3w<F> operator*(const vec3w<F>& a, const vec3w<F>& b)
+{
+    return {a.x * b.x, a.y * b.y, a.z * b.z};
+}
+
+template <typename F>
+vec3w<F> operator/(const vec3w<F>& a, const vec3w<F>& b)
+{
+    return {a.x / b.x, a.y / b.y, a.z / b.z};
+}
+
+template <typename F>
+vec3w<F> operator*(const vec3w<F>& v, F f)
+{
+    return {v.x * f, v.y * f, v.z * f};
+}
+
+template <typename F>
+vec3w<F> operator-(const vec3w<F>& v)
+{
+    return {-v.x, -v.y, -v.z};
+}
+
+template <typename F>
+F dot(const vec3w<F>& a, const vec3w<F>& b)
+{
+    return fmadd(a.x, b.x, fmadd(a.y, b.y, a.z * b.z));
+}
+
+// Same formula as cross(vec3f, vec3f)
+template <typename F>
+vec3w<F> cross(const vec3w<F>& a, const vec3w<F>& b)
+{
+    return {a.y * b.z - b.y * a.z, a.z * b.x - b.z * a.x, a.x * b.y - b.x * a.y};
+}
+
+template <typename F>
+vec3w<F> min(const vec3w<F>& a, const vec3w<F>& b)
+{
+    return {min(a.x, b.x), min(a.y, b.y), min(a.z, b.z)};
+}
+
+template <typename F>
+vec3w<F> max(const vec3w<F>& a, const vec3w<F>& b)
+{
+    return {max(a.x, b.x), max(a.y, b.y), max(a.z, b.z)};
+}
+
+// a * b + c
+template <typename F>
+vec3w<F> fmadd(const vec3w<F>& a, const vec3w<F>& b, const vec3w<F>& c)
+{
+    return {fmadd(a.x, b.x, c.x), fmadd(a.y, b.y, c.y), fmadd(a.z, b.z, c.z)};
+}
+
+// a * f + c, e.g. origin + direction * t
+template <typename F>
+vec3w<F> fmadd(const vec3w<F>& a, F f, const vec3w<F>& c)
+{
+    return {fmadd(a.x, f, c.x), fmadd(a.y, f, c.y), fmadd(a.z, f, c.z)};
+}
+
+// One mask for all three components, mask ? a : b
+template <typename F>
+vec3w<F> select(F mask, const vec3w<F>& a, const vec3w<F>& b)
+{
+    return {select(mask, a.x, b.x), select(mask, a.y, b.y), select(mask, a.z, b.z)};
+}
+
+template <typename F>
+F length(const vec3w<F>& v)
+{
+    return sqrt(dot(v, v));
+}
+
+template <typename F>
+vec3w<F> normalize(const vec3w<F>& v)
+{
+    return v * (F(1.0f) / length(v));
+}
+} // namespace bul
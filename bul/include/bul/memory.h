@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "bul/bul.h"
+
+/*
+ * Allocation tracking by tag. Every thread has a current tag, set with memory::Scope, and jobs run with the tag of the
+ * thread that submitted them. Allocations through memory::allocate carry their tag in a header so that they are
+ * counted against it when freed, from any thread. With BUL_TRACK_ALLOCATIONS (the CMake option of the same name) the
+ * global operator new and delete go through them too, otherwise only the explicit allocations, the bul containers,
+ * and what is reported with memory::track are counted.
+ */
+namespace bul::memory
+{
+enum class Tag : uint8_t
+{
+    Untagged,
+    // Storage of the bul containers when the thread has no tag
+    Containers,
+    Loaders,
+    VulkanBuffers,
+    VulkanImages,
+    VulkanStaging,
+    Count,
+};
+
+const char* tag_name(Tag tag);
+
+namespace detail
+{
+inline thread_local Tag current_tag = Tag::Untagged;
+} // namespace detail
+
+inline Tag current_tag()
+{
+    return detail::current_tag;
+}
+
+// The current tag, or fallback when the thread has none
+inline Tag tag_or(Tag fallback)
+{
+    return detail::current_tag != Tag::Untagged ? detail::current_tag : fallback;
+}
+
+// Sets the tag of the thread until the end of the scope
+class Scope
+{
+public:
+    explicit Scope(Tag tag) : previous_(detail::current_tag)
+    {
+        detail::current_tag = tag;
+    }
+
+    ~Scope()
+    {
+        detail::current_tag = previous_;
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    Tag previous_;
+};
+
+// nullptr when out of memory. Alignments above 16 bytes cost as much padding.
+void* allocate(size_t size, size_t alignment, Tag tag);
+// Only for allocations with the default alignment, they keep their tag
+void* reallocate(void* ptr, size_t size);
+void deallocate(void* ptr);
+
+// Memory not allocated by bul, like the allocations of the GPU allocator. Untracking has to use the same tag and size.
+void track(Tag tag, size_t size);
+void untrack(Tag tag, size_t size);
+
+struct Stats
+{
+    int64_t live_bytes = 0;
+    int64_t peak_bytes = 0;
+    int64_t live_count = 0;
+    uint64_t allocations = 0;
+    // Allocations during the last frame, between the last two calls to frame
+    uint64_t frame_allocations = 0;
+};
+
+Stats stats(Tag tag);
+// Sum of the tags, the peak is the sum of the peaks
+Stats total_stats();
+
+// Ends the allocation count of the current frame, from a single thread
+void frame();
+
+// One line per tag
+void report(FILE* file = stdout);
+} // namespace bul::memory
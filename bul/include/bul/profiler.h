@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bul/bul.h"
+
+/*
+ * Hierarchical CPU profiler. A scope records its name, begin and end in a ring owned by the calling thread, and
+ * profiler::frame collects the rings of every thread once per frame. Names are not copied, they have to be string
+ * literals. The macros compile to nothing unless BUL_PROFILE is defined (the BUL_PROFILE CMake option).
+ */
+#if defined(BUL_PROFILE)
+#define PROFILE_SCOPE(NAME)          bul::profiler::Scope BUL_CONCAT(_profile_scope_, __LINE__){NAME}
+#define PROFILE_FUNCTION()           PROFILE_SCOPE(__func__)
+#define PROFILE_COUNTER(NAME, VALUE) bul::profiler::counter(NAME, double(VALUE))
+#define PROFILE_THREAD(NAME)         bul::profiler::set_thread_name(NAME)
+#define PROFILE_FRAME()              bul::profiler::frame()
+#else
+#define PROFILE_SCOPE(NAME)
+#define PROFILE_FUNCTION()
+// Not evaluated, only keeps variables that are just counted from being unused
+#define PROFILE_COUNTER(NAME, VALUE) ((void)sizeof(VALUE))
+#define PROFILE_THREAD(NAME)
+#define PROFILE_FRAME()
+#endif
+
+namespace bul::profiler
+{
+class Scope
+{
+public:
+    explicit Scope(const char* name);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* name_;
+    int64_t begin_;
+    uint32_t depth_;
+};
+
+// The name is copied, threads are called "thread <id>" otherwise
+void set_thread_name(const char* name);
+// Value of a counter from now on, shown as a graph in the trace
+void counter(const char* name, double value);
+
+// Ends the current frame and collects what every thread recorded since the previous call, from a single thread.
+// Scopes recorded between two calls go to the frame they end in.
+void frame();
+
+struct ScopeRecord
+{
+    const char* name;
+    double begin_us;
+    double duration_us;
+    uint32_t depth;
+    uint32_t thread;
+};
+
+struct CounterRecord
+{
+    const char* name;
+    double time_us;
+    double value;
+};
+
+struct ThreadRecord
+{
+    uint32_t id;
+    std::string name;
+};
+
+// Times are relative to the first use of the profiler
+struct FrameRecord
+{
+    double begin_us = 0;
+    double duration_us = 0;
+    // Sorted by thread then begin, children follow their parent
+    std::vector<ScopeRecord> scopes;
+    std::vector<CounterRecord> counters;
+    std::vector<ThreadRecord> threads;
+    // Scopes lost because a thread filled its ring before the frame was collected
+    uint64_t dropped = 0;
+};
+
+// The frame collected by the last call to frame
+FrameRecord last_frame();
+// Durations of the last frames, oldest first
+std::vector<float> frame_history_ms();
+
+// Keeps every frame collected until end_capture, which writes them to a Chrome trace (chrome://tracing, Perfetto)
+void begin_capture();
+bool end_capture(const char* path);
+bool capturing();
+} // namespace bul::profiler
@@ -17,6 +17,10 @@ double delta_us();
 double delta_ns();
 
 void update();
+
+// Raw value of the counter the timers read, tick_frequency of them make a second
+int64_t ticks();
+int64_t tick_frequency();
 } // namespace Time
 
 class Timer
@@ -42,12 +46,9 @@ public:
     static constexpr inline int NS = 1'000'000'000;
 
 private:
-#if defined(_WIN32)
+    // Ticks of the platform counter, see platform/time_*.cpp
     int64_t start_time_ = 0;
     int64_t prev_time_ = 0;
     double delta_ = 0;
-#else
-    static_assert(false, "Timer unimplemented for this platform");
-#endif
 };
 } // namespace bul
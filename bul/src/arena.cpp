@@ -0,0 +1,162 @@
+#include "bul/arena.h"
+
+#include <cstdlib>
+
+namespace bul
+{
+struct Arena::Block
+{
+    Block* next;
+    size_t size;
+    bool owned;
+
+    uint8_t* data()
+    {
+        return (uint8_t*)(this + 1);
+    }
+};
+
+Arena::Arena(size_t block_size)
+    : block_size_{block_size}
+{}
+
+Arena::Arena(void* buffer, size_t size, size_t block_size)
+    : Arena(block_size)
+{
+    uint8_t* start = align((uint8_t*)buffer, alignof(Block));
+    if (start + sizeof(Block) < (uint8_t*)buffer + size)
+    {
+        first_ = new (start) Block{nullptr, size_t((uint8_t*)buffer + size - start) - sizeof(Block), false};
+        stats_.capacity = first_->size;
+        use_block(first_);
+    }
+}
+
+Arena::~Arena()
+{
+    release();
+}
+
+Arena::Arena(Arena&& other)
+{
+    *this = std::move(other);
+}
+
+Arena& Arena::operator=(Arena&& other)
+{
+    if (this != &other)
+    {
+        release();
+        block_size_ = other.block_size_;
+        first_ = std::exchange(other.first_, nullptr);
+        current_ = std::exchange(other.current_, nullptr);
+        top_ = std::exchange(other.top_, nullptr);
+        end_ = std::exchange(other.end_, nullptr);
+        stats_ = std::exchange(other.stats_, {});
+    }
+    return *this;
+}
+
+void Arena::use_block(Block* block)
+{
+    current_ = block;
+    top_ = block->data();
+    end_ = top_ + block->size;
+}
+
+uint8_t* Arena::allocate_slow(size_t size, size_t alignment)
+{
+    // Blocks kept from before the last reset are reused in order, a block too small for this allocation is skipped
+    Block* prev = current_;
+    Block* next = current_ != nullptr ? current_->next : first_;
+    while (next != nullptr)
+    {
+        uint8_t* ptr = align(next->data(), alignment);
+        if (ptr + size <= next->data() + next->size)
+        {
+            use_block(next);
+            return ptr;
+        }
+        prev = next;
+        next = next->next;
+    }
+
+    size_t block_size = size + alignment > block_size_ ? size + alignment : block_size_;
+    Block* block = (Block*)malloc(sizeof(Block) + block_size);
+    ASSERT(block != nullptr);
+    *block = Block{nullptr, block_size, true};
+    if (prev != nullptr)
+    {
+        prev->next = block;
+    }
+    else
+    {
+        first_ = block;
+    }
+    stats_.heap_allocations += 1;
+    stats_.capacity += block_size;
+    use_block(block);
+    return align(top_, alignment);
+}
+
+void Arena::rewind(const Marker& marker)
+{
+    if (marker.block == nullptr)
+    {
+        reset();
+        return;
+    }
+    current_ = (Block*)marker.block;
+    top_ = marker.top;
+    end_ = current_->data() + current_->size;
+    stats_.bytes = marker.bytes;
+}
+
+void Arena::reset()
+{
+    if (first_ != nullptr)
+    {
+        use_block(first_);
+    }
+    stats_.allocations = 0;
+    stats_.bytes = 0;
+}
+
+void Arena::release()
+{
+    for (Block* block = first_; block != nullptr;)
+    {
+        Block* next = block->next;
+        if (block->owned)
+        {
+            free(block);
+        }
+        block = next;
+    }
+    first_ = nullptr;
+    current_ = nullptr;
+    top_ = nullptr;
+    end_ = nullptr;
+}
+
+FrameArena::FrameArena(size_t block_size)
+    : arenas_{Arena(block_size), Arena(block_size)}
+{}
+
+void FrameArena::begin_frame()
+{
+    last_frame_allocations_ = arenas_[current_].stats().allocations;
+    current_ = (current_ + 1) % FRAMES;
+    arenas_[current_].reset();
+}
+
+size_t FrameArena::heap_allocations() const
+{
+    size_t count = 0;
+    for (const auto& arena : arenas_)
+    {
+        count += arena.stats().heap_allocations;
+    }
+    return count;
+}
+} // namespace bul
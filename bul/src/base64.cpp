@@ -0,0 +1,253 @@
+#include "bul/base64.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define BUL_BASE64_X64
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define BUL_TARGET(x)
+#else
+#include <cpuid.h>
+#define BUL_TARGET(x) __attribute__((target(x)))
+#endif
+#include <immintrin.h>
+#endif
+
+namespace bul
+{
+static constexpr uint8_t INVALID = 0xff;
+
+struct DecodeTable
+{
+    constexpr DecodeTable()
+    {
+        constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            values[i] = INVALID;
+        }
+        for (uint32_t i = 0; i < 64; ++i)
+        {
+            values[(uint8_t)alphabet[i]] = (uint8_t)i;
+        }
+    }
+
+    uint8_t values[256] = {};
+};
+
+static constexpr DecodeTable decode_table;
+
+static size_t padding(std::string_view str)
+{
+    size_t pad = 0;
+    while (pad < 2 && pad < str.size() && str[str.size() - pad - 1] == '=')
+    {
+        ++pad;
+    }
+    return pad;
+}
+
+size_t base64_decoded_size(std::string_view str)
+{
+    size_t size = str.size() - padding(str);
+    return size / 4 * 3 + (size % 4 ? size % 4 - 1 : 0);
+}
+
+bool base64_decode_scalar(std::string_view str, uint8_t* dst)
+{
+    str.remove_suffix(padding(str));
+    if (str.size() % 4 == 1)
+    {
+        return false;
+    }
+
+    const uint8_t* src = (const uint8_t*)str.data();
+    const uint8_t* end = src + str.size();
+    const uint8_t* t = decode_table.values;
+
+    for (; end - src >= 4; src += 4, dst += 3)
+    {
+        uint8_t a = t[src[0]], b = t[src[1]], c = t[src[2]], d = t[src[3]];
+        if ((a | b | c | d) == INVALID)
+        {
+            return false;
+        }
+        uint32_t v = (a << 18) | (b << 12) | (c << 6) | d;
+        dst[0] = (uint8_t)(v >> 16);
+        dst[1] = (uint8_t)(v >> 8);
+        dst[2] = (uint8_t)v;
+    }
+
+    if (end - src >= 2)
+    {
+        uint8_t a = t[src[0]], b = t[src[1]], c = end - src == 3 ? t[src[2]] : 0;
+        if ((a | b | c) == INVALID)
+        {
+            return false;
+        }
+        uint32_t v = (a << 18) | (b << 12) | (c << 6);
+        dst[0] = (uint8_t)(v >> 16);
+        if (end - src == 3)
+        {
+            dst[1] = (uint8_t)(v >> 8);
+        }
+    }
+
+    return true;
+}
+
+#if defined(BUL_BASE64_X64)
+/*
+ * Vectorized decoding based on the nibble lookup approach of Wojciech Mula and Alfred Klomp:
+ * the high and low nibbles of every character index two tables whose AND is non-zero only for
+ * characters outside of the alphabet, a third table gives the offset that maps each character
+ * range to its 6-bit value, then maddubs/madd pack 4 x 6 bits into 3 bytes per 32-bit lane.
+ * Blocks containing an invalid character are left to the scalar decoder.
+ */
+
+BUL_TARGET("ssse3") static __m128i decode_block_ssse3(__m128i str, bool& valid)
+{
+    const __m128i lut_lo =
+        _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    const __m128i lut_hi =
+        _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask_2f = _mm_set1_epi8(0x2f);
+
+    __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(str, 4), mask_2f);
+    __m128i lo_nibbles = _mm_and_si128(str, mask_2f);
+    __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+    __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+    valid = _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) == 0;
+
+    __m128i eq_2f = _mm_cmpeq_epi8(str, mask_2f);
+    __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles));
+    str = _mm_add_epi8(str, roll);
+
+    __m128i merged = _mm_maddubs_epi16(str, _mm_set1_epi32(0x01400140));
+    merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+BUL_TARGET("ssse3") static size_t decode_ssse3(const uint8_t* src, size_t size, uint8_t* dst)
+{
+    // Each block reads 16 characters and stores 16 bytes of which 12 are valid, keeping at least
+    // 8 characters for the scalar tail guarantees the extra stores stay in bounds and that the
+    // padding is never part of a vectorized block
+    size_t processed = 0;
+    while (size - processed >= 24)
+    {
+        bool valid = false;
+        __m128i out = decode_block_ssse3(_mm_loadu_si128((const __m128i*)(src + processed)), valid);
+        if (!valid)
+        {
+            break;
+        }
+        _mm_storeu_si128((__m128i*)dst, out);
+        processed += 16;
+        dst += 12;
+    }
+    return processed;
+}
+
+BUL_TARGET("avx2") static size_t decode_avx2(const uint8_t* src, size_t size, uint8_t* dst)
+{
+    const __m256i lut_lo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1a,
+                                            0x1b, 0x1b, 0x1b, 0x1a, 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                            0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    const __m256i lut_hi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10,
+                                            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lut_roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0, 0, 16, 19, 4,
+                                              -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i shuffle = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 2, 1, 0, 6, 5, 4,
+                                             10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i mask_2f = _mm256_set1_epi8(0x2f);
+
+    // 32 characters in, 32 bytes stored of which 24 are valid
+    size_t processed = 0;
+    while (size - processed >= 48)
+    {
+        __m256i str = _mm256_loadu_si256((const __m256i*)(src + processed));
+        __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask_2f);
+        __m256i lo_nibbles = _mm256_and_si256(str, mask_2f);
+        __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+        __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+        if (!_mm256_testz_si256(lo, hi))
+        {
+            break;
+        }
+
+        __m256i eq_2f = _mm256_cmpeq_epi8(str, mask_2f);
+        __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles));
+        str = _mm256_add_epi8(str, roll);
+
+        __m256i merged = _mm256_maddubs_epi16(str, _mm256_set1_epi32(0x01400140));
+        merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+        merged = _mm256_shuffle_epi8(merged, shuffle);
+        merged = _mm256_permutevar8x32_epi32(merged, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+        _mm256_storeu_si256((__m256i*)dst, merged);
+        processed += 32;
+        dst += 24;
+    }
+    return processed;
+}
+
+enum class Isa
+{
+    Scalar,
+    SSSE3,
+    AVX2,
+};
+
+static Isa detect_isa()
+{
+    uint32_t leaf1[4] = {};
+    uint32_t leaf7[4] = {};
+#if defined(_MSC_VER) && !defined(__clang__)
+    __cpuid((int*)leaf1, 1);
+    __cpuidex((int*)leaf7, 7, 0);
+    bool os_avx = (leaf1[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+#else
+    __get_cpuid(1, &leaf1[0], &leaf1[1], &leaf1[2], &leaf1[3]);
+    __get_cpuid_count(7, 0, &leaf7[0], &leaf7[1], &leaf7[2], &leaf7[3]);
+    bool os_avx = __builtin_cpu_supports("avx");
+#endif
+    if (os_avx && (leaf7[1] & (1 << 5)))
+    {
+        return Isa::AVX2;
+    }
+    if (leaf1[2] & (1 << 9))
+    {
+        return Isa::SSSE3;
+    }
+    return Isa::Scalar;
+}
+#endif
+
+bool base64_decode(std::string_view str, uint8_t* dst)
+{
+#if defined(BUL_BASE64_X64)
+    static const Isa isa = detect_isa();
+
+    const uint8_t* src = (const uint8_t*)str.data();
+    size_t processed = 0;
+    if (isa == Isa::AVX2)
+    {
+        processed = decode_avx2(src, str.size(), dst);
+    }
+    if (isa >= Isa::SSSE3)
+    {
+        processed += decode_ssse3(src + processed, str.size() - processed, dst + processed / 4 * 3);
+    }
+    str.remove_prefix(processed);
+    dst += processed / 4 * 3;
+#endif
+    return base64_decode_scalar(str, dst);
+}
+
+bool base64_decode(std::string_view str, std::vector<uint8_t>& data)
+{
+    data.resize(base64_decoded_size(str));
+    return base64_decode(str, data.data());
+}
+} // namespace bul
@@ -2,6 +2,10 @@
 
 #include <cstdio>
 
+#if !defined(_MSC_VER)
+#include <csignal>
+#endif
+
 namespace bul
 {
 void _assert(bool cond, const char* cond_str, const char* msg, const char* file, unsigned line)
@@ -17,7 +21,11 @@ void _assert(bool cond, const char* cond_str, const char* msg, const char* file,
         {
             fprintf(stderr, "\n");
         }
+#if defined(_MSC_VER)
         __debugbreak();
+#else
+        raise(SIGTRAP);
+#endif
     }
 }
 } // namespace bul
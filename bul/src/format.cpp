@@ -2,31 +2,39 @@
 
 #include <cstdio>
 
-#include "bul/containers/buffer.h"
-
 namespace bul
 {
-static thread_local Buffer<char> log_buffer;
+static thread_local Buffer<char> t_format_buffer;
+
+Buffer<char>& detail::format_buffer()
+{
+    return t_format_buffer;
+}
 
-const char* format(const char* fmt, ...)
+const char* formatf(const char* fmt, ...)
 {
     std::va_list args;
     va_start(args, fmt);
-    const char* text = format(fmt, args);
+    const char* text = formatf(fmt, args);
     va_end(args);
     return text;
 }
 
-const char* format(const char* fmt, va_list args)
+const char* formatf(const char* fmt, va_list args)
 {
+    if (t_format_buffer.size() == 0)
+    {
+        t_format_buffer.resize(256);
+    }
     va_list args_copy;
     va_copy(args_copy, args);
-    size_t size = vsnprintf(nullptr, 0, fmt, args);
-    if (size >= log_buffer.size())
+    int size = vsnprintf(t_format_buffer.data(), t_format_buffer.size(), fmt, args);
+    if (size >= 0 && size_t(size) >= t_format_buffer.size())
     {
-        log_buffer.resize(size + 1);
+        t_format_buffer.resize(size_t(size) + 1);
+        vsnprintf(t_format_buffer.data(), t_format_buffer.size(), fmt, args_copy);
     }
-    vsnprintf(log_buffer.data(), log_buffer.size(), fmt, args_copy);
-    return log_buffer.data();
+    va_end(args_copy);
+    return t_format_buffer.data();
 }
 } // namespace bul
@@ -1,11 +1,43 @@
 #include "bul/hash.h"
 
+#define XXH_STATIC_LINKING_ONLY
 #include "xxhash/xxhash.h"
 
 namespace bul
 {
-uint64_t hash(const void* data, size_t size)
+static_assert(sizeof(XXH3_state_t) <= sizeof(Hasher) && alignof(XXH3_state_t) <= alignof(Hasher));
+
+uint64_t hash(const void* data, size_t size, uint64_t seed)
+{
+    return XXH3_64bits_withSeed(data, size, seed);
+}
+
+Hash128 hash128(const void* data, size_t size, uint64_t seed)
+{
+    XXH128_hash_t res = XXH3_128bits_withSeed(data, size, seed);
+    return {res.low64, res.high64};
+}
+
+Hasher::Hasher(uint64_t seed)
+{
+    // The 64 and 128 bit variants share the state and its reset
+    XXH3_64bits_reset_withSeed((XXH3_state_t*)state_, seed);
+}
+
+Hasher& Hasher::update(const void* data, size_t size)
+{
+    XXH3_64bits_update((XXH3_state_t*)state_, data, size);
+    return *this;
+}
+
+uint64_t Hasher::digest() const
+{
+    return XXH3_64bits_digest((const XXH3_state_t*)state_);
+}
+
+Hash128 Hasher::digest128() const
 {
-    return XXH64(data, size, 0);
+    XXH128_hash_t res = XXH3_128bits_digest((const XXH3_state_t*)state_);
+    return {res.low64, res.high64};
 }
-}; // namespace bul
+} // namespace bul
@@ -0,0 +1,427 @@
+#include "bul/io.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bul/bul.h"
+#include "bul/file.h"
+#include "bul/memory.h"
+#include "bul/profiler.h"
+
+#if defined(__linux__)
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace bul::io
+{
+struct Request
+{
+    std::string path;
+    ReadCallback callback;
+    jobs::Counter* counter = nullptr;
+    // Of the thread that made the request, the data and the callback job are allocated with it
+    memory::Tag memory_tag = memory::Tag::Untagged;
+    std::unique_ptr<uint8_t[]> data;
+    size_t size = 0;
+#if defined(__linux__)
+    int fd = -1;
+    size_t offset = 0;
+    iovec iov = {};
+#endif
+};
+
+// The callback job is counted before the read is released, so the counter never reaches zero in between
+static void complete(Request* request, bool ok)
+{
+    jobs::Counter* counter = request->counter;
+    memory::Scope memory_scope{request->memory_tag};
+    jobs::run(
+        [request, ok]() {
+            std::span<const uint8_t> data;
+            if (ok)
+            {
+                data = {request->data.get(), request->size};
+            }
+            request->callback(data, ok);
+            delete request;
+        },
+        counter);
+    if (counter != nullptr)
+    {
+        jobs::release(*counter);
+    }
+}
+
+#if defined(__linux__)
+/*
+ * Minimal io_uring: the submission and completion rings are shared with the kernel, entries are produced by moving a
+ * tail and consumed by moving a head, with release and acquire orderings on them.
+ */
+class Ring
+{
+public:
+    bool init(uint32_t entries)
+    {
+        io_uring_params params = {};
+        fd_ = int(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd_ < 0)
+        {
+            return false;
+        }
+
+        sq_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap)
+        {
+            sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+        }
+        sq_ptr_ = mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+        cq_ptr_ = single_mmap ? sq_ptr_
+                              : mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                                     IORING_OFF_CQ_RING);
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = (io_uring_sqe*)mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                                    IORING_OFF_SQES);
+        if (sq_ptr_ == MAP_FAILED || cq_ptr_ == MAP_FAILED || sqes_ == MAP_FAILED)
+        {
+            destroy();
+            return false;
+        }
+
+        sq_tail_ = offset_ptr<uint32_t*>(sq_ptr_, params.sq_off.tail);
+        sq_mask_ = *offset_ptr<uint32_t*>(sq_ptr_, params.sq_off.ring_mask);
+        sq_array_ = offset_ptr<uint32_t*>(sq_ptr_, params.sq_off.array);
+        sq_entries_ = params.sq_entries;
+        cq_head_ = offset_ptr<uint32_t*>(cq_ptr_, params.cq_off.head);
+        cq_tail_ = offset_ptr<uint32_t*>(cq_ptr_, params.cq_off.tail);
+        cq_mask_ = *offset_ptr<uint32_t*>(cq_ptr_, params.cq_off.ring_mask);
+        cqes_ = offset_ptr<io_uring_cqe*>(cq_ptr_, params.cq_off.cqes);
+        return true;
+    }
+
+    void destroy()
+    {
+        if (sqes_ != nullptr && sqes_ != MAP_FAILED)
+        {
+            munmap(sqes_, sqes_size_);
+        }
+        if (cq_ptr_ != nullptr && cq_ptr_ != MAP_FAILED && cq_ptr_ != sq_ptr_)
+        {
+            munmap(cq_ptr_, cq_size_);
+        }
+        if (sq_ptr_ != nullptr && sq_ptr_ != MAP_FAILED)
+        {
+            munmap(sq_ptr_, sq_size_);
+        }
+        if (fd_ >= 0)
+        {
+            close(fd_);
+        }
+        *this = Ring{};
+    }
+
+    uint32_t capacity() const
+    {
+        return sq_entries_;
+    }
+
+    void push_read(int fd, iovec* iov, size_t offset, void* user_data)
+    {
+        uint32_t tail = *sq_tail_;
+        uint32_t index = tail & sq_mask_;
+        io_uring_sqe& sqe = sqes_[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READV;
+        sqe.fd = fd;
+        sqe.addr = uint64_t(uintptr_t(iov));
+        sqe.len = 1;
+        sqe.off = offset;
+        sqe.user_data = uint64_t(uintptr_t(user_data));
+        sq_array_[index] = index;
+        std::atomic_ref<uint32_t>(*sq_tail_).store(tail + 1, std::memory_order_release);
+        to_submit_ += 1;
+    }
+
+    // Submits everything pushed since the last call in one syscall and waits for wait_count completions
+    void submit(uint32_t wait_count)
+    {
+        while (to_submit_ > 0 || wait_count > 0)
+        {
+            int submitted = int(syscall(__NR_io_uring_enter, fd_, to_submit_, wait_count,
+                                        wait_count > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0));
+            if (submitted < 0)
+            {
+                ASSERT_MSG(errno == EINTR || errno == EAGAIN, "io_uring_enter failed");
+                continue;
+            }
+            to_submit_ -= uint32_t(submitted);
+            wait_count = 0;
+        }
+    }
+
+    // Calls fn(user_data, result) for every available completion
+    template <typename F>
+    void reap(F&& fn)
+    {
+        uint32_t head = *cq_head_;
+        uint32_t tail = std::atomic_ref<uint32_t>(*cq_tail_).load(std::memory_order_acquire);
+        for (; head != tail; ++head)
+        {
+            const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+            fn((void*)uintptr_t(cqe.user_data), cqe.res);
+        }
+        std::atomic_ref<uint32_t>(*cq_head_).store(head, std::memory_order_release);
+    }
+
+private:
+    int fd_ = -1;
+    void* sq_ptr_ = nullptr;
+    void* cq_ptr_ = nullptr;
+    size_t sq_size_ = 0;
+    size_t cq_size_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqes_size_ = 0;
+
+    uint32_t* sq_tail_ = nullptr;
+    uint32_t* sq_array_ = nullptr;
+    uint32_t sq_mask_ = 0;
+    uint32_t sq_entries_ = 0;
+    uint32_t* cq_head_ = nullptr;
+    uint32_t* cq_tail_ = nullptr;
+    uint32_t cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+    uint32_t to_submit_ = 0;
+};
+#endif
+
+struct Context
+{
+    Backend backend = Backend::ThreadPool;
+    uint32_t queue_depth = 0;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<Request*> requests;
+    bool stop = false;
+    std::vector<std::thread> threads;
+#if defined(__linux__)
+    Ring ring;
+#endif
+};
+
+static Context* s_context = nullptr;
+
+// Blocks until a request is available, returns false once stopped with nothing left
+static bool wait_requests(std::unique_lock<std::mutex>& lock)
+{
+    s_context->condition.wait(lock, []() { return !s_context->requests.empty() || s_context->stop; });
+    return !s_context->requests.empty();
+}
+
+// A missing file has a size of 0 but fails to open in read_file
+static void pool_main()
+{
+    PROFILE_THREAD("I/O");
+    for (;;)
+    {
+        Request* request = nullptr;
+        {
+            std::unique_lock lock{s_context->mutex};
+            if (!wait_requests(lock))
+            {
+                return;
+            }
+            request = s_context->requests.front();
+            s_context->requests.pop_front();
+        }
+        request->size = file_size(request->path.c_str());
+        {
+            memory::Scope memory_scope{request->memory_tag};
+            request->data.reset(new uint8_t[request->size]);
+        }
+        complete(request, read_file(request->path.c_str(), request->data.get(), request->size));
+    }
+}
+
+#if defined(__linux__)
+// Opening is left synchronous, it hits the dentry cache and only the reads are worth batching
+static bool open_request(Request* request)
+{
+    request->fd = open(request->path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (request->fd < 0 || fstat(request->fd, &st) != 0)
+    {
+        return false;
+    }
+    request->size = size_t(st.st_size);
+    // Not value initialized, the kernel writes every byte
+    memory::Scope memory_scope{request->memory_tag};
+    request->data.reset(new uint8_t[request->size]);
+    return true;
+}
+
+static void finish_request(Request* request, bool ok)
+{
+    if (request->fd >= 0)
+    {
+        close(request->fd);
+    }
+    complete(request, ok);
+}
+
+static void ring_main()
+{
+    PROFILE_THREAD("I/O");
+    Ring& ring = s_context->ring;
+    std::deque<Request*> pending;
+    std::vector<Request*> incoming;
+    uint32_t in_flight = 0;
+    for (;;)
+    {
+        incoming.clear();
+        {
+            std::unique_lock lock{s_context->mutex};
+            // Only sleeps on the condition when the ring has nothing to wait for either
+            if (in_flight == 0 && pending.empty() && !wait_requests(lock))
+            {
+                return;
+            }
+            incoming.assign(s_context->requests.begin(), s_context->requests.end());
+            s_context->requests.clear();
+        }
+
+        for (Request* request : incoming)
+        {
+            if (!open_request(request) || request->size == 0)
+            {
+                finish_request(request, request->size == 0 && request->fd >= 0);
+                continue;
+            }
+            pending.push_back(request);
+        }
+
+        while (!pending.empty() && in_flight < ring.capacity())
+        {
+            Request* request = pending.front();
+            pending.pop_front();
+            request->iov = {request->data.get() + request->offset, request->size - request->offset};
+            ring.push_read(request->fd, &request->iov, request->offset, request);
+            in_flight += 1;
+        }
+
+        // Waiting for a completion would delay requests that arrive meanwhile, it is only done when none did
+        ring.submit(incoming.empty() && in_flight > 0 ? 1 : 0);
+        ring.reap([&](void* user_data, int32_t res) {
+            Request* request = static_cast<Request*>(user_data);
+            in_flight -= 1;
+            if (res == -EINTR || res == -EAGAIN)
+            {
+                pending.push_front(request);
+            }
+            else if (res <= 0)
+            {
+                // Errors, or the file got shorter since fstat
+                finish_request(request, false);
+            }
+            else if (request->offset += size_t(res); request->offset < request->size)
+            {
+                // Short read, the rest goes back in the ring
+                pending.push_front(request);
+            }
+            else
+            {
+                finish_request(request, true);
+            }
+        });
+    }
+}
+#endif
+
+void init(uint32_t queue_depth, Backend backend)
+{
+    ASSERT_MSG(s_context == nullptr, "bul::io is already initialized");
+    s_context = new Context;
+    s_context->queue_depth = std::max(queue_depth, 1u);
+
+#if defined(__linux__)
+    if (backend == Backend::IoUring && s_context->ring.init(s_context->queue_depth))
+    {
+        s_context->backend = Backend::IoUring;
+        s_context->threads.emplace_back(ring_main);
+        return;
+    }
+#else
+    (void)backend;
+#endif
+
+    // Blocking reads only overlap across threads, past a few of them the device is the bottleneck
+    s_context->backend = Backend::ThreadPool;
+    uint32_t thread_count = std::min(s_context->queue_depth, 8u);
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        s_context->threads.emplace_back(pool_main);
+    }
+}
+
+void shutdown()
+{
+    if (s_context == nullptr)
+    {
+        return;
+    }
+    {
+        std::lock_guard lock{s_context->mutex};
+        s_context->stop = true;
+    }
+    s_context->condition.notify_all();
+    for (auto& thread : s_context->threads)
+    {
+        thread.join();
+    }
+#if defined(__linux__)
+    s_context->ring.destroy();
+#endif
+    delete s_context;
+    s_context = nullptr;
+}
+
+Backend backend()
+{
+    ASSERT_MSG(s_context != nullptr, "bul::io::init was not called");
+    return s_context->backend;
+}
+
+void read(std::string path, ReadCallback callback, jobs::Counter* counter)
+{
+    ASSERT_MSG(s_context != nullptr, "bul::io::init was not called");
+    if (counter != nullptr)
+    {
+        jobs::acquire(*counter);
+    }
+    Request* request = new Request;
+    request->path = std::move(path);
+    request->callback = std::move(callback);
+    request->counter = counter;
+    request->memory_tag = memory::current_tag();
+    {
+        std::lock_guard lock{s_context->mutex};
+        s_context->requests.push_back(request);
+    }
+    s_context->condition.notify_one();
+}
+} // namespace bul::io
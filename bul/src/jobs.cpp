@@ -0,0 +1,437 @@
+#include "bul/jobs.h"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+#include "bul/format.h"
+#include "bul/profiler.h"
+#include "bul/containers/mpmc_queue.h"
+
+namespace bul::jobs
+{
+struct Access
+{
+    static std::atomic<int64_t>& value(Counter& counter)
+    {
+        return counter.value_;
+    }
+
+    static std::mutex& mutex(Counter& counter)
+    {
+        return counter.mutex_;
+    }
+
+    static std::vector<Job*>& waiting(Counter& counter)
+    {
+        return counter.waiting_;
+    }
+};
+
+/*
+ * Chase-Lev deque with the memory orderings of "Correct and Efficient Work-Stealing for Weak Memory Models" (Lê et al.
+ * 2013), the fences are folded into seq_cst accesses. The owner pushes and pops at the bottom, thieves take from the
+ * top and the two sides only race for the last job.
+ */
+class Deque
+{
+public:
+    static constexpr int64_t CAPACITY = 4096;
+
+    bool push(Job* job)
+    {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        int64_t top = top_.load(std::memory_order_acquire);
+        if (bottom - top >= CAPACITY)
+        {
+            return false;
+        }
+        jobs_[bottom & (CAPACITY - 1)].store(job, std::memory_order_relaxed);
+        bottom_.store(bottom + 1, std::memory_order_release);
+        return true;
+    }
+
+    Job* pop()
+    {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(bottom, std::memory_order_seq_cst);
+        int64_t top = top_.load(std::memory_order_seq_cst);
+        if (top > bottom)
+        {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Job* job = jobs_[bottom & (CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (top == bottom)
+        {
+            // Last job, a thief may be taking it at the same time
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                job = nullptr;
+            }
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    Job* steal()
+    {
+        int64_t top = top_.load(std::memory_order_seq_cst);
+        int64_t bottom = bottom_.load(std::memory_order_seq_cst);
+        if (top >= bottom)
+        {
+            return nullptr;
+        }
+        Job* job = jobs_[top & (CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return nullptr;
+        }
+        return job;
+    }
+
+    size_t size() const
+    {
+        int64_t size = bottom_.load(std::memory_order_relaxed) - top_.load(std::memory_order_relaxed);
+        return size > 0 ? size_t(size) : 0;
+    }
+
+private:
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> top_ = 0;
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> bottom_ = 0;
+    alignas(CACHE_LINE_SIZE) std::atomic<Job*> jobs_[CAPACITY] = {};
+};
+
+struct Worker
+{
+    Deque deque;
+    std::thread thread;
+};
+
+struct Scheduler
+{
+    std::vector<std::unique_ptr<Worker>> workers;
+    // Jobs submitted by threads that are not workers
+    MpmcQueue<Job*, 4096> injected;
+    // Completed jobs kept around to be reused
+    MpmcQueue<Job*, 1024> free_jobs;
+    // Bumped on every submission, sleeping workers wait for it to change
+    std::atomic<uint32_t> epoch = 0;
+    std::atomic<uint32_t> sleeping = 0;
+    std::atomic<bool> running = true;
+};
+
+static Scheduler* s_scheduler = nullptr;
+static thread_local uint32_t t_worker_index = UINT32_MAX;
+static thread_local uint32_t t_rng_state = 0;
+
+static uint32_t next_random()
+{
+    // xorshift32, only used to pick a victim
+    uint32_t x = t_rng_state != 0 ? t_rng_state : 0x9e3779b9u ^ (t_worker_index + 1);
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    t_rng_state = x;
+    return x;
+}
+
+/*
+ * Sleeping is a store-buffer handshake: the waker bumps the epoch then reads sleeping, the sleeper bumps sleeping then
+ * reads the epoch in wait. With seq_cst on all four, at least one side sees the other, either the waker notifies or the
+ * wait returns right away. Acquire and release alone would let both read the old values and lose the wakeup.
+ */
+static void wake_workers(bool all = false)
+{
+    s_scheduler->epoch.fetch_add(1, std::memory_order_seq_cst);
+    if (s_scheduler->sleeping.load(std::memory_order_seq_cst) > 0)
+    {
+        if (all)
+        {
+            s_scheduler->epoch.notify_all();
+        }
+        else
+        {
+            s_scheduler->epoch.notify_one();
+        }
+    }
+}
+
+// epoch is read before the caller last looked for work, anything submitted since then has changed it
+static void sleep_until_changed(uint32_t epoch)
+{
+    s_scheduler->sleeping.fetch_add(1, std::memory_order_seq_cst);
+    s_scheduler->epoch.wait(epoch, std::memory_order_seq_cst);
+    s_scheduler->sleeping.fetch_sub(1, std::memory_order_relaxed);
+}
+
+static void free_job(Job* job)
+{
+    if (!s_scheduler->free_jobs.push_back(job))
+    {
+        delete job;
+    }
+}
+
+static void schedule(Job* job);
+
+/*
+ * Only the decrement that may bring the counter to zero takes its lock. A thread waiting on the counter takes the lock
+ * before returning, so it can't destroy the counter while the last job is still in here, and submit checks for
+ * dependencies under it.
+ */
+static void complete(Counter& counter)
+{
+    std::atomic<int64_t>& value = Access::value(counter);
+    int64_t current = value.load(std::memory_order_relaxed);
+    while (current > 1)
+    {
+        if (value.compare_exchange_weak(current, current - 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+            return;
+        }
+    }
+
+    bool reached_zero = false;
+    std::vector<Job*> waiting;
+    {
+        std::lock_guard lock{Access::mutex(counter)};
+        if (value.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            reached_zero = true;
+            waiting.swap(Access::waiting(counter));
+        }
+    }
+    if (!reached_zero)
+    {
+        return;
+    }
+    // Threads sleeping in wait look at the counter again
+    wake_workers(true);
+    for (Job* job : waiting)
+    {
+        schedule(job);
+    }
+}
+
+static void execute(Job* job)
+{
+    Counter* counter = job->counter;
+    {
+        memory::Scope memory_scope{job->memory_tag};
+        job->invoke(job);
+    }
+    free_job(job);
+    if (counter != nullptr)
+    {
+        complete(*counter);
+    }
+}
+
+static void schedule(Job* job)
+{
+    uint32_t index = t_worker_index;
+    bool pushed = index != UINT32_MAX ? s_scheduler->workers[index]->deque.push(job)
+                                      : s_scheduler->injected.push_back(job);
+    if (!pushed)
+    {
+        // Queues are full, running the job right away keeps things moving
+        execute(job);
+        return;
+    }
+    wake_workers();
+}
+
+static Job* find_job()
+{
+    Scheduler& scheduler = *s_scheduler;
+    uint32_t index = t_worker_index;
+    Job* job = nullptr;
+    if (index != UINT32_MAX && (job = scheduler.workers[index]->deque.pop()) != nullptr)
+    {
+        return job;
+    }
+    if (scheduler.injected.pop_front(job))
+    {
+        return job;
+    }
+
+    uint32_t worker_count = uint32_t(scheduler.workers.size());
+    uint32_t start = next_random() % worker_count;
+    for (uint32_t i = 0; i < worker_count; ++i)
+    {
+        uint32_t victim = (start + i) % worker_count;
+        if (victim != index && (job = scheduler.workers[victim]->deque.steal()) != nullptr)
+        {
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+static void worker_main(uint32_t index)
+{
+    t_worker_index = index;
+    PROFILE_THREAD(format("Worker {}", index));
+    Scheduler& scheduler = *s_scheduler;
+    while (scheduler.running.load(std::memory_order_acquire))
+    {
+        if (Job* job = find_job())
+        {
+            execute(job);
+            continue;
+        }
+
+        // Nothing to steal, sleep until the next submission. The epoch is read before looking one last time, a job
+        // submitted in between changes it, and the seq_cst handshake with wake_workers makes sure that the change is
+        // either seen by the wait or followed by a notify.
+        uint32_t epoch = scheduler.epoch.load(std::memory_order_seq_cst);
+        if (Job* job = find_job())
+        {
+            execute(job);
+            continue;
+        }
+        sleep_until_changed(epoch);
+    }
+}
+
+void init(uint32_t thread_count)
+{
+    ASSERT(s_scheduler == nullptr);
+    if (thread_count == 0)
+    {
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    s_scheduler = new Scheduler;
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        s_scheduler->workers.push_back(std::make_unique<Worker>());
+    }
+    t_worker_index = 0;
+    for (uint32_t i = 1; i < thread_count; ++i)
+    {
+        s_scheduler->workers[i]->thread = std::thread(worker_main, i);
+    }
+}
+
+void shutdown()
+{
+    ASSERT(s_scheduler != nullptr);
+    s_scheduler->running.store(false, std::memory_order_release);
+    s_scheduler->epoch.fetch_add(1, std::memory_order_release);
+    s_scheduler->epoch.notify_all();
+    for (auto& worker : s_scheduler->workers)
+    {
+        if (worker->thread.joinable())
+        {
+            worker->thread.join();
+        }
+    }
+
+    Job* job = nullptr;
+    while (s_scheduler->free_jobs.pop_front(job))
+    {
+        delete job;
+    }
+    delete s_scheduler;
+    s_scheduler = nullptr;
+    t_worker_index = UINT32_MAX;
+}
+
+uint32_t thread_count()
+{
+    return s_scheduler != nullptr ? uint32_t(s_scheduler->workers.size()) : 0;
+}
+
+uint32_t worker_index()
+{
+    return t_worker_index;
+}
+
+void wait(Counter& counter)
+{
+    // Spins a little for the jobs that are about to be submitted or to finish, then sleeps like the workers until a
+    // submission or a counter reaching zero changes the epoch
+    static constexpr uint32_t SPINS = 64;
+    uint32_t spins = 0;
+    while (!counter.done())
+    {
+        if (Job* job = find_job())
+        {
+            execute(job);
+            spins = 0;
+            continue;
+        }
+        if (++spins < SPINS)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        uint32_t epoch = s_scheduler->epoch.load(std::memory_order_seq_cst);
+        if (counter.done())
+        {
+            break;
+        }
+        if (Job* job = find_job())
+        {
+            execute(job);
+            spins = 0;
+            continue;
+        }
+        sleep_until_changed(epoch);
+    }
+    std::lock_guard lock{Access::mutex(counter)};
+}
+
+void acquire(Counter& counter)
+{
+    Access::value(counter).fetch_add(1, std::memory_order_relaxed);
+}
+
+void release(Counter& counter)
+{
+    complete(counter);
+}
+
+Job* detail::allocate_job()
+{
+    ASSERT_MSG(s_scheduler != nullptr, "bul::jobs::init was not called");
+    Job* job = nullptr;
+    if (!s_scheduler->free_jobs.pop_front(job))
+    {
+        job = new Job;
+    }
+    return job;
+}
+
+void detail::submit(Job* job, Counter* counter, Counter* dependency)
+{
+    job->counter = counter;
+    job->memory_tag = memory::current_tag();
+    if (counter != nullptr)
+    {
+        Access::value(*counter).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (dependency != nullptr)
+    {
+        // Checked under the lock, complete takes the waiting jobs under it after the counter reached zero
+        std::lock_guard lock{Access::mutex(*dependency)};
+        if (!dependency->done())
+        {
+            Access::waiting(*dependency).push_back(job);
+            return;
+        }
+    }
+    schedule(job);
+}
+
+size_t detail::local_job_count()
+{
+    uint32_t index = t_worker_index;
+    return index != UINT32_MAX ? s_scheduler->workers[index]->deque.size() : s_scheduler->injected.size();
+}
+} // namespace bul::jobs
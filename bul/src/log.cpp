@@ -1,9 +1,12 @@
 #include "bul/log.h"
 
-#include <cstdio>
-#include <cstdarg>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
-#include "bul/format.h"
+#include "bul/bul.h"
 #include "bul/containers/enum_array.h"
 
 namespace bul
@@ -15,49 +18,239 @@ static constexpr EnumArray<LogLevel, const char*> log_level_str = {
     "[ERROR]",
 };
 
-static void log(LogLevel level, const char* fmt, va_list args)
+static constexpr size_t RING_SIZE = 64_KB;
+static constexpr size_t RECORD_ALIGNMENT = 8;
+
+static size_t align_record(size_t size)
 {
-    const char* text = format(fmt, args);
-    printf("%s %s\n", log_level_str[level], text);
+    return (size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
 }
 
-void log_debug(const char* fmt, ...)
+/*
+ * Byte ring with one producer, the thread that owns it, and one consumer, the background thread. Records never wrap
+ * around: when one does not fit before the end, a record of size 0 tells the consumer to continue from the start.
+ */
+struct LogRing
+{
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head = 0;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail = 0;
+    // Producer side
+    size_t head_cache = 0;
+    size_t reserved_tail = 0;
+    // Set when the owning thread exits, the consumer frees the ring once it is empty
+    std::atomic<bool> orphaned = false;
+    alignas(RECORD_ALIGNMENT) uint8_t data[RING_SIZE];
+};
+
+class Logger
 {
-    std::va_list args;
-    va_start(args, fmt);
-    log(LogLevel::Debug, fmt, args);
-    va_end(args);
+public:
+    Logger()
+    {
+        thread_ = std::thread([this]() { run(); });
+    }
+
+    ~Logger()
+    {
+        stop_ = true;
+        thread_.join();
+        for (LogRing* ring : rings_)
+        {
+            delete ring;
+        }
+    }
+
+    LogRing* add_ring()
+    {
+        LogRing* ring = new LogRing;
+        std::lock_guard lock{rings_mutex_};
+        rings_.push_back(ring);
+        return ring;
+    }
+
+    void flush()
+    {
+        std::unique_lock lock{flush_mutex_};
+        uint64_t request = ++flush_requested_;
+        flush_condition_.wait(lock, [&]() { return flushed_ >= request; });
+    }
+
+    std::atomic<FILE*> file = stdout;
+
+private:
+    // Returns true if anything was written
+    bool drain(LogRing& ring)
+    {
+        size_t head = ring.head.load(std::memory_order_relaxed);
+        size_t tail = ring.tail.load(std::memory_order_acquire);
+        if (head == tail)
+        {
+            return false;
+        }
+        FILE* out = file.load(std::memory_order_relaxed);
+        while (head != tail)
+        {
+            // The end marker can be in the last 8 bytes, only its size is there
+            uint32_t size;
+            std::memcpy(&size, ring.data + head % RING_SIZE, sizeof(size));
+            if (size == 0)
+            {
+                head += RING_SIZE - head % RING_SIZE;
+                continue;
+            }
+            detail::LogHeader header;
+            std::memcpy(&header, ring.data + head % RING_SIZE, sizeof(header));
+            const uint8_t* args = ring.data + head % RING_SIZE + sizeof(header);
+            int length = header.format(text_.data(), text_.size(), header.fmt, args);
+            if (length >= int(text_.size()))
+            {
+                text_.resize(length + 1);
+                header.format(text_.data(), text_.size(), header.fmt, args);
+            }
+            fprintf(out, "%s %s\n", log_level_str[header.level], text_.data());
+            head += align_record(header.size);
+        }
+        ring.head.store(head, std::memory_order_release);
+        return true;
+    }
+
+    void run()
+    {
+        std::vector<LogRing*> rings;
+        for (;;)
+        {
+            // Read before draining, everything logged before the request is in the rings by then
+            uint64_t flush_request = flush_requested_.load(std::memory_order_acquire);
+            bool stopping = stop_.load(std::memory_order_acquire);
+            {
+                std::lock_guard lock{rings_mutex_};
+                rings = rings_;
+            }
+
+            bool written = false;
+            for (LogRing* ring : rings)
+            {
+                bool orphaned = ring->orphaned.load(std::memory_order_acquire);
+                written |= drain(*ring);
+                if (orphaned)
+                {
+                    std::lock_guard lock{rings_mutex_};
+                    std::erase(rings_, ring);
+                    delete ring;
+                }
+            }
+            if (written)
+            {
+                fflush(file.load(std::memory_order_relaxed));
+            }
+
+            if (flush_request > flushed_)
+            {
+                std::lock_guard lock{flush_mutex_};
+                flushed_ = flush_request;
+                flush_condition_.notify_all();
+            }
+            if (stopping)
+            {
+                return;
+            }
+            if (!written && flush_requested_.load(std::memory_order_relaxed) == flush_request)
+            {
+                // Polling keeps the logging threads from ever having to wake this one up
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+
+    std::thread thread_;
+    std::atomic<bool> stop_ = false;
+    std::mutex rings_mutex_;
+    std::vector<LogRing*> rings_;
+    std::vector<char> text_ = std::vector<char>(1024);
+
+    std::mutex flush_mutex_;
+    std::condition_variable flush_condition_;
+    std::atomic<uint64_t> flush_requested_ = 0;
+    uint64_t flushed_ = 0;
+};
+
+static Logger& logger()
+{
+    static Logger logger;
+    return logger;
+}
+
+struct ThreadRing
+{
+    LogRing* ring = nullptr;
+
+    ~ThreadRing()
+    {
+        if (ring != nullptr)
+        {
+            ring->orphaned.store(true, std::memory_order_release);
+        }
+    }
+};
+
+static thread_local ThreadRing t_ring;
+
+void set_log_level(LogLevel level)
+{
+    detail::min_log_level.store(level, std::memory_order_relaxed);
 }
 
-void log_info(const char* fmt, ...)
+LogLevel log_level()
 {
-    std::va_list args;
-    va_start(args, fmt);
-    log(LogLevel::Info, fmt, args);
-    va_end(args);
+    return detail::min_log_level.load(std::memory_order_relaxed);
 }
 
-void log_warning(const char* fmt, ...)
+void set_log_file(FILE* file)
 {
-    std::va_list args;
-    va_start(args, fmt);
-    log(LogLevel::Warning, fmt, args);
-    va_end(args);
+    logger().flush();
+    logger().file.store(file, std::memory_order_relaxed);
 }
 
-void log_error(const char* fmt, ...)
+void log_flush()
 {
-    std::va_list args;
-    va_start(args, fmt);
-    log(LogLevel::Error, fmt, args);
-    va_end(args);
+    logger().flush();
+}
+
+uint8_t* detail::log_reserve(size_t size)
+{
+    if (t_ring.ring == nullptr)
+    {
+        t_ring.ring = logger().add_ring();
+    }
+    LogRing& ring = *t_ring.ring;
+    size = align_record(size);
+    ASSERT_MSG(size <= RING_SIZE / 2, "Log message too large");
+
+    size_t tail = ring.tail.load(std::memory_order_relaxed);
+    size_t offset = tail % RING_SIZE;
+    // A record that would cross the end of the ring starts over at the beginning instead
+    size_t skipped = RING_SIZE - offset < size ? RING_SIZE - offset : 0;
+    while (tail + skipped + size - ring.head_cache > RING_SIZE)
+    {
+        ring.head_cache = ring.head.load(std::memory_order_acquire);
+        if (tail + skipped + size - ring.head_cache > RING_SIZE)
+        {
+            std::this_thread::yield();
+        }
+    }
+    if (skipped > 0)
+    {
+        uint32_t end_marker = 0;
+        std::memcpy(ring.data + offset, &end_marker, sizeof(end_marker));
+        tail += skipped;
+    }
+    ring.reserved_tail = tail + size;
+    return ring.data + tail % RING_SIZE;
 }
 
-void log(LogLevel level, const char* fmt, ...)
+void detail::log_commit()
 {
-    std::va_list args;
-    va_start(args, fmt);
-    log(level, fmt, args);
-    va_end(args);
+    LogRing& ring = *t_ring.ring;
+    ring.tail.store(ring.reserved_tail, std::memory_order_release);
 }
 } // namespace bul
@@ -0,0 +1,321 @@
+#include "bul/memory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
+#include <new>
+
+#include "bul/profiler.h"
+#include "bul/containers/enum_array.h"
+
+namespace bul::memory
+{
+static constexpr EnumArray<Tag, const char*> tag_names = {
+    "Untagged", "Containers", "Loaders", "Vulkan buffers", "Vulkan images", "Vulkan staging",
+};
+
+// Right before every allocation, the allocation is offset bytes into the malloc block
+struct Header
+{
+    uint64_t size;
+    uint32_t offset;
+    Tag tag;
+};
+
+static constexpr size_t HEADER_SIZE = 16;
+static_assert(sizeof(Header) <= HEADER_SIZE && HEADER_SIZE % alignof(std::max_align_t) == 0);
+
+// One cache line per tag, threads allocating with different tags don't share them
+struct alignas(CACHE_LINE_SIZE) Counters
+{
+    std::atomic<int64_t> live_bytes = 0;
+    std::atomic<int64_t> peak_bytes = 0;
+    std::atomic<int64_t> live_count = 0;
+    std::atomic<uint64_t> allocations = 0;
+    std::atomic<uint64_t> frame_allocations = 0;
+    // Only touched by frame
+    uint64_t frame_start = 0;
+};
+
+// Constant initialized, operator new can be called before any constructor runs
+static constinit Counters s_counters[size_t(Tag::Count)];
+
+static void add(Tag tag, size_t size)
+{
+    Counters& counters = s_counters[size_t(tag)];
+    int64_t live = counters.live_bytes.fetch_add(int64_t(size), std::memory_order_relaxed) + int64_t(size);
+    counters.live_count.fetch_add(1, std::memory_order_relaxed);
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    int64_t peak = counters.peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !counters.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    {
+    }
+}
+
+static void remove(Tag tag, size_t size)
+{
+    Counters& counters = s_counters[size_t(tag)];
+    counters.live_bytes.fetch_sub(int64_t(size), std::memory_order_relaxed);
+    counters.live_count.fetch_sub(1, std::memory_order_relaxed);
+}
+
+static Header& header(void* ptr)
+{
+    return *(Header*)((uint8_t*)ptr - HEADER_SIZE);
+}
+
+const char* tag_name(Tag tag)
+{
+    return tag_names[tag];
+}
+
+void* allocate(size_t size, size_t alignment, Tag tag)
+{
+    // malloc blocks are aligned for max_align_t, larger alignments need room to move the allocation forward
+    alignment = std::max(alignment, alignof(std::max_align_t));
+    size_t padding = HEADER_SIZE + alignment - alignof(std::max_align_t);
+    if (size > SIZE_MAX - padding)
+    {
+        return nullptr;
+    }
+    uint8_t* block = (uint8_t*)malloc(size + padding);
+    if (block == nullptr)
+    {
+        return nullptr;
+    }
+    uint8_t* ptr = (uint8_t*)((uintptr_t(block) + HEADER_SIZE + alignment - 1) & ~(uintptr_t(alignment) - 1));
+    new (ptr - HEADER_SIZE) Header{size, uint32_t(ptr - block), tag};
+    add(tag, size);
+    return ptr;
+}
+
+void* reallocate(void* ptr, size_t size)
+{
+    Header old_header = header(ptr);
+    ASSERT_MSG(old_header.offset == HEADER_SIZE, "Only allocations with the default alignment can be reallocated");
+    if (size > SIZE_MAX - HEADER_SIZE)
+    {
+        return nullptr;
+    }
+    uint8_t* block = (uint8_t*)realloc((uint8_t*)ptr - HEADER_SIZE, size + HEADER_SIZE);
+    if (block == nullptr)
+    {
+        return nullptr;
+    }
+    remove(old_header.tag, old_header.size);
+    add(old_header.tag, size);
+    void* new_ptr = block + HEADER_SIZE;
+    header(new_ptr).size = size;
+    return new_ptr;
+}
+
+void deallocate(void* ptr)
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+    const Header& ptr_header = header(ptr);
+    remove(ptr_header.tag, ptr_header.size);
+    free((uint8_t*)ptr - ptr_header.offset);
+}
+
+void track(Tag tag, size_t size)
+{
+    add(tag, size);
+}
+
+void untrack(Tag tag, size_t size)
+{
+    remove(tag, size);
+}
+
+Stats stats(Tag tag)
+{
+    const Counters& counters = s_counters[size_t(tag)];
+    Stats res;
+    res.live_bytes = counters.live_bytes.load(std::memory_order_relaxed);
+    res.peak_bytes = counters.peak_bytes.load(std::memory_order_relaxed);
+    res.live_count = counters.live_count.load(std::memory_order_relaxed);
+    res.allocations = counters.allocations.load(std::memory_order_relaxed);
+    res.frame_allocations = counters.frame_allocations.load(std::memory_order_relaxed);
+    return res;
+}
+
+Stats total_stats()
+{
+    Stats total;
+    for (size_t i = 0; i < size_t(Tag::Count); ++i)
+    {
+        Stats tag_stats = stats(Tag(i));
+        total.live_bytes += tag_stats.live_bytes;
+        total.peak_bytes += tag_stats.peak_bytes;
+        total.live_count += tag_stats.live_count;
+        total.allocations += tag_stats.allocations;
+        total.frame_allocations += tag_stats.frame_allocations;
+    }
+    return total;
+}
+
+void frame()
+{
+    uint64_t frame_allocations = 0;
+    for (Counters& counters : s_counters)
+    {
+        uint64_t allocations = counters.allocations.load(std::memory_order_relaxed);
+        counters.frame_allocations.store(allocations - counters.frame_start, std::memory_order_relaxed);
+        frame_allocations += allocations - counters.frame_start;
+        counters.frame_start = allocations;
+    }
+    PROFILE_COUNTER("allocations", frame_allocations);
+}
+
+static void print_bytes(FILE* file, int64_t bytes)
+{
+    static constexpr const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+    double value = double(bytes);
+    size_t unit = 0;
+    while (std::abs(value) >= 1024 && unit + 1 < std::size(units))
+    {
+        value /= 1024;
+        ++unit;
+    }
+    fprintf(file, " %10.2f %-2s", value, units[unit]);
+}
+
+static void print_stats(FILE* file, const char* name, const Stats& stats)
+{
+    fprintf(file, "%-16s", name);
+    print_bytes(file, stats.live_bytes);
+    print_bytes(file, stats.peak_bytes);
+    fprintf(file, " %12lld %14llu %12llu\n", (long long)stats.live_count, (unsigned long long)stats.allocations,
+            (unsigned long long)stats.frame_allocations);
+}
+
+void report(FILE* file)
+{
+    fprintf(file, "%-16s %13s %13s %12s %14s %12s\n", "Tag", "Live", "Peak", "Live count", "Allocations",
+            "Last frame");
+    for (size_t i = 0; i < size_t(Tag::Count); ++i)
+    {
+        print_stats(file, tag_names[Tag(i)], stats(Tag(i)));
+    }
+    print_stats(file, "Total", total_stats());
+    fflush(file);
+}
+} // namespace bul::memory
+
+#if defined(BUL_TRACK_ALLOCATIONS)
+// Replacements of the global allocation functions, counted against the tag of the calling thread
+static void* tracked_new(size_t size, size_t alignment)
+{
+    void* ptr = bul::memory::allocate(size, alignment, bul::memory::current_tag());
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new(size_t size)
+{
+    return tracked_new(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](size_t size)
+{
+    return tracked_new(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    return tracked_new(size, size_t(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return tracked_new(size, size_t(alignment));
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return bul::memory::allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__, bul::memory::current_tag());
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return bul::memory::allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__, bul::memory::current_tag());
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return bul::memory::allocate(size, size_t(alignment), bul::memory::current_tag());
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return bul::memory::allocate(size, size_t(alignment), bul::memory::current_tag());
+}
+
+void operator delete(void* ptr) noexcept
+{
+    bul::memory::deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    bul::memory::deallocate(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    bul::memory::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    bul::memory::deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    bul::memory::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+    bul::memory::deallocate(ptr);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept
+{
+    bul::memory::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept
+{
+    bul::memory::deallocate(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    bul::memory::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    bul::memory::deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    bul::memory::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    bul::memory::deallocate(ptr);
+}
+#endif
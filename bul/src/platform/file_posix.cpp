@@ -0,0 +1,193 @@
+#include "bul/file.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace bul
+{
+static size_t file_size(int fd)
+{
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        return 0;
+    }
+    return size_t(st.st_size);
+}
+
+// pread can return less than asked for, keeps going until size bytes are read or the end of the file
+static bool read_all(int fd, uint8_t* data, size_t size)
+{
+    size_t offset = 0;
+    while (offset < size)
+    {
+        ssize_t read = pread(fd, data + offset, size - offset, off_t(offset));
+        if (read < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (read <= 0)
+        {
+            return false;
+        }
+        offset += size_t(read);
+    }
+    return true;
+}
+
+size_t file_size(const char* path)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return 0;
+    }
+    size_t size = file_size(fd);
+    close(fd);
+    return size;
+}
+
+bool read_file(const char* path, uint8_t* data, size_t size)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+    bool res = read_all(fd, data, size);
+    close(fd);
+    return res;
+}
+
+bool read_file(const char* path, std::vector<uint8_t>& data)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+    data.resize(file_size(fd));
+    bool res = read_all(fd, data.data(), data.size());
+    close(fd);
+    return res;
+}
+
+bool write_file(const char* path, const uint8_t* data, size_t size)
+{
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+    size_t offset = 0;
+    while (offset < size)
+    {
+        ssize_t written = pwrite(fd, data + offset, size - offset, off_t(offset));
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            break;
+        }
+        offset += size_t(written);
+    }
+    close(fd);
+    return offset == size;
+}
+
+static int to_madvise(MappedFile::Access access)
+{
+    switch (access)
+    {
+    case MappedFile::Access::Sequential:
+        return MADV_SEQUENTIAL;
+    case MappedFile::Access::Random:
+        return MADV_RANDOM;
+    default:
+        return MADV_NORMAL;
+    }
+}
+
+MappedFile::MappedFile(const char* path, Access access)
+{
+    open(path, access);
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other)
+    : data_{std::exchange(other.data_, nullptr)}
+    , size_{std::exchange(other.size_, 0)}
+    , open_{std::exchange(other.open_, false)}
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other)
+{
+    if (this != &other)
+    {
+        close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        open_ = std::exchange(other.open_, false);
+    }
+    return *this;
+}
+
+bool MappedFile::open(const char* path, Access access)
+{
+    close();
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+    size_t size = file_size(fd);
+    void* data = nullptr;
+    if (size > 0)
+    {
+        data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    // The mapping keeps its own reference to the file
+    ::close(fd);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+    data_ = static_cast<const uint8_t*>(data);
+    size_ = size;
+    open_ = true;
+    advise(access);
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (size_ > 0)
+    {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    open_ = false;
+}
+
+void MappedFile::advise(Access access)
+{
+    if (size_ > 0)
+    {
+        madvise(const_cast<uint8_t*>(data_), size_, to_madvise(access));
+    }
+}
+} // namespace bul
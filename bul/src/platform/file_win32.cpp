@@ -0,0 +1,176 @@
+#include "bul/file.h"
+
+#include <cstdio>
+#include <utility>
+
+#include <windows.h>
+
+namespace bul
+{
+static size_t file_size(FILE* file)
+{
+    if (fseek(file, 0, SEEK_END) != 0)
+    {
+        return 0;
+    }
+    int64_t size = _ftelli64(file);
+    return size != -1 ? size : 0;
+}
+
+size_t file_size(const char* path)
+{
+    FILE* file = nullptr;
+    if (fopen_s(&file, path, "rb") != 0)
+    {
+        return 0;
+    }
+    size_t size = file_size(file);
+    fclose(file);
+    return size;
+}
+
+bool read_file(const char* path, uint8_t* data, size_t size)
+{
+    FILE* file = nullptr;
+    if (fopen_s(&file, path, "rb") != 0)
+    {
+        return false;
+    }
+    size_t read = fread(data, 1, size, file);
+    fclose(file);
+    return read == size;
+}
+
+bool read_file(const char* path, std::vector<uint8_t>& data)
+{
+    FILE* file = nullptr;
+    if (fopen_s(&file, path, "rb") != 0)
+    {
+        return false;
+    }
+    size_t size = file_size(file);
+    if (fseek(file, 0, SEEK_SET) != 0)
+    {
+        fclose(file);
+        return false;
+    }
+    data.resize(size);
+    size_t read = fread(data.data(), 1, size, file);
+    fclose(file);
+    return read == size;
+}
+
+bool write_file(const char* path, const uint8_t* data, size_t size)
+{
+    FILE* file = nullptr;
+    if (fopen_s(&file, path, "wb") != 0)
+    {
+        return false;
+    }
+    size_t written = fwrite(data, 1, size, file);
+    fclose(file);
+    return written == size;
+}
+
+static DWORD to_file_flags(MappedFile::Access access)
+{
+    switch (access)
+    {
+    case MappedFile::Access::Sequential:
+        return FILE_FLAG_SEQUENTIAL_SCAN;
+    case MappedFile::Access::Random:
+        return FILE_FLAG_RANDOM_ACCESS;
+    default:
+        return FILE_ATTRIBUTE_NORMAL;
+    }
+}
+
+MappedFile::MappedFile(const char* path, Access access)
+{
+    open(path, access);
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other)
+    : data_{std::exchange(other.data_, nullptr)}
+    , size_{std::exchange(other.size_, 0)}
+    , open_{std::exchange(other.open_, false)}
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other)
+{
+    if (this != &other)
+    {
+        close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        open_ = std::exchange(other.open_, false);
+    }
+    return *this;
+}
+
+// The read ahead hint is given when the file is opened, the cache manager uses it for the faults on the view too
+bool MappedFile::open(const char* path, Access access)
+{
+    close();
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, to_file_flags(access),
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return false;
+    }
+    void* data = nullptr;
+    // Empty files cannot be mapped
+    if (size.QuadPart > 0)
+    {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr)
+        {
+            data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            // The view keeps a reference to the mapping and the file
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+    if (size.QuadPart > 0 && data == nullptr)
+    {
+        return false;
+    }
+    data_ = static_cast<const uint8_t*>(data);
+    size_ = size_t(size.QuadPart);
+    open_ = true;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (data_ != nullptr)
+    {
+        UnmapViewOfFile(data_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    open_ = false;
+}
+
+// Windows has no equivalent of madvise for a view, sequential access prefetches the whole file instead
+void MappedFile::advise(Access access)
+{
+    if (access == Access::Sequential && size_ > 0)
+    {
+        WIN32_MEMORY_RANGE_ENTRY range = {const_cast<uint8_t*>(data_), size_};
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+}
+} // namespace bul
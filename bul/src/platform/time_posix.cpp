@@ -0,0 +1,196 @@
+#include "bul/time.h"
+
+#include <ctime>
+
+#if defined(BUL_TIMER_TSC) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#include <x86intrin.h>
+#define BUL_HAS_TSC
+#endif
+
+namespace bul
+{
+static int64_t clock_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * Timer::NS + ts.tv_nsec;
+}
+
+#if defined(BUL_HAS_TSC)
+// The TSC only ticks at a constant rate that is shared by all cores when the cpu advertises an invariant TSC
+static bool has_invariant_tsc()
+{
+    unsigned eax, ebx, ecx, edx;
+    if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0)
+    {
+        return false;
+    }
+    return (edx & (1u << 8)) != 0;
+}
+
+// Counts the TSC ticks over 10ms of CLOCK_MONOTONIC, good to a few parts per million
+static int64_t get_tsc_frequency()
+{
+    if (!has_invariant_tsc())
+    {
+        return 0;
+    }
+    int64_t ns_start = clock_ns();
+    int64_t tsc_start = int64_t(__rdtsc());
+    int64_t ns_end = ns_start;
+    while (ns_end - ns_start < 10'000'000)
+    {
+        ns_end = clock_ns();
+    }
+    int64_t tsc_end = int64_t(__rdtsc());
+    return int64_t(double(tsc_end - tsc_start) * Timer::NS / double(ns_end - ns_start));
+}
+
+// Calibrated on first use rather than during static initialization, where timers of other translation units could
+// read it before it is set
+static int64_t tsc_frequency()
+{
+    static const int64_t frequency = get_tsc_frequency();
+    return frequency;
+}
+
+static int64_t get_perf_frequency()
+{
+    return tsc_frequency() != 0 ? tsc_frequency() : Timer::NS;
+}
+
+static int64_t get_perf_counter()
+{
+    return tsc_frequency() != 0 ? int64_t(__rdtsc()) : clock_ns();
+}
+#else
+static int64_t get_perf_frequency()
+{
+    return Timer::NS;
+}
+
+static int64_t get_perf_counter()
+{
+    return clock_ns();
+}
+#endif
+
+// Starts on first use, so that nothing calibrates the TSC during static initialization
+static Timer& global_timer()
+{
+    static Timer timer;
+    return timer;
+}
+
+namespace time
+{
+double total_s()
+{
+    return global_timer().total_s();
+}
+
+double total_ms()
+{
+    return global_timer().total_ms();
+}
+
+double total_us()
+{
+    return global_timer().total_us();
+}
+
+double total_ns()
+{
+    return global_timer().total_ns();
+}
+
+double delta_s()
+{
+    return global_timer().delta_s();
+}
+
+double delta_ms()
+{
+    return global_timer().delta_ms();
+}
+
+double delta_us()
+{
+    return global_timer().delta_us();
+}
+
+double delta_ns()
+{
+    return global_timer().delta_ns();
+}
+
+void update()
+{
+    global_timer().update();
+}
+
+int64_t ticks()
+{
+    return get_perf_counter();
+}
+
+int64_t tick_frequency()
+{
+    return get_perf_frequency();
+}
+} // namespace time
+
+Timer::Timer()
+{
+    start_time_ = get_perf_counter();
+    prev_time_ = start_time_;
+}
+
+double Timer::total_s() const
+{
+    return double(get_perf_counter() - start_time_) * S / get_perf_frequency();
+}
+
+double Timer::total_ms() const
+{
+    return double(get_perf_counter() - start_time_) * MS / get_perf_frequency();
+}
+
+double Timer::total_us() const
+{
+    return double(get_perf_counter() - start_time_) * US / get_perf_frequency();
+}
+
+double Timer::total_ns() const
+{
+    return double(get_perf_counter() - start_time_) * NS / get_perf_frequency();
+}
+
+double Timer::delta_s()
+{
+    return delta_ * S;
+}
+
+double Timer::delta_ms()
+{
+    return delta_ * MS;
+}
+
+double Timer::delta_us()
+{
+    return delta_ * US;
+}
+
+double Timer::delta_ns()
+{
+    return delta_ * NS;
+}
+
+void Timer::update()
+{
+    int64_t cur_time = get_perf_counter();
+    delta_ = double(cur_time - prev_time_) / get_perf_frequency();
+    prev_time_ = cur_time;
+}
+} // namespace bul
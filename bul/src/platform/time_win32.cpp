@@ -67,6 +67,16 @@ void update()
 {
     global_timer.update();
 }
+
+int64_t ticks()
+{
+    return get_perf_counter();
+}
+
+int64_t tick_frequency()
+{
+    return perf_frequency;
+}
 } // namespace Time
 
 Timer::Timer()
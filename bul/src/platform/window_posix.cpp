@@ -0,0 +1,83 @@
+#include "bul/window.h"
+
+#include "bul/input.h"
+
+/*
+ * Headless window: there is no surface to present to, it only keeps the state the rest of bul expects so that code
+ * driven by a window loop (tests, benchmarks, offline tools) runs unchanged. poll_events never returns any event.
+ */
+namespace bul::window
+{
+static std::vector<Event> events;
+static vec2u size_ = {0, 0};
+static bool should_close_ = false;
+static bool resized_ = false;
+static bool cursor_visible_ = true;
+
+void create(const std::string_view, vec2u size)
+{
+    size_ = size;
+    should_close_ = false;
+    resized_ = false;
+}
+
+void destroy()
+{
+    events.clear();
+}
+
+void close()
+{
+    size_ = {0, 0};
+    should_close_ = true;
+}
+
+bool should_close()
+{
+    return should_close_;
+}
+
+void* handle()
+{
+    return nullptr;
+}
+
+vec2u size()
+{
+    return size_;
+}
+
+bool resized()
+{
+    bool ret = resized_;
+    resized_ = false;
+    return ret;
+}
+
+float aspect_ratio()
+{
+    return static_cast<float>(size_.x) / static_cast<float>(size_.y);
+}
+
+vec2i cursor_pos()
+{
+    return {0, 0};
+}
+
+void show_cursor(bool show)
+{
+    cursor_visible_ = show;
+}
+
+bool cursor_visible()
+{
+    return cursor_visible_;
+}
+
+const std::vector<Event>& poll_events()
+{
+    events.clear();
+    input::_private::new_frame();
+    return events;
+}
+} // namespace bul::window
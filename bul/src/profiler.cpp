@@ -0,0 +1,369 @@
+#include "bul/profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+
+#include "bul/containers/spsc_queue.h"
+#include "bul/time.h"
+
+namespace bul::profiler
+{
+// Enough for a few frames of a thread busy with small scopes, what does not fit before the next frame is dropped
+static constexpr size_t SCOPE_CAPACITY = 16384;
+static constexpr size_t COUNTER_CAPACITY = 1024;
+static constexpr size_t HISTORY_SIZE = 256;
+// Track of the frames in the trace, next to the threads
+static constexpr uint32_t FRAME_TRACK = UINT32_MAX;
+
+struct ScopeEvent
+{
+    const char* name;
+    int64_t begin;
+    int64_t end;
+    uint32_t depth;
+};
+
+struct CounterEvent
+{
+    const char* name;
+    int64_t time;
+    double value;
+};
+
+struct ThreadBuffer
+{
+    uint32_t id = 0;
+    // Only touched under the profiler lock
+    std::string name;
+    // Only touched by the owning thread
+    uint32_t depth = 0;
+    std::atomic<uint64_t> dropped = 0;
+    // Set when the owning thread exits, the buffer is freed once collected
+    std::atomic<bool> orphaned = false;
+    SpscQueue<ScopeEvent, SCOPE_CAPACITY> scopes;
+    SpscQueue<CounterEvent, COUNTER_CAPACITY> counters;
+};
+
+class Profiler
+{
+public:
+    ~Profiler()
+    {
+        for (ThreadBuffer* thread : threads_)
+        {
+            delete thread;
+        }
+    }
+
+    ThreadBuffer* add_thread()
+    {
+        ThreadBuffer* thread = new ThreadBuffer;
+        std::lock_guard lock{mutex_};
+        thread->id = next_thread_id_++;
+        thread->name = "thread " + std::to_string(thread->id);
+        threads_.push_back(thread);
+        return thread;
+    }
+
+    void set_name(ThreadBuffer& thread, const char* name)
+    {
+        std::lock_guard lock{mutex_};
+        thread.name = name;
+    }
+
+    void frame()
+    {
+        int64_t now = time::ticks();
+        std::lock_guard lock{mutex_};
+        FrameRecord record;
+        record.begin_us = to_us(frame_begin_);
+        record.duration_us = double(now - frame_begin_) * us_per_tick_;
+        frame_begin_ = now;
+        collect(record);
+
+        history_.push_back(float(record.duration_us / 1'000));
+        if (history_.size() > HISTORY_SIZE)
+        {
+            history_.erase(history_.begin());
+        }
+        if (capturing_)
+        {
+            capture_.push_back(record);
+        }
+        last_ = std::move(record);
+    }
+
+    FrameRecord last_frame()
+    {
+        std::lock_guard lock{mutex_};
+        return last_;
+    }
+
+    std::vector<float> history()
+    {
+        std::lock_guard lock{mutex_};
+        return history_;
+    }
+
+    void begin_capture()
+    {
+        std::lock_guard lock{mutex_};
+        capturing_ = true;
+        capture_.clear();
+    }
+
+    bool end_capture(const char* path)
+    {
+        std::lock_guard lock{mutex_};
+        capturing_ = false;
+        bool written = write_chrome_trace(path);
+        capture_.clear();
+        return written;
+    }
+
+    bool capturing()
+    {
+        std::lock_guard lock{mutex_};
+        return capturing_;
+    }
+
+private:
+    double to_us(int64_t ticks) const
+    {
+        return double(ticks - origin_) * us_per_tick_;
+    }
+
+    void collect(FrameRecord& record)
+    {
+        for (size_t i = 0; i < threads_.size();)
+        {
+            ThreadBuffer* thread = threads_[i];
+            // Read before draining, nothing is recorded after the flag is set
+            bool orphaned = thread->orphaned.load(std::memory_order_acquire);
+            ScopeEvent scope;
+            while (thread->scopes.pop_front(scope))
+            {
+                record.scopes.push_back(ScopeRecord{scope.name, to_us(scope.begin),
+                                                    double(scope.end - scope.begin) * us_per_tick_, scope.depth,
+                                                    thread->id});
+            }
+            CounterEvent counter;
+            while (thread->counters.pop_front(counter))
+            {
+                record.counters.push_back(CounterRecord{counter.name, to_us(counter.time), counter.value});
+            }
+            record.dropped += thread->dropped.exchange(0, std::memory_order_relaxed);
+            record.threads.push_back(ThreadRecord{thread->id, thread->name});
+
+            if (orphaned)
+            {
+                delete thread;
+                threads_.erase(threads_.begin() + i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+        // Scopes are recorded when they end, after their children
+        std::sort(record.scopes.begin(), record.scopes.end(), [](const ScopeRecord& a, const ScopeRecord& b) {
+            if (a.thread != b.thread)
+            {
+                return a.thread < b.thread;
+            }
+            return a.begin_us != b.begin_us ? a.begin_us < b.begin_us : a.depth < b.depth;
+        });
+    }
+
+    static void write_json_string(FILE* file, const char* str)
+    {
+        fputc('"', file);
+        for (; *str != '\0'; ++str)
+        {
+            if (*str == '"' || *str == '\\')
+            {
+                fputc('\\', file);
+                fputc(*str, file);
+            }
+            else if ((unsigned char)*str < 0x20)
+            {
+                fprintf(file, "\\u%04x", *str);
+            }
+            else
+            {
+                fputc(*str, file);
+            }
+        }
+        fputc('"', file);
+    }
+
+    // Trace Event Format: complete events for the scopes and frames, counter events, metadata for the thread names
+    bool write_chrome_trace(const char* path)
+    {
+        FILE* file = fopen(path, "wb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        std::vector<ThreadRecord> threads;
+        for (const FrameRecord& frame : capture_)
+        {
+            for (const ThreadRecord& thread : frame.threads)
+            {
+                auto it = std::find_if(threads.begin(), threads.end(),
+                                       [&](const ThreadRecord& known) { return known.id == thread.id; });
+                if (it == threads.end())
+                {
+                    threads.push_back(thread);
+                }
+                else
+                {
+                    it->name = thread.name;
+                }
+            }
+        }
+        threads.push_back(ThreadRecord{FRAME_TRACK, "Frames"});
+
+        fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+        const char* separator = "";
+        for (const ThreadRecord& thread : threads)
+        {
+            fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":", separator,
+                    thread.id);
+            write_json_string(file, thread.name.c_str());
+            fprintf(file, "}}");
+            separator = ",\n";
+        }
+        for (const FrameRecord& frame : capture_)
+        {
+            fprintf(file, ",\n{\"name\":\"Frame\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    FRAME_TRACK, frame.begin_us, frame.duration_us);
+            for (const ScopeRecord& scope : frame.scopes)
+            {
+                fprintf(file, ",\n{\"name\":");
+                write_json_string(file, scope.name);
+                fprintf(file, ",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", scope.thread,
+                        scope.begin_us, scope.duration_us);
+            }
+            for (const CounterRecord& counter : frame.counters)
+            {
+                fprintf(file, ",\n{\"name\":");
+                write_json_string(file, counter.name);
+                fprintf(file, ",\"ph\":\"C\",\"pid\":0,\"ts\":%.3f,\"args\":{\"value\":%.17g}}", counter.time_us,
+                        counter.value);
+            }
+        }
+        fprintf(file, "\n]}\n");
+        bool ok = ferror(file) == 0;
+        return fclose(file) == 0 && ok;
+    }
+
+    std::mutex mutex_;
+    std::vector<ThreadBuffer*> threads_;
+    uint32_t next_thread_id_ = 0;
+
+    int64_t origin_ = time::ticks();
+    double us_per_tick_ = 1'000'000.0 / double(time::tick_frequency());
+    int64_t frame_begin_ = origin_;
+    FrameRecord last_;
+    std::vector<float> history_;
+
+    bool capturing_ = false;
+    std::vector<FrameRecord> capture_;
+};
+
+static Profiler& profiler()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+struct ThreadState
+{
+    ThreadBuffer* buffer = nullptr;
+
+    ~ThreadState()
+    {
+        if (buffer != nullptr)
+        {
+            buffer->orphaned.store(true, std::memory_order_release);
+        }
+    }
+};
+
+static thread_local ThreadState t_thread;
+
+static ThreadBuffer& thread_buffer()
+{
+    if (t_thread.buffer == nullptr)
+    {
+        t_thread.buffer = profiler().add_thread();
+    }
+    return *t_thread.buffer;
+}
+
+Scope::Scope(const char* name) : name_(name)
+{
+    ThreadBuffer& buffer = thread_buffer();
+    depth_ = buffer.depth++;
+    begin_ = time::ticks();
+}
+
+Scope::~Scope()
+{
+    int64_t end = time::ticks();
+    ThreadBuffer& buffer = *t_thread.buffer;
+    --buffer.depth;
+    if (!buffer.scopes.push_back(ScopeEvent{name_, begin_, end, depth_}))
+    {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void set_thread_name(const char* name)
+{
+    profiler().set_name(thread_buffer(), name);
+}
+
+void counter(const char* name, double value)
+{
+    ThreadBuffer& buffer = thread_buffer();
+    if (!buffer.counters.push_back(CounterEvent{name, time::ticks(), value}))
+    {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void frame()
+{
+    profiler().frame();
+}
+
+FrameRecord last_frame()
+{
+    return profiler().last_frame();
+}
+
+std::vector<float> frame_history_ms()
+{
+    return profiler().history();
+}
+
+void begin_capture()
+{
+    profiler().begin_capture();
+}
+
+bool end_capture(const char* path)
+{
+    return profiler().end_capture(path);
+}
+
+bool capturing()
+{
+    return profiler().capturing();
+}
+} // namespace bul::profiler
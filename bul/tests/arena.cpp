@@ -0,0 +1,101 @@
+#include "doctest.h"
+
+#include "bul/arena.h"
+
+TEST_SUITE_BEGIN("arena");
+
+TEST_CASE("alignment")
+{
+    bul::Arena arena(256);
+    arena.allocate(1, 1);
+    void* p16 = arena.allocate(16, 16);
+    arena.allocate(3, 1);
+    void* p64 = arena.allocate(8, 64);
+    CHECK((uintptr_t)p16 % 16 == 0);
+    CHECK((uintptr_t)p64 % 64 == 0);
+    CHECK(arena.stats().allocations == 4);
+}
+
+TEST_CASE("blocks are reused after reset")
+{
+    bul::Arena arena(128);
+    for (int i = 0; i < 16; ++i)
+    {
+        arena.allocate(100);
+    }
+    arena.allocate(1000);
+    size_t heap_allocations = arena.stats().heap_allocations;
+    CHECK(heap_allocations == 17);
+
+    for (int frame = 0; frame < 8; ++frame)
+    {
+        arena.reset();
+        for (int i = 0; i < 16; ++i)
+        {
+            arena.allocate(100);
+        }
+        arena.allocate(1000);
+    }
+    CHECK(arena.stats().heap_allocations == heap_allocations);
+}
+
+TEST_CASE("external buffer")
+{
+    alignas(16) uint8_t buffer[512];
+    bul::Arena arena(buffer, sizeof(buffer), 1024);
+    uint8_t* p = (uint8_t*)arena.allocate(256);
+    CHECK(p >= buffer);
+    CHECK(p + 256 <= buffer + sizeof(buffer));
+    CHECK(arena.stats().heap_allocations == 0);
+
+    arena.allocate(512);
+    CHECK(arena.stats().heap_allocations == 1);
+}
+
+TEST_CASE("rewind")
+{
+    bul::Arena arena(1024);
+    arena.allocate(64);
+    auto marker = arena.mark();
+    void* a = arena.allocate(64);
+    arena.allocate(2048);
+    arena.rewind(marker);
+    CHECK(arena.allocate(64) == a);
+    CHECK(arena.stats().bytes == 128);
+}
+
+TEST_CASE("vector")
+{
+    bul::Arena arena(1024);
+    bul::ArenaVector<int> values{arena};
+    values.reserve(100);
+    for (int i = 0; i < 100; ++i)
+    {
+        values.push_back(i);
+    }
+    CHECK(values[99] == 99);
+    CHECK(arena.stats().allocations == 1);
+}
+
+TEST_CASE("frame arena steady state")
+{
+    bul::FrameArena scratch(1024);
+    size_t heap_allocations = 0;
+    for (int frame = 0; frame < 16; ++frame)
+    {
+        scratch.begin_frame();
+        auto values = scratch.vector<uint64_t>();
+        values.reserve(200);
+        values.resize(200, frame);
+        int* previous = scratch.arena().create<int>(frame);
+        CHECK(*previous == frame);
+        if (frame == 2)
+        {
+            heap_allocations = scratch.heap_allocations();
+        }
+        CHECK(scratch.last_frame_allocations() == (frame == 0 ? 0 : 2));
+    }
+    CHECK(scratch.heap_allocations() == heap_allocations);
+}
+
+TEST_SUITE_END();
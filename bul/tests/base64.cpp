@@ -0,0 +1,95 @@
+#include "doctest.h"
+
+#include <string>
+
+#include "bul/base64.h"
+
+TEST_SUITE_BEGIN("base64");
+
+static std::string encode(const std::vector<uint8_t>& data)
+{
+    constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string str;
+    for (size_t i = 0; i < data.size(); i += 3)
+    {
+        uint32_t v = data[i] << 16;
+        v |= i + 1 < data.size() ? data[i + 1] << 8 : 0;
+        v |= i + 2 < data.size() ? data[i + 2] : 0;
+        str += alphabet[(v >> 18) & 63];
+        str += alphabet[(v >> 12) & 63];
+        str += i + 1 < data.size() ? alphabet[(v >> 6) & 63] : '=';
+        str += i + 2 < data.size() ? alphabet[v & 63] : '=';
+    }
+    return str;
+}
+
+static std::string decode(std::string_view str)
+{
+    std::vector<uint8_t> data;
+    REQUIRE(bul::base64_decode(str, data));
+    return std::string(data.begin(), data.end());
+}
+
+TEST_CASE("rfc 4648 vectors")
+{
+    CHECK(decode("") == "");
+    CHECK(decode("Zg==") == "f");
+    CHECK(decode("Zm8=") == "fo");
+    CHECK(decode("Zm9v") == "foo");
+    CHECK(decode("Zm9vYg==") == "foob");
+    CHECK(decode("Zm9vYmE=") == "fooba");
+    CHECK(decode("Zm9vYmFy") == "foobar");
+}
+
+TEST_CASE("unpadded")
+{
+    CHECK(decode("Zg") == "f");
+    CHECK(decode("Zm8") == "fo");
+    CHECK(bul::base64_decoded_size("Zm8") == 2);
+}
+
+TEST_CASE("invalid input")
+{
+    std::vector<uint8_t> data;
+    CHECK_FALSE(bul::base64_decode("Z", data));
+    CHECK_FALSE(bul::base64_decode("Zm9v!mFy", data));
+    CHECK_FALSE(bul::base64_decode("Zg==Zg==", data));
+}
+
+TEST_CASE("all sizes and alignments")
+{
+    std::vector<uint8_t> data;
+    for (uint32_t size = 0; size < 300; ++size)
+    {
+        data.push_back((uint8_t)(size * 167 + 13));
+        std::string str = encode(data);
+        std::vector<uint8_t> decoded;
+        REQUIRE(bul::base64_decode(str, decoded));
+        CHECK(decoded == data);
+
+        std::vector<uint8_t> scalar(bul::base64_decoded_size(str));
+        REQUIRE(bul::base64_decode_scalar(str, scalar.data()));
+        CHECK(scalar == data);
+    }
+}
+
+TEST_CASE("invalid character in vectorized block")
+{
+    std::vector<uint8_t> data(3000);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = (uint8_t)(i * 31);
+    }
+    std::string str = encode(data);
+    for (size_t pos : {0, 17, 40, 1000, 3000, 3990})
+    {
+        std::string corrupted = str;
+        corrupted[pos] = '\x80';
+        std::vector<uint8_t> decoded;
+        CHECK_FALSE(bul::base64_decode(corrupted, decoded));
+        corrupted[pos] = '-';
+        CHECK_FALSE(bul::base64_decode(corrupted, decoded));
+    }
+}
+
+TEST_SUITE_END();
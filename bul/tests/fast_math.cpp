@@ -0,0 +1,125 @@
+#include "doctest.h"
+
+#include <bit>
+#include <cmath>
+#include <limits>
+
+#include "bul/math/fast.h"
+
+TEST_SUITE_BEGIN("fast math");
+
+// Floats ordered like integers, negative floats have their bits flipped so that the order is kept
+static uint32_t to_ordered(float f)
+{
+    uint32_t bits = std::bit_cast<uint32_t>(f);
+    return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+}
+
+static float from_ordered(uint32_t u)
+{
+    return std::bit_cast<float>((u & 0x80000000u) ? u & 0x7fffffffu : ~u);
+}
+
+// Distance between result and the exact value in ULP of the exact value
+static double ulp_error(float result, double exact)
+{
+    float magnitude = std::abs(float(exact));
+    float ulp = magnitude > 0 ? std::nextafter(magnitude, std::numeric_limits<float>::infinity()) - magnitude
+                              : std::numeric_limits<float>::denorm_min();
+    return std::abs(double(result) - exact) / ulp;
+}
+
+// Every stride-th float of [lo, hi], 1 goes through all of them
+template <typename F, typename R>
+static double max_ulp_error(float lo, float hi, uint32_t stride, F fn, R exact)
+{
+    double max_error = 0;
+    uint32_t end = to_ordered(hi);
+    for (uint64_t u = to_ordered(lo); u <= end; u += stride)
+    {
+        float x = from_ordered(uint32_t(u));
+        max_error = std::max(max_error, ulp_error(fn(x), exact(double(x))));
+    }
+    return max_error;
+}
+
+static constexpr float MIN_NORMAL = std::numeric_limits<float>::min();
+static constexpr float MAX_FLOAT = std::numeric_limits<float>::max();
+static constexpr float PI = 3.14159265f;
+
+static double srgb_to_linear(double x)
+{
+    return x <= 0.04045 ? x / 12.92 : std::pow((x + 0.055) / 1.055, 2.4);
+}
+
+static double linear_to_srgb(double x)
+{
+    return x <= 0.0031308 ? x * 12.92 : 1.055 * std::pow(x, 1.0 / 2.4) - 0.055;
+}
+
+// Checks the bounds documented in fast.h
+static void check_accuracy(uint32_t stride)
+{
+    CHECK(max_ulp_error(-126.0f, 127.0f, stride, bul::fast::exp2, [](double x) { return std::exp2(x); }) <= 1.3);
+    CHECK(max_ulp_error(MIN_NORMAL, MAX_FLOAT, stride, bul::fast::log2, [](double x) { return std::log2(x); }) <= 2.1);
+    CHECK(max_ulp_error(MIN_NORMAL, MAX_FLOAT, stride, bul::fast::rsqrt, [](double x) { return 1.0 / std::sqrt(x); })
+          <= 3.2);
+    CHECK(max_ulp_error(-PI, PI, stride, bul::fast::sin, [](double x) { return std::sin(x); }) <= 1.5);
+    CHECK(max_ulp_error(-PI, PI, stride, bul::fast::cos, [](double x) { return std::cos(x); }) <= 1.5);
+    CHECK(max_ulp_error(0.0f, 1.0f, stride, bul::fast::srgb_to_linear, srgb_to_linear) <= 15.0);
+    CHECK(max_ulp_error(0.0f, 1.0f, stride, bul::fast::linear_to_srgb, linear_to_srgb) <= 8.5);
+}
+
+TEST_CASE("accuracy")
+{
+    check_accuracy(251);
+}
+
+// Takes a few minutes, run it with --no-skip after changing fast.h
+TEST_CASE("exhaustive accuracy" * doctest::skip())
+{
+    check_accuracy(1);
+}
+
+TEST_CASE("sincos large inputs")
+{
+    for (float x = -8192.0f; x <= 8192.0f; x += 0.37f)
+    {
+        float s;
+        float c;
+        bul::fast::sincos(x, s, c);
+        CHECK(std::abs(s - std::sin(double(x))) <= 8e-8);
+        CHECK(std::abs(c - std::cos(double(x))) <= 8e-8);
+    }
+}
+
+TEST_CASE("pow")
+{
+    for (float y : {-1.0f, 0.1f, 0.5f, 1.0f / 2.4f, 2.4f, 3.0f, 7.0f})
+    {
+        double max_error = 0;
+        for (float x = 1.0f / 1024.0f; x <= 1024.0f; x *= 1.001f)
+        {
+            double bound = 1.5 + 2.0 * std::abs(y * std::log2(x));
+            max_error = std::max(max_error, ulp_error(bul::fast::pow(x, y), std::pow(double(x), double(y))) / bound);
+        }
+        CHECK(max_error <= 1.0);
+    }
+}
+
+TEST_CASE("exact values")
+{
+    CHECK(bul::fast::exp2(0.0f) == 1.0f);
+    CHECK(bul::fast::exp2(10.0f) == 1024.0f);
+    CHECK(bul::fast::exp2(-3.0f) == 0.125f);
+    CHECK(bul::fast::log2(1.0f) == 0.0f);
+    CHECK(bul::fast::log2(1024.0f) == 10.0f);
+    CHECK(bul::fast::sin(0.0f) == 0.0f);
+    CHECK(bul::fast::cos(0.0f) == 1.0f);
+    CHECK(bul::fast::srgb_to_linear(0.0f) == 0.0f);
+    CHECK(bul::fast::linear_to_srgb(0.0f) == 0.0f);
+    CHECK(bul::fast::srgb_to_linear(1.0f) == doctest::Approx(1.0f));
+    CHECK(bul::fast::linear_to_srgb(1.0f) == doctest::Approx(1.0f));
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,78 @@
+#include "doctest.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "bul/file.h"
+
+TEST_SUITE_BEGIN("file");
+
+static std::string temp_path(const char* name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static std::vector<uint8_t> pattern(size_t size)
+{
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        data[i] = uint8_t(i * 31 + (i >> 8));
+    }
+    return data;
+}
+
+TEST_CASE("read write")
+{
+    std::string path = temp_path("bul_file_read_write");
+    std::vector<uint8_t> data = pattern(100'000);
+    REQUIRE(bul::write_file(path.c_str(), data.data(), data.size()));
+    CHECK(bul::file_size(path.c_str()) == data.size());
+
+    std::vector<uint8_t> read;
+    CHECK(bul::read_file(path.c_str(), read));
+    CHECK(read == data);
+
+    std::vector<uint8_t> too_large(data.size() + 1);
+    CHECK(!bul::read_file(path.c_str(), too_large.data(), too_large.size()));
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("mapped file")
+{
+    std::string path = temp_path("bul_file_mapped");
+    std::vector<uint8_t> data = pattern(3 * 4096 + 5);
+    REQUIRE(bul::write_file(path.c_str(), data.data(), data.size()));
+
+    bul::MappedFile file(path.c_str(), bul::MappedFile::Access::Random);
+    REQUIRE(file.is_open());
+    std::span<const uint8_t> bytes = file;
+    CHECK(std::vector<uint8_t>(bytes.begin(), bytes.end()) == data);
+    file.advise(bul::MappedFile::Access::Sequential);
+
+    bul::MappedFile moved = std::move(file);
+    CHECK(!file.is_open());
+    CHECK(file.span().empty());
+    REQUIRE(moved.size() == data.size());
+    CHECK(moved.data()[data.size() - 1] == data.back());
+
+    moved.close();
+    CHECK(!moved.is_open());
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("mapped file edge cases")
+{
+    CHECK(!bul::MappedFile(temp_path("bul_file_missing").c_str()).is_open());
+
+    std::string path = temp_path("bul_file_empty");
+    REQUIRE(bul::write_file(path.c_str(), nullptr, 0));
+    bul::MappedFile file(path.c_str());
+    CHECK(file.is_open());
+    CHECK(file.size() == 0);
+    file.close();
+    std::filesystem::remove(path);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,79 @@
+#include "doctest.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "bul/format.h"
+
+TEST_SUITE_BEGIN("format");
+
+TEST_CASE("integers")
+{
+    CHECK(std::string_view(bul::format("{}", 0)) == "0");
+    CHECK(std::string_view(bul::format("{} {}", -42, 42u)) == "-42 42");
+    CHECK(std::string_view(bul::format("{}", INT64_MIN)) == "-9223372036854775808");
+    CHECK(std::string_view(bul::format("{}", UINT64_MAX)) == "18446744073709551615");
+    CHECK(std::string_view(bul::format("{:x}", 0xdeadbeefu)) == "deadbeef");
+    CHECK(std::string_view(bul::format("{}", uint8_t(200))) == "200");
+
+    enum class E : int16_t
+    {
+        A = -3
+    };
+    CHECK(std::string_view(bul::format("{}", E::A)) == "-3");
+}
+
+TEST_CASE("floats")
+{
+    CHECK(std::string_view(bul::format("{}", 0.1)) == "0.1");
+    CHECK(std::string_view(bul::format("{}", 0.1f)) == "0.1");
+    CHECK(std::string_view(bul::format("{}", -2.5)) == "-2.5");
+    CHECK(std::string_view(bul::format("{}", 1e300)) == "1e+300");
+    CHECK(std::string_view(bul::format("{:.3}", 3.14159)) == "3.142");
+    CHECK(std::string_view(bul::format("{:.0}", 2.0f)) == "2");
+    CHECK(std::string_view(bul::format("{:.2}", 1e20)) == "100000000000000000000.00");
+}
+
+TEST_CASE("strings, chars, bools and pointers")
+{
+    const char* null = nullptr;
+    char buffer[] = "mutable";
+    std::string string = "string";
+    std::string_view view = "view";
+    CHECK(std::string_view(bul::format("{} {} {} {} {}", "literal", buffer, string, view, null))
+          == "literal mutable string view (null)");
+    CHECK(std::string_view(bul::format("{}{}", 'a', 'b')) == "ab");
+    CHECK(std::string_view(bul::format("{} {}", true, false)) == "true false");
+    CHECK(std::string_view(bul::format("{}", (void*)0x1234)) == "0x1234");
+    CHECK(std::string_view(bul::format("{:x}", (const int*)0xabc)) == "0xabc");
+}
+
+TEST_CASE("braces")
+{
+    CHECK(std::string_view(bul::format("")) == "");
+    CHECK(std::string_view(bul::format("no placeholder")) == "no placeholder");
+    CHECK(std::string_view(bul::format("{{}}")) == "{}");
+    CHECK(std::string_view(bul::format("{{{}}}", 1)) == "{1}");
+    CHECK(std::string_view(bul::format("a{{b}}c{}d", 2)) == "a{b}c2d");
+}
+
+TEST_CASE("the buffer grows")
+{
+    std::string long_string(10'000, 'x');
+    std::string_view text = bul::format("[{}] [{}]", long_string, long_string);
+    CHECK(text.size() == 2 * long_string.size() + 5);
+    CHECK(text == "[" + long_string + "] [" + long_string + "]");
+    // Shorter results after a long one are still terminated at the right place
+    CHECK(std::string_view(bul::format("{}", 1)) == "1");
+}
+
+TEST_CASE("formatf")
+{
+    CHECK(std::string_view(bul::formatf("%d %s %.2f", -1, "two", 3.0)) == "-1 two 3.00");
+    std::string long_string(1000, 'y');
+    CHECK(std::string_view(bul::formatf("%s!", long_string.c_str())) == long_string + "!");
+    CHECK(std::string_view(bul::formatf("%s", "")) == "");
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,88 @@
+#include "doctest.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bul/hash.h"
+
+TEST_SUITE_BEGIN("hash");
+
+TEST_CASE("reference values")
+{
+    // XXH3 of the empty input with the default secret
+    CHECK(bul::hash(nullptr, 0) == 0x2D06800538D394C2ull);
+    CHECK(bul::hash128(nullptr, 0) == bul::Hash128{0x6001C324468D497Full, 0x99AA06D3014798D8ull});
+}
+
+TEST_CASE("values are hashed by their bytes")
+{
+    std::string string = "hello world";
+    std::string_view view = string;
+    CHECK(bul::hash(string) == bul::hash(string.data(), string.size()));
+    CHECK(bul::hash(view) == bul::hash(string));
+    CHECK(bul::hash("hello world") == bul::hash(string));
+
+    uint64_t value = 0x0123456789abcdef;
+    CHECK(bul::hash(value) == bul::hash(&value, sizeof(value)));
+
+    // Every element, not one byte per element
+    std::vector<uint32_t> values = {1, 2, 3, 4};
+    CHECK(bul::hash(values) == bul::hash(values.data(), values.size() * sizeof(uint32_t)));
+    std::vector<uint32_t> other = {1, 2, 3, 5};
+    CHECK(bul::hash(values) != bul::hash(other));
+
+    CHECK(bul::hash128(string) == bul::hash128(string.data(), string.size()));
+}
+
+TEST_CASE("seeds")
+{
+    uint32_t value = 42;
+    CHECK(bul::hash_seeded(value, 0) == bul::hash(value));
+    CHECK(bul::hash_seeded(value, 1) == bul::hash(&value, sizeof(value), 1));
+    CHECK(bul::hash_seeded(value, 1) != bul::hash(value));
+    CHECK(bul::hash128(&value, sizeof(value), 1) != bul::hash128(value));
+}
+
+TEST_CASE("streaming")
+{
+    struct
+    {
+        uint32_t a;
+        float b;
+        uint64_t c;
+    } fields{1, 2.0f, 3};
+    uint64_t expected = bul::hash(fields);
+    bul::Hasher hasher;
+    hasher.add(fields.a).add(fields.b).add(fields.c);
+    CHECK(hasher.digest() == expected);
+    CHECK(hasher.digest128() == bul::hash128(fields));
+
+    // Past the internal buffer of the state
+    std::vector<uint8_t> data(10'000);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = uint8_t(i * 7);
+    }
+    for (uint64_t seed : {0ull, 12345ull})
+    {
+        bul::Hasher streamed{seed};
+        for (size_t i = 0; i < data.size(); i += 333)
+        {
+            streamed.update(data.data() + i, std::min<size_t>(333, data.size() - i));
+        }
+        CHECK(streamed.digest() == bul::hash(data.data(), data.size(), seed));
+        CHECK(streamed.digest128() == bul::hash128(data.data(), data.size(), seed));
+    }
+
+    // Copies continue on their own
+    bul::Hasher first;
+    first.add(std::string_view("a"));
+    bul::Hasher second = first;
+    second.add(std::string_view("b"));
+    CHECK(first.digest() == bul::hash("a"));
+    CHECK(second.digest() == bul::hash("ab"));
+}
+
+TEST_SUITE_END();
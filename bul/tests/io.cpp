@@ -0,0 +1,79 @@
+#include "doctest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "bul/file.h"
+#include "bul/io.h"
+
+TEST_SUITE_BEGIN("io");
+
+static std::string temp_path(uint32_t index)
+{
+    return (std::filesystem::temp_directory_path() / ("bul_io_" + std::to_string(index))).string();
+}
+
+static std::vector<uint8_t> file_contents(uint32_t index)
+{
+    std::vector<uint8_t> data(index * 997);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = uint8_t(i + index);
+    }
+    return data;
+}
+
+static void check_reads(bul::io::Backend backend)
+{
+    constexpr uint32_t FILE_COUNT = 200;
+    for (uint32_t i = 0; i < FILE_COUNT; ++i)
+    {
+        std::vector<uint8_t> data = file_contents(i);
+        REQUIRE(bul::write_file(temp_path(i).c_str(), data.data(), data.size()));
+    }
+
+    bul::jobs::init(4);
+    // A queue shallower than the number of files makes reads wait for a slot
+    bul::io::init(16, backend);
+    std::atomic<uint32_t> matches = 0;
+    std::atomic<uint32_t> failures = 0;
+    bul::jobs::Counter counter;
+    for (uint32_t i = 0; i < FILE_COUNT; ++i)
+    {
+        bul::io::read(
+            temp_path(i),
+            [&matches, i](std::span<const uint8_t> data, bool ok) {
+                std::vector<uint8_t> expected = file_contents(i);
+                matches += ok && std::equal(data.begin(), data.end(), expected.begin(), expected.end());
+            },
+            &counter);
+    }
+    bul::io::read(
+        temp_path(FILE_COUNT),
+        [&failures](std::span<const uint8_t> data, bool ok) { failures += !ok && data.empty(); }, &counter);
+    bul::jobs::wait(counter);
+    CHECK(matches == FILE_COUNT);
+    CHECK(failures == 1);
+
+    bul::io::shutdown();
+    bul::jobs::shutdown();
+    for (uint32_t i = 0; i < FILE_COUNT; ++i)
+    {
+        std::filesystem::remove(temp_path(i));
+    }
+}
+
+TEST_CASE("reads with io_uring or its fallback")
+{
+    check_reads(bul::io::Backend::IoUring);
+}
+
+TEST_CASE("reads with the thread pool")
+{
+    check_reads(bul::io::Backend::ThreadPool);
+}
+
+TEST_SUITE_END();
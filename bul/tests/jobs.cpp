@@ -0,0 +1,183 @@
+#include "doctest.h"
+
+#include "bul/jobs.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+TEST_SUITE_BEGIN("jobs");
+
+TEST_CASE("run and wait")
+{
+    bul::jobs::init(4);
+    std::atomic<uint32_t> sum = 0;
+    bul::jobs::Counter counter;
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        bul::jobs::run([&sum, i]() { sum += i; }, &counter);
+    }
+    bul::jobs::wait(counter);
+    CHECK(counter.done());
+    CHECK(sum == 999 * 1000 / 2);
+    bul::jobs::shutdown();
+}
+
+TEST_CASE("parallel_for covers every index once")
+{
+    bul::jobs::init(4);
+    for (uint32_t grain : {1u, 7u, 1000u})
+    {
+        std::vector<std::atomic<uint8_t>> visits(100'000);
+        bul::jobs::parallel_for(
+            uint32_t(visits.size()),
+            [&](uint32_t begin, uint32_t end) {
+                CHECK(end - begin >= std::min<uint32_t>(grain, uint32_t(visits.size())));
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    visits[i].fetch_add(1, std::memory_order_relaxed);
+                }
+            },
+            grain);
+        bool once = true;
+        for (const auto& visit : visits)
+        {
+            once &= visit.load() == 1;
+        }
+        CHECK(once);
+    }
+    bul::jobs::shutdown();
+}
+
+TEST_CASE("nested parallel_for")
+{
+    bul::jobs::init(4);
+    std::atomic<uint64_t> sum = 0;
+    bul::jobs::parallel_for(64, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            bul::jobs::parallel_for(1000, [&](uint32_t b, uint32_t e) { sum += e - b; });
+        }
+    });
+    CHECK(sum == 64 * 1000);
+    bul::jobs::shutdown();
+}
+
+TEST_CASE("dependencies")
+{
+    bul::jobs::init(4);
+    std::atomic<bool> release = false;
+    std::atomic<uint32_t> first_done = 0;
+    std::atomic<bool> ordered = true;
+    bul::jobs::Counter gate;
+    bul::jobs::Counter first;
+    bul::jobs::Counter second;
+
+    // Everything is submitted while the gate job holds the first batch back
+    bul::jobs::run(
+        [&]() {
+            while (!release)
+            {
+                std::this_thread::yield();
+            }
+        },
+        &gate);
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        bul::jobs::run([&]() { ++first_done; }, &first, &gate);
+    }
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        bul::jobs::run([&]() { ordered = ordered && first_done == 100; }, &second, &first);
+    }
+    CHECK(first_done == 0);
+    release = true;
+
+    bul::jobs::wait(second);
+    CHECK(first.done());
+    CHECK(ordered);
+    bul::jobs::shutdown();
+}
+
+TEST_CASE("submit from other threads")
+{
+    bul::jobs::init(2);
+    std::atomic<uint32_t> count = 0;
+    bul::jobs::Counter counter;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&]() {
+            bul::jobs::Counter local;
+            for (int i = 0; i < 1000; ++i)
+            {
+                bul::jobs::run([&]() { ++count; }, &local);
+            }
+            bul::jobs::wait(local);
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    CHECK(count == 4000);
+    bul::jobs::shutdown();
+}
+
+// The waiting thread sleeps while the other worker runs the job, the counter reaching zero wakes it up
+TEST_CASE("wait wakes when the counter reaches zero")
+{
+    bul::jobs::init(2);
+    std::atomic<bool> ran = false;
+    bul::jobs::Counter counter;
+    std::thread thread{[&]() {
+        bul::jobs::run(
+            [&]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                ran = true;
+            },
+            &counter);
+    }};
+    thread.join();
+    bul::jobs::wait(counter);
+    CHECK(ran);
+    bul::jobs::shutdown();
+}
+
+// The waiting thread is the only worker: it has to wake up for the job submitted from outside and run it itself
+TEST_CASE("wait wakes for work from other threads")
+{
+    bul::jobs::init(1);
+    std::atomic<bool> ran = false;
+    bul::jobs::Counter counter;
+    bul::jobs::acquire(counter);
+    std::thread thread{[&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        bul::jobs::run([&]() { ran = true; }, &counter);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        bul::jobs::release(counter);
+    }};
+    bul::jobs::wait(counter);
+    CHECK(ran);
+    CHECK(counter.done());
+    thread.join();
+    bul::jobs::shutdown();
+}
+
+TEST_CASE("large captures")
+{
+    bul::jobs::init(2);
+    std::array<uint64_t, 32> values{};
+    std::iota(values.begin(), values.end(), 0);
+    std::atomic<uint64_t> sum = 0;
+    bul::jobs::Counter counter;
+    bul::jobs::run([values, &sum]() { sum = std::accumulate(values.begin(), values.end(), uint64_t(0)); }, &counter);
+    bul::jobs::wait(counter);
+    CHECK(sum == 31 * 32 / 2);
+    bul::jobs::shutdown();
+}
+
+TEST_SUITE_END();
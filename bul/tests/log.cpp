@@ -0,0 +1,135 @@
+#include "doctest.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bul/log.h"
+
+TEST_SUITE_BEGIN("log");
+
+// Logs to a temporary file for the duration of the test
+struct CaptureLog
+{
+    FILE* file = tmpfile();
+
+    CaptureLog()
+    {
+        bul::set_log_file(file);
+    }
+
+    ~CaptureLog()
+    {
+        bul::set_log_file(stdout);
+        fclose(file);
+    }
+
+    std::vector<std::string> lines()
+    {
+        bul::log_flush();
+        std::vector<std::string> res;
+        rewind(file);
+        char line[2048];
+        while (fgets(line, sizeof(line), file) != nullptr)
+        {
+            res.emplace_back(line, strcspn(line, "\n"));
+        }
+        return res;
+    }
+};
+
+enum class Color
+{
+    Red = 3
+};
+
+TEST_CASE("arguments")
+{
+    CaptureLog capture;
+    std::string str = "copied";
+    char array[] = "array";
+    bul::log_info("plain");
+    bul::log_warning("%d %u %lld %.2f %c %s", -1, 2u, 3ll, 4.5f, 'x', "literal");
+    bul::log_error("%s %s %d %s", str.c_str(), array, Color::Red, (const char*)nullptr);
+    // The string is copied when logging, changing it afterwards does not change the message
+    str[0] = 'X';
+    bul::log(bul::LogLevel::Debug, "100%%");
+
+    auto lines = capture.lines();
+    REQUIRE(lines.size() == 4);
+    CHECK(lines[0] == "[INFO] plain");
+    CHECK(lines[1] == "[WARNING] -1 2 3 4.50 x literal");
+    CHECK(lines[2] == "[ERROR] copied array 3 ");
+    CHECK(lines[3] == "[DEBUG] 100%");
+}
+
+TEST_CASE("long strings are truncated")
+{
+    CaptureLog capture;
+    std::string str(bul::LOG_MAX_STRING + 100, 'a');
+    bul::log_info("%s", str.c_str());
+    auto lines = capture.lines();
+    REQUIRE(lines.size() == 1);
+    CHECK(lines[0].size() == std::string("[INFO] ").size() + bul::LOG_MAX_STRING);
+}
+
+TEST_CASE("runtime level")
+{
+    CaptureLog capture;
+    bul::set_log_level(bul::LogLevel::Warning);
+    bul::log_debug("debug");
+    bul::log_info("info");
+    bul::log_warning("warning");
+    bul::log(bul::LogLevel::Info, "info");
+    bul::log(bul::LogLevel::Error, "error");
+    bul::set_log_level(bul::LogLevel::Debug);
+
+    auto lines = capture.lines();
+    REQUIRE(lines.size() == 2);
+    CHECK(lines[0] == "[WARNING] warning");
+    CHECK(lines[1] == "[ERROR] error");
+}
+
+// Enough messages to go around the rings several times, each thread keeps its order
+TEST_CASE("threads")
+{
+    CaptureLog capture;
+    constexpr int THREAD_COUNT = 4;
+    constexpr int MESSAGE_COUNT = 20'000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREAD_COUNT; ++t)
+    {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < MESSAGE_COUNT; ++i)
+            {
+                bul::log_info("%d %d %s", t, i, "padding");
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    auto lines = capture.lines();
+    REQUIRE(lines.size() == THREAD_COUNT * MESSAGE_COUNT);
+    std::vector<int> next(THREAD_COUNT, 0);
+    bool ordered = true;
+    for (const auto& line : lines)
+    {
+        int t = -1;
+        int i = -1;
+        sscanf(line.c_str(), "[INFO] %d %d", &t, &i);
+        if (t < 0 || t >= THREAD_COUNT || next[t] != i)
+        {
+            ordered = false;
+            break;
+        }
+        next[t] = i + 1;
+    }
+    CHECK(ordered);
+}
+
+TEST_SUITE_END();
@@ -1,7 +1,10 @@
 #include "doctest.h"
 
 #include <cstring>
+#include <random>
+#include <vector>
 
+#include "bul/math/aabb.h"
 #include "bul/math/matrix.h"
 
 TEST_SUITE_BEGIN("matrix");
@@ -22,6 +25,37 @@ static bul::mat4f identity{{
 }};
 // clang-format on
 
+static bul::mat4f random_matrix(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    bul::mat4f m;
+    for (float& f : m.data)
+    {
+        f = dist(rng);
+    }
+    for (size_t i = 0; i < 4; ++i)
+    {
+        m[i][i] += 4.0f;
+    }
+    return m;
+}
+
+static void check_approx(const bul::vec4f& a, const bul::vec4f& b)
+{
+    for (size_t i = 0; i < 4; ++i)
+    {
+        CHECK(a[i] == doctest::Approx(b[i]).epsilon(1e-5));
+    }
+}
+
+static void check_approx(const bul::mat4f& a, const bul::mat4f& b)
+{
+    for (size_t i = 0; i < 4; ++i)
+    {
+        check_approx(a[i], b[i]);
+    }
+}
+
 TEST_CASE("default init")
 {
     bul::mat4f m;
@@ -122,4 +156,90 @@ TEST_CASE("inverse")
     CHECK(m[3][3] == doctest::Approx(1.0f / 4.0f));
 }
 
+TEST_CASE("transpose")
+{
+    bul::mat4f m = bul::transpose(values);
+    for (size_t c = 0; c < 4; ++c)
+    {
+        for (size_t r = 0; r < 4; ++r)
+        {
+            CHECK(m[c][r] == values[r][c]);
+        }
+    }
+    CHECK(bul::transpose(m) == values);
+}
+
+TEST_CASE("simd matches scalar")
+{
+    std::mt19937 rng(1);
+    for (int i = 0; i < 100; ++i)
+    {
+        bul::mat4f a = random_matrix(rng);
+        bul::mat4f b = random_matrix(rng);
+        bul::vec4f v = b[0];
+        check_approx(a * b, bul::scalar::mul(a, b));
+        check_approx(a * v, bul::scalar::mul(a, v));
+        check_approx(bul::inverse(a), bul::scalar::inverse(a));
+        check_approx(bul::inverse(a) * a, bul::mat4f::identity());
+        CHECK(bul::transpose(a) == bul::scalar::transpose(a));
+    }
+}
+
+TEST_CASE("transform arrays")
+{
+    std::mt19937 rng(2);
+    bul::mat4f m = random_matrix(rng);
+    bul::mat4f source = random_matrix(rng);
+    // Odd count to go through the tail of the wide loops
+    std::vector<bul::vec4f> vectors(source.cols, source.cols + 3);
+    std::vector<bul::vec3f> points;
+    for (const bul::vec4f& v : vectors)
+    {
+        points.push_back({v.x, v.y, v.z});
+    }
+
+    std::vector<bul::vec4f> expected(vectors.size());
+    bul::scalar::transform(m, vectors.data(), expected.data(), vectors.size());
+    bul::transform(m, vectors.data(), vectors.data(), vectors.size());
+    for (size_t i = 0; i < vectors.size(); ++i)
+    {
+        check_approx(vectors[i], expected[i]);
+        check_approx(vectors[i], bul::transpose(m) * source[i]);
+    }
+
+    std::vector<bul::vec3f> transformed(points.size());
+    std::vector<bul::vec3f> scalar(points.size());
+    bul::transform_points(m, points.data(), transformed.data(), points.size());
+    bul::scalar::transform_points(m, points.data(), scalar.data(), points.size());
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        check_approx(bul::vec4f{transformed[i], 1}, bul::vec4f{scalar[i], 1});
+    }
+    bul::transform_vectors(m, points.data(), transformed.data(), points.size());
+    bul::scalar::transform_vectors(m, points.data(), scalar.data(), points.size());
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        check_approx(bul::vec4f{transformed[i], 0}, bul::vec4f{scalar[i], 0});
+    }
+}
+
+TEST_CASE("transform aabb")
+{
+    bul::aabb box{{-1, -2, -3}, {1, 2, 3}};
+    bul::mat4f m = bul::scale({2, 2, 2});
+    m[3] = {10, 20, 30, 1};
+    CHECK(bul::transform(m, box) == bul::aabb{{8, 16, 24}, {12, 24, 36}});
+
+    // A quarter turn around x swaps the y and z extents
+    m = bul::rotation_x(1.57079633f);
+    bul::aabb rotated = bul::transform(m, box);
+    check_approx(bul::vec4f{rotated.min, 0}, bul::vec4f{-1, -3, -2, 0});
+    check_approx(bul::vec4f{rotated.max, 0}, bul::vec4f{1, 3, 2, 0});
+
+    std::mt19937 rng(3);
+    m = random_matrix(rng);
+    bul::aabb expected = bul::scalar::transform(m, box);
+    CHECK(bul::transform(m, box) == expected);
+}
+
 TEST_SUITE_END();
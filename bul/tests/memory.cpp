@@ -0,0 +1,147 @@
+#include "doctest.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "bul/jobs.h"
+#include "bul/memory.h"
+#include "bul/containers/buffer.h"
+#include "bul/containers/small_vector.h"
+
+using bul::memory::Tag;
+
+TEST_SUITE_BEGIN("memory");
+
+TEST_CASE("tagged allocations")
+{
+    auto before = bul::memory::stats(Tag::Loaders);
+    void* ptr = bul::memory::allocate(100, 8, Tag::Loaders);
+    REQUIRE(ptr != nullptr);
+    auto after = bul::memory::stats(Tag::Loaders);
+    CHECK(after.live_bytes == before.live_bytes + 100);
+    CHECK(after.live_count == before.live_count + 1);
+    CHECK(after.allocations == before.allocations + 1);
+    CHECK(after.peak_bytes >= after.live_bytes);
+
+    for (size_t alignment : {1, 16, 64, 4096})
+    {
+        void* aligned = bul::memory::allocate(10, alignment, Tag::Loaders);
+        CHECK(uintptr_t(aligned) % alignment == 0);
+        std::memset(aligned, 0xff, 10);
+        bul::memory::deallocate(aligned);
+    }
+
+    ptr = bul::memory::reallocate(ptr, 1000);
+    CHECK(bul::memory::stats(Tag::Loaders).live_bytes == before.live_bytes + 1000);
+    bul::memory::deallocate(ptr);
+    bul::memory::deallocate(nullptr);
+    after = bul::memory::stats(Tag::Loaders);
+    CHECK(after.live_bytes == before.live_bytes);
+    CHECK(after.live_count == before.live_count);
+}
+
+TEST_CASE("containers use the tag of the thread")
+{
+    auto loaders = bul::memory::stats(Tag::Loaders);
+    auto containers = bul::memory::stats(Tag::Containers);
+    {
+        bul::memory::Scope scope{Tag::Loaders};
+        CHECK(bul::memory::current_tag() == Tag::Loaders);
+        bul::SmallVector<int, 4> vector;
+        for (int i = 0; i < 16; ++i)
+        {
+            vector.push_back(i);
+        }
+        CHECK(bul::memory::stats(Tag::Loaders).live_bytes >= loaders.live_bytes + int64_t(16 * sizeof(int)));
+    }
+    CHECK(bul::memory::current_tag() == Tag::Untagged);
+    CHECK(bul::memory::stats(Tag::Loaders).live_bytes == loaders.live_bytes);
+
+    {
+        bul::Buffer<char> buffer(64);
+        buffer.resize(256);
+        CHECK(bul::memory::stats(Tag::Containers).live_bytes == containers.live_bytes + 256);
+    }
+    CHECK(bul::memory::stats(Tag::Containers).live_bytes == containers.live_bytes);
+}
+
+TEST_CASE("peaks and frames")
+{
+    auto before = bul::memory::stats(Tag::VulkanStaging);
+    bul::memory::track(Tag::VulkanStaging, 1'000'000);
+    bul::memory::untrack(Tag::VulkanStaging, 1'000'000);
+    auto after = bul::memory::stats(Tag::VulkanStaging);
+    CHECK(after.live_bytes == before.live_bytes);
+    CHECK(after.peak_bytes >= before.live_bytes + 1'000'000);
+
+    bul::memory::frame();
+    for (int i = 0; i < 3; ++i)
+    {
+        bul::memory::track(Tag::VulkanStaging, 10);
+    }
+    bul::memory::frame();
+    CHECK(bul::memory::stats(Tag::VulkanStaging).frame_allocations == 3);
+    bul::memory::frame();
+    CHECK(bul::memory::stats(Tag::VulkanStaging).frame_allocations == 0);
+    for (int i = 0; i < 3; ++i)
+    {
+        bul::memory::untrack(Tag::VulkanStaging, 10);
+    }
+}
+
+TEST_CASE("jobs run with the tag of the thread that submitted them")
+{
+    bul::jobs::init(2);
+    std::atomic<uint32_t> tagged = 0;
+    bul::jobs::Counter counter;
+    {
+        bul::memory::Scope scope{Tag::Loaders};
+        for (int i = 0; i < 100; ++i)
+        {
+            bul::jobs::run([&tagged]() { tagged += bul::memory::current_tag() == Tag::Loaders; }, &counter);
+        }
+    }
+    bul::jobs::run([&tagged]() { tagged += bul::memory::current_tag() == Tag::Loaders; }, &counter);
+    bul::jobs::wait(counter);
+    CHECK(tagged == 100);
+    bul::jobs::shutdown();
+}
+
+TEST_CASE("report")
+{
+    FILE* file = tmpfile();
+    bul::memory::report(file);
+    rewind(file);
+    std::string text;
+    char line[256];
+    while (fgets(line, sizeof(line), file) != nullptr)
+    {
+        text += line;
+    }
+    fclose(file);
+    for (size_t i = 0; i < size_t(Tag::Count); ++i)
+    {
+        CHECK(text.find(bul::memory::tag_name(Tag(i))) != std::string::npos);
+    }
+    CHECK(text.find("Total") != std::string::npos);
+}
+
+#if defined(BUL_TRACK_ALLOCATIONS)
+TEST_CASE("global operator new")
+{
+    auto before = bul::memory::stats(Tag::Loaders);
+    int* ints = nullptr;
+    {
+        bul::memory::Scope scope{Tag::Loaders};
+        ints = new int[100];
+    }
+    CHECK(bul::memory::stats(Tag::Loaders).live_bytes == before.live_bytes + int64_t(100 * sizeof(int)));
+    // Freed against the tag it was allocated with
+    delete[] ints;
+    CHECK(bul::memory::stats(Tag::Loaders).live_bytes == before.live_bytes);
+}
+#endif
+
+TEST_SUITE_END();
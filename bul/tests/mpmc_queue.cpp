@@ -0,0 +1,101 @@
+#include "doctest.h"
+
+#include "bul/containers/mpmc_queue.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST_SUITE_BEGIN("mpmc_queue");
+
+TEST_CASE("push pop")
+{
+    bul::MpmcQueue<int, 4> queue;
+    CHECK(queue.empty());
+    for (int i = 0; i < 4; ++i)
+    {
+        CHECK(queue.push_back(i));
+    }
+    CHECK(!queue.push_back(4));
+    CHECK(queue.size() == 4);
+
+    int val = -1;
+    CHECK(queue.pop_front(val));
+    CHECK(val == 0);
+    CHECK(queue.push_back(4));
+    for (int i = 1; i < 5; ++i)
+    {
+        CHECK(queue.pop_front(val));
+        CHECK(val == i);
+    }
+    CHECK(!queue.pop_front(val));
+}
+
+TEST_CASE("destroys remaining values")
+{
+    auto shared = std::make_shared<int>(0);
+    {
+        bul::MpmcQueue<std::shared_ptr<int>, 8> queue;
+        queue.push_back(shared);
+        queue.push_back(shared);
+        std::shared_ptr<int> popped;
+        queue.pop_front(popped);
+        CHECK(shared.use_count() == 3);
+    }
+    CHECK(shared.use_count() == 1);
+}
+
+TEST_CASE("stress")
+{
+    constexpr uint32_t PRODUCERS = 4;
+    constexpr uint32_t CONSUMERS = 4;
+    constexpr uint64_t COUNT_PER_PRODUCER = 200'000;
+    bul::MpmcQueue<uint64_t, 1024> queue;
+
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < PRODUCERS; ++p)
+    {
+        threads.emplace_back([&, p]() {
+            for (uint64_t i = 0; i < COUNT_PER_PRODUCER; ++i)
+            {
+                while (!queue.push_back(p * COUNT_PER_PRODUCER + i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Every value is popped exactly once
+    std::vector<std::atomic<uint8_t>> seen(PRODUCERS * COUNT_PER_PRODUCER);
+    std::atomic<uint64_t> popped = 0;
+    for (uint32_t c = 0; c < CONSUMERS; ++c)
+    {
+        threads.emplace_back([&]() {
+            while (popped.load(std::memory_order_relaxed) < PRODUCERS * COUNT_PER_PRODUCER)
+            {
+                uint64_t val;
+                if (queue.pop_front(val))
+                {
+                    seen[val].fetch_add(1, std::memory_order_relaxed);
+                    popped.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    bool exactly_once = true;
+    for (const auto& count : seen)
+    {
+        exactly_once &= count.load() == 1;
+    }
+    CHECK(exactly_once);
+    CHECK(queue.empty());
+}
+
+TEST_SUITE_END();
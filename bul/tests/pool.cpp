@@ -2,6 +2,10 @@
 
 #include "bul/containers/pool.h"
 
+#include <string>
+#include <thread>
+#include <vector>
+
 TEST_SUITE_BEGIN("pool");
 
 TEST_CASE("simple insert get")
@@ -121,4 +125,59 @@ TEST_CASE("iterator erase")
     CHECK(count == 4);
 }
 
+TEST_CASE("stable references")
+{
+    bul::Pool<std::string> pool(1);
+    bul::Handle<std::string> h = pool.insert("first");
+    std::string* first = &pool.get(h);
+    for (int i = 0; i < 1000; ++i)
+    {
+        pool.insert(std::to_string(i));
+    }
+    CHECK(&pool.get(h) == first);
+    CHECK(*first == "first");
+}
+
+TEST_CASE("concurrent insert erase")
+{
+    bul::Pool<int> pool(1);
+    constexpr int THREADS = 8;
+    constexpr int COUNT = 10000;
+    std::vector<std::vector<bul::Handle<int>>> handles(THREADS);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < COUNT; ++i)
+            {
+                handles[t].push_back(pool.insert(t * COUNT + i));
+                // Erase every other handle so that free slots get recycled while other threads insert
+                if (i % 2 == 1)
+                {
+                    pool.erase(handles[t][i - 1]);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    int count = 0;
+    for (int t = 0; t < THREADS; ++t)
+    {
+        for (int i = 1; i < COUNT; i += 2)
+        {
+            CHECK(pool.is_valid(handles[t][i]));
+            CHECK(pool.get(handles[t][i]) == t * COUNT + i);
+        }
+    }
+    for ([[maybe_unused]] int value : pool)
+    {
+        ++count;
+    }
+    CHECK(count == THREADS * COUNT / 2);
+}
+
 TEST_SUITE_END();
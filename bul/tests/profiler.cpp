@@ -0,0 +1,125 @@
+#include "doctest.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bul/file.h"
+#include "bul/profiler.h"
+
+TEST_SUITE_BEGIN("profiler");
+
+static std::vector<bul::profiler::ScopeRecord> scopes_named(const bul::profiler::FrameRecord& frame,
+                                                            std::string_view prefix)
+{
+    std::vector<bul::profiler::ScopeRecord> scopes;
+    for (const auto& scope : frame.scopes)
+    {
+        if (std::string_view(scope.name).starts_with(prefix))
+        {
+            scopes.push_back(scope);
+        }
+    }
+    return scopes;
+}
+
+TEST_CASE("nested scopes and counters")
+{
+    bul::profiler::frame();
+    {
+        bul::profiler::Scope outer{"nested outer"};
+        for (int i = 0; i < 2; ++i)
+        {
+            bul::profiler::Scope inner{"nested inner"};
+        }
+        bul::profiler::counter("nested counter", 3);
+    }
+    bul::profiler::frame();
+
+    auto frame = bul::profiler::last_frame();
+    auto scopes = scopes_named(frame, "nested");
+    REQUIRE(scopes.size() == 3);
+    // Parents come before their children
+    CHECK(std::string_view(scopes[0].name) == "nested outer");
+    CHECK(scopes[0].depth == 0);
+    for (int i = 1; i < 3; ++i)
+    {
+        CHECK(std::string_view(scopes[i].name) == "nested inner");
+        CHECK(scopes[i].depth == 1);
+        CHECK(scopes[i].begin_us >= scopes[0].begin_us);
+        CHECK(scopes[i].begin_us + scopes[i].duration_us <= scopes[0].begin_us + scopes[0].duration_us);
+    }
+    CHECK(scopes[0].begin_us >= frame.begin_us);
+    CHECK(scopes[0].begin_us + scopes[0].duration_us <= frame.begin_us + frame.duration_us);
+
+    auto counter = std::find_if(frame.counters.begin(), frame.counters.end(),
+                                [](const auto& counter) { return std::string_view(counter.name) == "nested counter"; });
+    REQUIRE(counter != frame.counters.end());
+    CHECK(counter->value == 3);
+    CHECK(frame.dropped == 0);
+}
+
+TEST_CASE("threads")
+{
+    bul::profiler::frame();
+    std::thread thread{[]() {
+        bul::profiler::set_thread_name("Named thread");
+        bul::profiler::Scope scope{"threads scope"};
+    }};
+    thread.join();
+    bul::profiler::frame();
+
+    auto frame = bul::profiler::last_frame();
+    auto scopes = scopes_named(frame, "threads");
+    REQUIRE(scopes.size() == 1);
+    auto named = std::find_if(frame.threads.begin(), frame.threads.end(),
+                              [&](const auto& thread) { return thread.id == scopes[0].thread; });
+    REQUIRE(named != frame.threads.end());
+    CHECK(named->name == "Named thread");
+
+    // The buffer of the thread is freed once collected
+    bul::profiler::frame();
+    frame = bul::profiler::last_frame();
+    CHECK(std::none_of(frame.threads.begin(), frame.threads.end(),
+                       [](const auto& thread) { return thread.name == "Named thread"; }));
+}
+
+TEST_CASE("chrome trace")
+{
+    std::string path = (std::filesystem::temp_directory_path() / "bul_profile.json").string();
+    bul::profiler::begin_capture();
+    CHECK(bul::profiler::capturing());
+    for (int i = 0; i < 3; ++i)
+    {
+        {
+            bul::profiler::Scope scope{"trace \"quoted\""};
+            bul::profiler::counter("trace counter", i);
+        }
+        bul::profiler::frame();
+    }
+    REQUIRE(bul::profiler::end_capture(path.c_str()));
+    CHECK(!bul::profiler::capturing());
+
+    std::vector<uint8_t> data;
+    REQUIRE(bul::read_file(path.c_str(), data));
+    std::string json{data.begin(), data.end()};
+    auto count = [&](std::string_view str) {
+        size_t n = 0;
+        for (size_t pos = json.find(str); pos != std::string::npos; pos = json.find(str, pos + 1))
+        {
+            ++n;
+        }
+        return n;
+    };
+    CHECK(json.starts_with("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    CHECK(json.ends_with("]}\n"));
+    CHECK(count("\"name\":\"trace \\\"quoted\\\"\",\"ph\":\"X\"") == 3);
+    CHECK(count("\"name\":\"trace counter\",\"ph\":\"C\"") == 3);
+    CHECK(count("\"name\":\"Frame\",\"ph\":\"X\"") == 3);
+    CHECK(count("\"ph\":\"M\"") >= 2);
+    std::filesystem::remove(path);
+}
+
+TEST_SUITE_END();
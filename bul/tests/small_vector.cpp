@@ -0,0 +1,106 @@
+#include "doctest.h"
+
+#include "bul/containers/small_vector.h"
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+TEST_SUITE_BEGIN("small_vector");
+
+TEST_CASE("inline")
+{
+    bul::SmallVector<int, 4> a;
+    CHECK(a.capacity() == 4);
+    CHECK(a.empty());
+    for (int i = 0; i < 4; ++i)
+    {
+        a.push_back(i);
+    }
+    CHECK(a.is_inline());
+    CHECK(a.size() == 4);
+    CHECK(a.back() == 3);
+    CHECK(a.pop_back());
+    CHECK(a.size() == 3);
+}
+
+TEST_CASE("spill to heap")
+{
+    bul::SmallVector<std::string, 2> a;
+    for (int i = 0; i < 100; ++i)
+    {
+        a.push_back(std::to_string(i));
+    }
+    CHECK(!a.is_inline());
+    CHECK(a.size() == 100);
+    CHECK(a.capacity() >= 100);
+    for (int i = 0; i < 100; ++i)
+    {
+        CHECK(a[i] == std::to_string(i));
+    }
+}
+
+TEST_CASE("push own element while growing")
+{
+    bul::SmallVector<std::string, 1> a{"a long enough string to not fit in the SSO buffer"};
+    a.push_back(a[0]);
+    CHECK(a.size() == 2);
+    CHECK(a[1] == a[0]);
+}
+
+TEST_CASE("copy and move")
+{
+    bul::SmallVector<std::string, 2> inline_vector{"a", "b"};
+    bul::SmallVector<std::string, 2> heap_vector{"a", "b", "c"};
+
+    auto inline_copy = inline_vector;
+    auto heap_copy = heap_vector;
+    CHECK(inline_copy == inline_vector);
+    CHECK(heap_copy == heap_vector);
+    CHECK(!(inline_copy == heap_copy));
+
+    const std::string* heap_data = heap_copy.data();
+    auto heap_moved = std::move(heap_copy);
+    CHECK(heap_moved.data() == heap_data);
+    CHECK(heap_copy.empty());
+    CHECK(heap_copy.is_inline());
+
+    auto inline_moved = std::move(inline_copy);
+    CHECK(inline_moved.is_inline());
+    CHECK(inline_moved == inline_vector);
+
+    // std::vector only moves its elements when it grows if that cannot throw
+    static_assert(std::is_nothrow_move_constructible_v<bul::SmallVector<std::string, 2>>);
+    static_assert(std::is_nothrow_move_assignable_v<bul::SmallVector<std::string, 2>>);
+    std::vector<bul::SmallVector<std::string, 2>> vectors(1, heap_vector);
+    heap_data = vectors[0].data();
+    vectors.resize(vectors.capacity() + 1);
+    CHECK(vectors[0].data() == heap_data);
+}
+
+TEST_CASE("move only")
+{
+    bul::SmallVector<std::unique_ptr<int>, 2> a;
+    for (int i = 0; i < 5; ++i)
+    {
+        a.emplace_back(std::make_unique<int>(i));
+    }
+    bul::SmallVector<std::unique_ptr<int>, 2> b = std::move(a);
+    CHECK(b.size() == 5);
+    CHECK(*b[4] == 4);
+}
+
+TEST_CASE("resize")
+{
+    bul::SmallVector<int, 4> a;
+    a.resize(10);
+    CHECK(a.size() == 10);
+    CHECK(a[9] == 0);
+    a.resize(2);
+    CHECK(a.size() == 2);
+    a.clear();
+    CHECK(a.empty());
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,77 @@
+#include "doctest.h"
+
+#include "bul/containers/spsc_queue.h"
+
+#include <memory>
+#include <thread>
+
+TEST_SUITE_BEGIN("spsc_queue");
+
+TEST_CASE("push pop")
+{
+    bul::SpscQueue<int, 4> queue;
+    CHECK(queue.empty());
+    for (int i = 0; i < 4; ++i)
+    {
+        CHECK(queue.push_back(i));
+    }
+    CHECK(!queue.push_back(4));
+    CHECK(queue.size() == 4);
+
+    int val = -1;
+    CHECK(queue.pop_front(val));
+    CHECK(val == 0);
+    CHECK(queue.push_back(4));
+    for (int i = 1; i < 5; ++i)
+    {
+        CHECK(queue.pop_front(val));
+        CHECK(val == i);
+    }
+    CHECK(!queue.pop_front(val));
+}
+
+TEST_CASE("destroys remaining values")
+{
+    auto shared = std::make_shared<int>(0);
+    {
+        bul::SpscQueue<std::shared_ptr<int>, 8> queue;
+        queue.push_back(shared);
+        queue.push_back(shared);
+        CHECK(shared.use_count() == 3);
+    }
+    CHECK(shared.use_count() == 1);
+}
+
+TEST_CASE("stress")
+{
+    constexpr uint64_t COUNT = 1'000'000;
+    bul::SpscQueue<uint64_t, 256> queue;
+
+    std::thread producer([&]() {
+        for (uint64_t i = 0; i < COUNT; ++i)
+        {
+            while (!queue.push_back(i))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    // Values come out in order, none lost or duplicated
+    bool ordered = true;
+    uint64_t expected = 0;
+    while (expected < COUNT)
+    {
+        uint64_t val;
+        if (queue.pop_front(val))
+        {
+            ordered &= val == expected;
+            ++expected;
+        }
+    }
+    producer.join();
+    CHECK(ordered);
+    CHECK(queue.empty());
+}
+
+TEST_SUITE_END();
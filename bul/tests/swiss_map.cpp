@@ -0,0 +1,127 @@
+#include "doctest.h"
+
+#include <string>
+#include <unordered_map>
+#include <random>
+
+#include "bul/containers/swiss_map.h"
+
+TEST_SUITE_BEGIN("swiss_map");
+
+TEST_CASE("simple insert")
+{
+    bul::SwissMap<int, std::string> m;
+    CHECK(m.size() == 0);
+    auto* entry = m.emplace(1, "1");
+    CHECK(entry != nullptr);
+    CHECK(entry->key == 1);
+    CHECK(entry->val == "1");
+    CHECK(m.size() == 1);
+    CHECK(m.emplace(1, "2") == nullptr);
+    CHECK(m.size() == 1);
+}
+
+TEST_CASE("simple lookup")
+{
+    bul::SwissMap<int, std::string> m;
+    auto* entry = m.emplace(1, "1");
+    entry = m[1];
+    CHECK(entry != nullptr);
+    CHECK(entry->key == 1);
+    CHECK(entry->val == "1");
+    CHECK(m[2] == nullptr);
+
+    const auto& cm = m;
+    CHECK(cm[1]->val == "1");
+    CHECK(cm[2] == nullptr);
+}
+
+TEST_CASE("grow")
+{
+    bul::SwissMap<int, std::string> m;
+    CHECK(m.capacity() == 16);
+    for (int i = 0; i < 14; ++i)
+    {
+        m.emplace(i, std::to_string(i));
+    }
+    CHECK(m.capacity() == 16);
+    m.emplace(14, "14");
+    CHECK(m.capacity() == 32);
+    CHECK(m.size() == 15);
+    for (int i = 0; i < 15; ++i)
+    {
+        CHECK(m[i]->val == std::to_string(i));
+    }
+}
+
+TEST_CASE("erase")
+{
+    bul::SwissMap<int, std::string> m;
+    m.emplace(1, "1");
+    m.emplace(2, "2");
+    m.emplace(3, "3");
+    m.emplace(4, "4");
+
+    CHECK(!m.erase(5));
+    CHECK(m.size() == 4);
+    CHECK(m.erase(2));
+    CHECK(m.size() == 3);
+    CHECK(!m.erase(2));
+    CHECK(m.size() == 3);
+    CHECK(m[1]->val == "1");
+    CHECK(m[2] == nullptr);
+    CHECK(m[3]->val == "3");
+    CHECK(m[4]->val == "4");
+}
+
+TEST_CASE("string key")
+{
+    bul::SwissMap<std::string, int> m;
+    m.emplace("1", 1);
+    m.emplace("2", 2);
+    CHECK(m["1"]->val == 1);
+    CHECK(m["2"]->val == 2);
+    CHECK(m["3"] == nullptr);
+}
+
+TEST_CASE("random operations against std::unordered_map")
+{
+    bul::SwissMap<uint32_t, uint32_t> m;
+    std::unordered_map<uint32_t, uint32_t> reference;
+    std::mt19937 rng(42);
+    for (uint32_t i = 0; i < 200000; ++i)
+    {
+        uint32_t key = rng() % 4096;
+        switch (rng() % 3)
+        {
+        case 0:
+            CHECK((m.emplace(key, i) != nullptr) == reference.emplace(key, i).second);
+            break;
+        case 1:
+            CHECK(m.erase(key) == (reference.erase(key) == 1));
+            break;
+        case 2:
+        {
+            auto* entry = m[key];
+            auto it = reference.find(key);
+            REQUIRE((entry != nullptr) == (it != reference.end()));
+            if (entry)
+            {
+                CHECK(entry->val == it->second);
+            }
+            break;
+        }
+        }
+        REQUIRE(m.size() == reference.size());
+    }
+
+    size_t count = 0;
+    for (const auto& entry : m)
+    {
+        CHECK(reference[entry.key] == entry.val);
+        ++count;
+    }
+    CHECK(count == reference.size());
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,106 @@
+#include "doctest.h"
+
+#include <random>
+#include <vector>
+
+#include "bul/math/wide.h"
+
+TEST_SUITE_BEGIN("wide");
+
+template <typename V>
+static std::vector<bul::vec3f> random_vec3(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+    std::vector<bul::vec3f> res(V::WIDTH);
+    for (auto& v : res)
+    {
+        v = {dist(rng), dist(rng), dist(rng)};
+    }
+    return res;
+}
+
+static void check_approx(const bul::vec3f& a, const bul::vec3f& b)
+{
+    CHECK(a.x == doctest::Approx(b.x));
+    CHECK(a.y == doctest::Approx(b.y));
+    CHECK(a.z == doctest::Approx(b.z));
+}
+
+TEST_CASE_TEMPLATE("load store", V, bul::vec3x4, bul::vec3x8)
+{
+    std::mt19937 rng(1);
+    auto src = random_vec3<V>(rng);
+    V v = V::load(src.data());
+    std::vector<bul::vec3f> dst(V::WIDTH);
+    v.store(dst.data());
+    CHECK(dst == src);
+    for (size_t i = 0; i < V::WIDTH; ++i)
+    {
+        CHECK(v[i] == src[i]);
+    }
+    V broadcast{bul::vec3f{1, 2, 3}};
+    CHECK(broadcast[V::WIDTH - 1] == bul::vec3f{1, 2, 3});
+}
+
+TEST_CASE_TEMPLATE("matches vec3f", V, bul::vec3x4, bul::vec3x8)
+{
+    std::mt19937 rng(2);
+    for (int iteration = 0; iteration < 100; ++iteration)
+    {
+        auto a = random_vec3<V>(rng);
+        auto b = random_vec3<V>(rng);
+        auto c = random_vec3<V>(rng);
+        V va = V::load(a.data());
+        V vb = V::load(b.data());
+        V vc = V::load(c.data());
+
+        auto d = bul::dot(va, vb);
+        V cross = bul::cross(va, vb);
+        V min = bul::min(va, vb);
+        V max = bul::max(va, vb);
+        V fmadd = bul::fmadd(va, vb, vc);
+        V sum = va + vb;
+        V normalized = bul::normalize(va);
+        for (size_t i = 0; i < V::WIDTH; ++i)
+        {
+            CHECK(d[i] == doctest::Approx(bul::dot(a[i], b[i])));
+            CHECK(cross[i] == bul::cross(a[i], b[i]));
+            CHECK(min[i] == bul::vec3f{std::min(a[i].x, b[i].x), std::min(a[i].y, b[i].y), std::min(a[i].z, b[i].z)});
+            CHECK(max[i] == bul::vec3f{std::max(a[i].x, b[i].x), std::max(a[i].y, b[i].y), std::max(a[i].z, b[i].z)});
+            check_approx(fmadd[i], a[i] * b[i] + c[i]);
+            CHECK(sum[i] == a[i] + b[i]);
+            check_approx(normalized[i], bul::normalize(a[i]));
+        }
+    }
+}
+
+TEST_CASE_TEMPLATE("masks", V, bul::vec3x4, bul::vec3x8)
+{
+    using F = decltype(V::x);
+    float values[V::WIDTH];
+    for (size_t i = 0; i < V::WIDTH; ++i)
+    {
+        values[i] = float(i);
+    }
+    F f = F::load(values);
+    F half{float(V::WIDTH / 2)};
+
+    F less = f < half;
+    uint32_t low_bits = (1u << (V::WIDTH / 2)) - 1;
+    CHECK(bul::mask_bits(less) == low_bits);
+    CHECK(bul::mask_bits(f >= half) == (~low_bits & ((1u << V::WIDTH) - 1)));
+    CHECK(bul::any(less));
+    CHECK(!bul::all(less));
+    CHECK(bul::all(f < F{100.0f}));
+    CHECK(!bul::any(f > F{100.0f}));
+
+    V a{bul::vec3f{1, 2, 3}};
+    V b{bul::vec3f{4, 5, 6}};
+    V selected = bul::select(less, a, b);
+    for (size_t i = 0; i < V::WIDTH; ++i)
+    {
+        CHECK(selected[i] == (i < V::WIDTH / 2 ? bul::vec3f{1, 2, 3} : bul::vec3f{4, 5, 6}));
+    }
+}
+
+TEST_SUITE_END();
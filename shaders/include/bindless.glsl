@@ -0,0 +1,19 @@
+#ifndef BINDLESS_H
+#define BINDLESS_H
+
+// Included first, extensions come before any declaration
+#extension GL_EXT_nonuniform_qualifier : require
+
+// vk::BindlessSet, indexed by the handle values of the resources
+#define BINDLESS_SET 2
+#define BINDLESS_SAMPLED_IMAGES_BINDING 0
+#define BINDLESS_STORAGE_IMAGES_BINDING 1
+#define BINDLESS_STORAGE_BUFFERS_BINDING 2
+
+layout(set = BINDLESS_SET, binding = BINDLESS_SAMPLED_IMAGES_BINDING) uniform sampler2D sampled_images[];
+
+// Storage images and buffers depend on their format and contents, shaders declare the arrays they need at the bindings
+// above, like:
+// layout(set = BINDLESS_SET, binding = BINDLESS_STORAGE_BUFFERS_BINDING) buffer Foos { Foo foos[]; } foo_buffers[];
+
+#endif
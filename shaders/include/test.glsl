@@ -5,6 +5,7 @@ struct Vertex
 {
     vec4 position;
     vec4 normal;
+    vec4 tangent;
     vec2 uv_0;
     vec2 uv_1;
 };
@@ -1,6 +1,12 @@
+#include "bindless.glsl"
 #include "global.glsl"
 
-layout(set = 1, binding = 2) uniform sampler2D base_color_tex;
+layout(push_constant) uniform DrawConstants
+{
+    mat4 transform;
+    uint vertex_buffer;
+    uint base_color;
+} draw;
 
 layout(location = 0) in vec4 world_pos;
 layout(location = 1) in vec4 normal;
@@ -15,5 +21,5 @@ void main()
     float diffuse = max(dot(normal.xyz, light_dir), 0.0);
     float ambiant = 0.01;
 
-    frag_color = texture(base_color_tex, uv_0) * (diffuse + ambiant);
+    frag_color = texture(sampled_images[draw.base_color], uv_0) * (diffuse + ambiant);
 }
@@ -1,14 +1,17 @@
+#include "bindless.glsl"
 #include "global.glsl"
 
-layout(set = 1, binding = 0) buffer VertexBuffer
+layout(set = BINDLESS_SET, binding = BINDLESS_STORAGE_BUFFERS_BINDING) readonly buffer VertexBuffer
 {
     Vertex vertices[];
-};
+} vertex_buffers[];
 
-layout (set = 1, binding = 1) uniform MeshUniform
+layout(push_constant) uniform DrawConstants
 {
     mat4 transform;
-} mesh_uniform;
+    uint vertex_buffer;
+    uint base_color;
+} draw;
 
 layout(location = 0) out vec4 world_pos;
 layout(location = 1) out vec4 normal;
@@ -16,9 +19,10 @@ layout(location = 2) out vec2 uv_0;
 
 void main()
 {
-    mat4 mvp = global.proj * global.view * mesh_uniform.transform;
-    gl_Position = mvp * vertices[gl_VertexIndex].position;
-    world_pos = mesh_uniform.transform * vertices[gl_VertexIndex].position;
-    normal = vertices[gl_VertexIndex].normal;
-    uv_0 = vertices[gl_VertexIndex].uv_0;
+    Vertex vertex = vertex_buffers[draw.vertex_buffer].vertices[gl_VertexIndex];
+    mat4 mvp = global.proj * global.view * draw.transform;
+    gl_Position = mvp * vertex.position;
+    world_pos = draw.transform * vertex.position;
+    normal = vertex.normal;
+    uv_0 = vertex.uv_0;
 }
@@ -5,6 +5,7 @@
 
 #include "bul/window.h"
 #include "bul/time.h"
+#include "bul/math/fast.h"
 #include "bul/math/math.h"
 
 #undef near
@@ -27,10 +28,16 @@ Camera::Camera(const bul::vec3f& pos, const bul::vec3f& world_up, float yaw, flo
 
 void Camera::update_vectors()
 {
+    float sin_yaw;
+    float cos_yaw;
+    float sin_pitch;
+    float cos_pitch;
+    bul::fast::sincos(bul::radians(yaw_), sin_yaw, cos_yaw);
+    bul::fast::sincos(bul::radians(pitch_), sin_pitch, cos_pitch);
     bul::vec3f dir;
-    dir.x = cos(bul::radians(yaw_)) * cos(bul::radians(pitch_));
-    dir.y = sin(bul::radians(pitch_));
-    dir.z = sin(bul::radians(yaw_)) * cos(bul::radians(pitch_));
+    dir.x = cos_yaw * cos_pitch;
+    dir.y = sin_pitch;
+    dir.z = sin_yaw * cos_pitch;
     front_ = bul::normalize(dir);
     right_ = bul::normalize(bul::cross(front_, world_up_));
     up_ = bul::normalize(bul::cross(right_, front_));
@@ -187,7 +194,8 @@ void Camera::update_view()
     x_offset *= sensitivity_;
     y_offset *= sensitivity_;
 
-    yaw_ += x_offset;
+    // Wrapped so that it stays in the domain of bul::fast::sincos
+    yaw_ = std::fmod(yaw_ + x_offset, 360.0f);
     pitch_ += y_offset;
 
     pitch_ = std::min(pitch_, 89.0f);
@@ -1,9 +1,20 @@
 #include "gltf.h"
 
 #include "bul/bul.h"
+#include "bul/base64.h"
 #include "bul/file.h"
+#include "bul/jobs.h"
+#include "bul/memory.h"
+#include "bul/profiler.h"
 
+#include "ktx2.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <span>
+#include <stdexcept>
 #include <rapidjson/rapidjson.h>
 #include <rapidjson/document.h>
 
@@ -11,7 +22,14 @@ namespace gltf
 {
 using rapidjson_document = rapidjson::Document;
 using rapidjson_array = rapidjson::GenericArray<true, rapidjson::Value>;
-using Buffer = std::vector<uint8_t>;
+
+// External buffers are mapped rather than read, only data URIs are decoded to memory. bytes views either one.
+struct Buffer
+{
+    bul::MappedFile file;
+    std::vector<uint8_t> decoded;
+    std::span<const uint8_t> bytes;
+};
 
 enum AccessorComponentType
 {
@@ -44,10 +62,12 @@ struct BufferView
 struct Accessor
 {
     const uint8_t* data = nullptr;
-    uint32_t count;
-    AccessorComponentType component_type;
-    AccessorType type;
+    uint32_t count = 0;
+    AccessorComponentType component_type = AccessorComponentType::BYTE;
+    AccessorType type = AccessorType::SCALAR;
     BufferView buffer_view;
+    // Tightly packed elements of accessors without a bufferView or with sparse values, data points here
+    std::vector<uint8_t> storage;
 };
 
 template <typename T>
@@ -97,65 +117,181 @@ static AccessorType string_to_accessor_type(std::string_view s)
     return AccessorType::SCALAR;
 }
 
-static BufferView get_buffer_view(rapidjson_document& json, uint64_t buffer_view_index,
-                                  const std::vector<Buffer>& buffers)
+static uint32_t get_uint(const rapidjson::Value& json, const char* name, uint32_t default_value)
 {
-    const auto& buffer_view_json = json["bufferViews"].GetArray()[buffer_view_index];
-    uint64_t buffer_index = buffer_view_json["buffer"].GetUint64();
+    auto member = json.FindMember(name);
+    if (member == json.MemberEnd())
+    {
+        return default_value;
+    }
+    return member->value.GetUint();
+}
 
-    uint32_t byte_offset = 0;
-    if (buffer_view_json.HasMember("byteOffset"))
+// Index of the texture in a textureInfo member, -1 when there is none
+static uint32_t get_texture(const rapidjson::Value& json, const char* name)
+{
+    auto member = json.FindMember(name);
+    if (member == json.MemberEnd())
     {
-        byte_offset = buffer_view_json["byteOffset"].GetUint64();
+        return -1;
     }
+    return member->value["index"].GetUint();
+}
 
-    uint32_t byte_length = buffer_view_json["byteLength"].GetUint();
+static std::vector<BufferView> load_buffer_views(rapidjson_document& json, const std::vector<Buffer>& buffers)
+{
+    std::vector<BufferView> buffer_views;
+    if (!json.HasMember("bufferViews"))
+    {
+        return buffer_views;
+    }
+    const auto& json_buffer_views = json["bufferViews"].GetArray();
+    buffer_views.reserve(json_buffer_views.Size());
+    for (const auto& json_buffer_view : json_buffer_views)
+    {
+        uint32_t buffer_index = json_buffer_view["buffer"].GetUint();
+        uint32_t byte_offset = get_uint(json_buffer_view, "byteOffset", 0);
+        uint32_t byte_length = json_buffer_view["byteLength"].GetUint();
+        uint32_t byte_stride = get_uint(json_buffer_view, "byteStride", 0);
+        buffer_views.push_back({buffers[buffer_index].bytes.data() + byte_offset, byte_length, byte_stride});
+    }
+    return buffer_views;
+}
 
-    uint32_t byte_stride = 0;
-    if (buffer_view_json.HasMember("byteStride"))
+// Copies the elements to storage, zeros without a bufferView, then writes the sparse values over them
+static void materialize_accessor(Accessor& accessor, const rapidjson::Value* json_sparse,
+                                 const std::vector<BufferView>& buffer_views)
+{
+    size_t element_size = size_t(accessor.component_type) * accessor.type;
+    accessor.storage.resize(accessor.count * element_size);
+    if (accessor.data)
     {
-        byte_stride = buffer_view_json["byteStride"].GetUint();
+        size_t step = accessor.buffer_view.byte_stride ? accessor.buffer_view.byte_stride : element_size;
+        for (size_t i = 0; i < accessor.count; ++i)
+        {
+            std::memcpy(accessor.storage.data() + i * element_size, accessor.data + i * step, element_size);
+        }
     }
+    accessor.data = accessor.storage.data();
+    accessor.buffer_view.byte_stride = 0;
 
-    return {buffers[buffer_index].data() + byte_offset, byte_length, byte_stride};
+    if (!json_sparse)
+    {
+        return;
+    }
+    uint32_t sparse_count = (*json_sparse)["count"].GetUint();
+    const auto& json_indices = (*json_sparse)["indices"];
+    const auto& json_values = (*json_sparse)["values"];
+    const uint8_t* indices = buffer_views[json_indices["bufferView"].GetUint()].data +
+                             get_uint(json_indices, "byteOffset", 0);
+    uint32_t index_size = uint_to_accessor_component_type(json_indices["componentType"].GetUint());
+    const uint8_t* values = buffer_views[json_values["bufferView"].GetUint()].data +
+                            get_uint(json_values, "byteOffset", 0);
+    for (size_t i = 0; i < sparse_count; ++i, indices += index_size, values += element_size)
+    {
+        uint32_t index = index_size == 1   ? get_value<uint8_t>(indices)
+                         : index_size == 2 ? get_value<uint16_t>(indices)
+                                           : get_value<uint32_t>(indices);
+        ASSERT(index < accessor.count);
+        std::memcpy(accessor.storage.data() + index * element_size, values, element_size);
+    }
 }
 
-static Accessor get_accessor(rapidjson_document& json, uint64_t accessor_index, const std::vector<Buffer>& buffers)
+static std::vector<Accessor> load_accessors(rapidjson_document& json, const std::vector<BufferView>& buffer_views)
 {
-    Accessor accessor;
+    std::vector<Accessor> accessors;
+    if (!json.HasMember("accessors"))
+    {
+        return accessors;
+    }
+    const auto& json_accessors = json["accessors"].GetArray();
+    accessors.reserve(json_accessors.Size());
+    for (const auto& json_accessor : json_accessors)
+    {
+        Accessor& accessor = accessors.emplace_back();
+        accessor.count = json_accessor["count"].GetUint();
+        accessor.component_type = uint_to_accessor_component_type(json_accessor["componentType"].GetUint());
+        const auto& json_type = json_accessor["type"];
+        accessor.type = string_to_accessor_type({json_type.GetString(), json_type.GetStringLength()});
+
+        uint32_t buffer_view_index = get_uint(json_accessor, "bufferView", -1);
+        if (buffer_view_index != (uint32_t)-1)
+        {
+            uint32_t byte_offset = get_uint(json_accessor, "byteOffset", 0);
+            accessor.buffer_view = buffer_views[buffer_view_index];
+            accessor.data = accessor.buffer_view.data + byte_offset;
+        }
 
-    if (accessor_index == (uint64_t)-1)
+        // Without a bufferView the elements are zeros, sparse values may then replace some of them
+        auto json_sparse = json_accessor.FindMember("sparse");
+        if (json_sparse != json_accessor.MemberEnd())
+        {
+            materialize_accessor(accessor, &json_sparse->value, buffer_views);
+        }
+        else if (!accessor.data)
+        {
+            materialize_accessor(accessor, nullptr, buffer_views);
+        }
+    }
+    return accessors;
+}
+
+static const Accessor& get_accessor(const std::vector<Accessor>& accessors, uint32_t accessor_index)
+{
+    static const Accessor empty_accessor;
+    if (accessor_index == (uint32_t)-1)
     {
-        return accessor;
+        return empty_accessor;
     }
+    return accessors[accessor_index];
+}
 
-    const auto& json_accessor = json["accessors"].GetArray()[accessor_index];
-    uint64_t buffer_view_index = json_accessor["bufferView"].GetUint64();
-    uint64_t byte_offset = 0;
-    if (json_accessor.HasMember("byteOffset"))
+// Returns the base64 payload of a data URI, or an empty string_view if uri is not a data URI
+static std::string_view data_uri_payload(std::string_view uri)
+{
+    if (!uri.starts_with("data:"))
     {
-        byte_offset = json_accessor["byteOffset"].GetUint64();
+        return {};
     }
+    size_t pos = uri.find(";base64,");
+    if (pos == std::string_view::npos)
+    {
+        throw std::runtime_error("Unsupported data URI encoding");
+    }
+    return uri.substr(pos + sizeof(";base64,") - 1);
+}
 
-    accessor.buffer_view = get_buffer_view(json, buffer_view_index, buffers);
-    accessor.data = accessor.buffer_view.data + byte_offset;
-    accessor.count = json_accessor["count"].GetUint();
-    accessor.component_type = uint_to_accessor_component_type(json_accessor["componentType"].GetUint());
-    accessor.type = string_to_accessor_type(json_accessor["type"].GetString());
-    return accessor;
+static void decode_data_uri(std::string_view payload, std::vector<uint8_t>& data)
+{
+    if (!bul::base64_decode(payload, data))
+    {
+        throw std::runtime_error("Invalid base64 data URI");
+    }
 }
 
 static std::vector<Buffer> load_buffers(const std::string& dir_path, rapidjson_document& json)
 {
+    PROFILE_SCOPE("gltf::load_buffers");
     std::vector<Buffer> buffers;
     const auto& json_buffers = json["buffers"].GetArray();
     buffers.reserve(json_buffers.Size());
     for (const auto& json_buffer : json_buffers)
     {
-        std::string_view uri = json_buffer["uri"].GetString();
-        std::string buffer_path = dir_path + uri.data();
+        const auto& json_uri = json_buffer["uri"];
+        std::string_view uri{json_uri.GetString(), json_uri.GetStringLength()};
         Buffer& buffer = buffers.emplace_back();
-        bul::read_file(buffer_path.c_str(), buffer);
+        if (std::string_view payload = data_uri_payload(uri); !payload.empty())
+        {
+            decode_data_uri(payload, buffer.decoded);
+            buffer.bytes = buffer.decoded;
+        }
+        else
+        {
+            // Primitives read their accessors front to back, each one is a sequential stream through the buffer
+            std::string buffer_path = dir_path + uri.data();
+            buffer.file.open(buffer_path.c_str(), bul::MappedFile::Access::Sequential);
+            buffer.bytes = buffer.file;
+        }
     }
     return buffers;
 }
@@ -167,20 +303,53 @@ static std::vector<Image> load_images(const std::string& dir_path, rapidjson_doc
     images.reserve(json_images.Size());
     for (const auto& json_image : json_images)
     {
-        std::string_view uri = json_image["uri"].GetString();
-        images.emplace_back(Image{dir_path + uri.data()});
+        const auto& json_uri = json_image["uri"];
+        std::string_view uri{json_uri.GetString(), json_uri.GetStringLength()};
+        Image& image = images.emplace_back();
+        auto json_mime_type = json_image.FindMember("mimeType");
+        std::string_view mime_type = json_mime_type != json_image.MemberEnd() ? json_mime_type->value.GetString() : "";
+        image.ktx2 = mime_type == "image/ktx2" || uri.starts_with("data:image/ktx2") || uri.ends_with(".ktx2");
+        if (std::string_view payload = data_uri_payload(uri); !payload.empty())
+        {
+            decode_data_uri(payload, image.data);
+        }
+        else
+        {
+            image.uri = dir_path + uri.data();
+        }
     }
     return images;
 }
 
-static std::vector<Texture> load_textures(rapidjson_document& json)
+static std::vector<Texture> load_textures(rapidjson_document& json, const std::vector<Image>& images)
 {
     std::vector<Texture> textures;
     const auto& json_textures = json["textures"].GetArray();
     textures.reserve(json_textures.Size());
     for (const auto& json_texture : json_textures)
     {
-        uint32_t source_image = json_texture["source"].GetUint();
+        // KHR_texture_basisu points to a KTX2 image, source is then an optional fallback. Basis Universal payloads
+        // are not transcoded, the fallback is used unless the KTX2 image has a Vulkan format
+        uint32_t source_image = get_uint(json_texture, "source", -1);
+        auto extensions = json_texture.FindMember("extensions");
+        if (extensions != json_texture.MemberEnd())
+        {
+            auto basisu = extensions->value.FindMember("KHR_texture_basisu");
+            if (basisu != extensions->value.MemberEnd())
+            {
+                uint32_t basisu_image = basisu->value["source"].GetUint();
+                const Image& image = images[basisu_image];
+                if (source_image == (uint32_t)-1
+                    || (image.data.empty() ? ktx2::can_load(image.uri) : ktx2::can_load(image.data)))
+                {
+                    source_image = basisu_image;
+                }
+            }
+        }
+        if (source_image == (uint32_t)-1)
+        {
+            source_image = 0;
+        }
         textures.emplace_back(Texture{source_image});
     }
     return textures;
@@ -201,13 +370,16 @@ static std::vector<Material> load_materials(rapidjson_document& json)
             material.base_color_factor[i] = base_color_factor[i].GetFloat();
         }
         material.base_color_tex = pbr["baseColorTexture"]["index"].GetUint();
+        material.metallic_roughness_tex = get_texture(pbr, "metallicRoughnessTexture");
+        material.normal_tex = get_texture(json_material, "normalTexture");
+        material.occlusion_tex = get_texture(json_material, "occlusionTexture");
     }
     return materials;
 }
 
-static std::vector<Primitive> load_primitives(rapidjson_document& json, const rapidjson_array& json_primitives,
-                                              const std::vector<Buffer>& buffers, std::vector<Vertex>& vertices,
-                                              std::vector<uint32_t>& indices)
+static std::vector<Primitive> load_primitives(const rapidjson_array& json_primitives,
+                                              const std::vector<Accessor>& accessors, std::vector<Vertex>& vertices,
+                                              std::vector<uint32_t>& indices, std::vector<Primitive>& missing_tangents)
 {
     std::vector<Primitive> primitives;
     primitives.reserve(json_primitives.Size());
@@ -217,17 +389,11 @@ static std::vector<Primitive> load_primitives(rapidjson_document& json, const ra
         primitive.vertex_start = (uint32_t)vertices.size();
         primitive.index_start = (uint32_t)indices.size();
 
-        if (json_primitive.HasMember("material"))
-        {
-            primitive.material = json_primitive["material"].GetUint();
-        }
-        if (json_primitive.HasMember("mode"))
-        {
-            primitive.mode = (PrimitiveMode)json_primitive["mode"].GetUint();
-        }
+        primitive.material = get_uint(json_primitive, "material", 0);
+        primitive.mode = (PrimitiveMode)get_uint(json_primitive, "mode", TRIANGLES);
 
-        uint64_t indices_index = json_primitive["indices"].GetUint64();
-        Accessor indices_accessor = get_accessor(json, indices_index, buffers);
+        uint32_t indices_index = json_primitive["indices"].GetUint();
+        const Accessor& indices_accessor = get_accessor(accessors, indices_index);
         ASSERT(indices_accessor.type == AccessorType::SCALAR);
         primitive.index_count = indices_accessor.count;
 
@@ -266,12 +432,8 @@ static std::vector<Primitive> load_primitives(rapidjson_document& json, const ra
 
         const auto& json_attributes = json_primitive["attributes"];
 
-        uint64_t position_accessor_index = -1;
-        if (json_attributes.HasMember("POSITION"))
-        {
-            position_accessor_index = json_attributes["POSITION"].GetUint64();
-        }
-        Accessor position_accessor = get_accessor(json, position_accessor_index, buffers);
+        uint32_t position_accessor_index = get_uint(json_attributes, "POSITION", -1);
+        const Accessor& position_accessor = get_accessor(accessors, position_accessor_index);
         const uint8_t* position_data = position_accessor.data;
         uint32_t position_step = sizeof(bul::vec3f);
         if (position_accessor.buffer_view.byte_stride)
@@ -279,12 +441,8 @@ static std::vector<Primitive> load_primitives(rapidjson_document& json, const ra
             position_step = position_accessor.buffer_view.byte_stride;
         }
 
-        uint64_t normal_accessor_index = -1;
-        if (json_attributes.HasMember("NORMAL"))
-        {
-            normal_accessor_index = json_attributes["NORMAL"].GetUint64();
-        }
-        Accessor normal_accessor = get_accessor(json, normal_accessor_index, buffers);
+        uint32_t normal_accessor_index = get_uint(json_attributes, "NORMAL", -1);
+        const Accessor& normal_accessor = get_accessor(accessors, normal_accessor_index);
         const uint8_t* normal_data = normal_accessor.data;
         uint32_t normal_step = sizeof(bul::vec3f);
         if (normal_accessor.buffer_view.byte_stride)
@@ -292,12 +450,17 @@ static std::vector<Primitive> load_primitives(rapidjson_document& json, const ra
             normal_step = normal_accessor.buffer_view.byte_stride;
         }
 
-        uint64_t uv_0_accessor_index = -1;
-        if (json_attributes.HasMember("TEXCOORD_0"))
+        uint32_t tangent_accessor_index = get_uint(json_attributes, "TANGENT", -1);
+        const Accessor& tangent_accessor = get_accessor(accessors, tangent_accessor_index);
+        const uint8_t* tangent_data = tangent_accessor.data;
+        uint32_t tangent_step = sizeof(bul::vec4f);
+        if (tangent_accessor.buffer_view.byte_stride)
         {
-            uv_0_accessor_index = json_attributes["TEXCOORD_0"].GetUint64();
+            tangent_step = tangent_accessor.buffer_view.byte_stride;
         }
-        Accessor uv_0_accessor = get_accessor(json, uv_0_accessor_index, buffers);
+
+        uint32_t uv_0_accessor_index = get_uint(json_attributes, "TEXCOORD_0", -1);
+        const Accessor& uv_0_accessor = get_accessor(accessors, uv_0_accessor_index);
         const uint8_t* uv_0_data = uv_0_accessor.data;
         uint32_t uv_0_step = sizeof(bul::vec2f);
         if (uv_0_accessor.buffer_view.byte_stride)
@@ -305,33 +468,141 @@ static std::vector<Primitive> load_primitives(rapidjson_document& json, const ra
             uv_0_step = uv_0_accessor.buffer_view.byte_stride;
         }
 
-        size_t count = std::max(position_accessor.count, std::max(normal_accessor.count, uv_0_accessor.count));
+        // Attributes should all have the same count, a shorter accessor leaves the rest of its attribute zeroed
+        size_t count = std::max(std::max(position_accessor.count, normal_accessor.count),
+                                std::max(tangent_accessor.count, uv_0_accessor.count));
         for (size_t i = 0; i < count; ++i)
         {
             Vertex& vertex = vertices.emplace_back();
-            if (position_data)
+            if (i < position_accessor.count)
             {
                 vertex.position = bul::vec4f{get_value<bul::vec3f>(position_data), 1.0f};
                 position_data += position_step;
             }
-            if (normal_data)
+            if (i < normal_accessor.count)
             {
                 vertex.normal = bul::vec4f{get_value<bul::vec3f>(normal_data), 1.0f};
                 normal_data += normal_step;
             }
-            if (uv_0_data)
+            if (i < tangent_accessor.count)
+            {
+                vertex.tangent = get_value<bul::vec4f>(tangent_data);
+                tangent_data += tangent_step;
+            }
+            if (i < uv_0_accessor.count)
             {
                 vertex.uv_0 = get_value<bul::vec2f>(uv_0_data);
                 uv_0_data += uv_0_step;
             }
         }
+        primitive.vertex_count = (uint32_t)count;
+
+        if (tangent_accessor.count < count && normal_data && uv_0_data && primitive.mode == TRIANGLES)
+        {
+            missing_tangents.push_back(primitive);
+        }
     }
     return primitives;
 }
 
-static std::vector<Mesh> load_meshes(rapidjson_document& json, const std::vector<Buffer>& buffers,
-                                     std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+static bul::vec3f xyz(const bul::vec4f& v)
+{
+    return {v.x, v.y, v.z};
+}
+
+static bul::vec3f safe_normalize(const bul::vec3f& v)
 {
+    float len = bul::length(v);
+    return len > 1e-20f ? v / len : bul::vec3f{0, 0, 0};
+}
+
+// Projects v on the plane orthogonal to the unit vector n
+static bul::vec3f project(const bul::vec3f& v, const bul::vec3f& n)
+{
+    return v - n * bul::dot(n, v);
+}
+
+/*
+ * Tangent frames following MikkTSpace: the uv derivatives of every face are projected on the tangent
+ * plane of each corner normal and accumulated with the corner angle as weight, the bitangent sign gives
+ * the handedness. glTF vertices are already split on normal and uv seams, so unlike MikkTSpace no
+ * vertices are merged or split.
+ */
+static void generate_tangents(const Primitive& primitive, std::vector<Vertex>& vertices,
+                              const std::vector<uint32_t>& indices)
+{
+    std::vector<bul::vec3f> tangents(primitive.vertex_count);
+    std::vector<bul::vec3f> bitangents(primitive.vertex_count);
+
+    for (uint32_t i = 0; i + 2 < primitive.index_count; i += 3)
+    {
+        const uint32_t* corners = &indices[primitive.index_start + i];
+        bul::vec3f positions[3];
+        bul::vec2f uvs[3];
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            positions[c] = xyz(vertices[corners[c]].position);
+            uvs[c] = vertices[corners[c]].uv_0;
+        }
+
+        bul::vec3f e_1 = positions[1] - positions[0];
+        bul::vec3f e_2 = positions[2] - positions[0];
+        bul::vec2f d_1 = uvs[1] - uvs[0];
+        bul::vec2f d_2 = uvs[2] - uvs[0];
+        float uv_area = d_1.x * d_2.y - d_2.x * d_1.y;
+        if (std::abs(uv_area) < 1e-20f)
+        {
+            continue;
+        }
+        bul::vec3f face_tangent = (e_1 * d_2.y - e_2 * d_1.y) / uv_area;
+        bul::vec3f face_bitangent = (e_2 * d_1.x - e_1 * d_2.x) / uv_area;
+
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            bul::vec3f n = xyz(vertices[corners[c]].normal);
+            bul::vec3f next = safe_normalize(project(positions[(c + 1) % 3] - positions[c], n));
+            bul::vec3f prev = safe_normalize(project(positions[(c + 2) % 3] - positions[c], n));
+            float angle = std::acos(std::clamp(bul::dot(next, prev), -1.0f, 1.0f));
+
+            uint32_t vertex = corners[c] - primitive.vertex_start;
+            tangents[vertex] += safe_normalize(project(face_tangent, n)) * angle;
+            bitangents[vertex] += safe_normalize(project(face_bitangent, n)) * angle;
+        }
+    }
+
+    for (uint32_t i = 0; i < primitive.vertex_count; ++i)
+    {
+        Vertex& vertex = vertices[primitive.vertex_start + i];
+        bul::vec3f n = xyz(vertex.normal);
+        bul::vec3f t = safe_normalize(project(tangents[i], n));
+        if (t == bul::vec3f{0, 0, 0})
+        {
+            // No usable uv derivatives, any vector orthogonal to the normal will do
+            t = safe_normalize(project(std::abs(n.x) < 0.9f ? bul::right : bul::up, n));
+        }
+        float sign = bul::dot(bul::cross(n, t), bitangents[i]) < 0.0f ? -1.0f : 1.0f;
+        vertex.tangent = bul::vec4f{t, sign};
+    }
+}
+
+void generate_tangents(const std::vector<Primitive>& primitives, std::vector<Vertex>& vertices,
+                       const std::vector<uint32_t>& indices)
+{
+    PROFILE_SCOPE("gltf::generate_tangents");
+    bul::jobs::parallel_for((uint32_t)primitives.size(), [&](uint32_t begin, uint32_t end) {
+        PROFILE_SCOPE("gltf::generate_tangents job");
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            generate_tangents(primitives[i], vertices, indices);
+        }
+    });
+}
+
+static std::vector<Mesh> load_meshes(rapidjson_document& json, const std::vector<Accessor>& accessors,
+                                     std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                                     std::vector<Primitive>& missing_tangents)
+{
+    PROFILE_SCOPE("gltf::load_meshes");
     std::vector<Mesh> meshes;
     const auto& json_meshes = json["meshes"].GetArray();
     meshes.reserve(json_meshes.Size());
@@ -339,7 +610,7 @@ static std::vector<Mesh> load_meshes(rapidjson_document& json, const std::vector
     {
         Mesh& mesh = meshes.emplace_back();
         const auto& json_primitives = json_mesh["primitives"].GetArray();
-        mesh.primitives = load_primitives(json, json_primitives, buffers, vertices, indices);
+        mesh.primitives = load_primitives(json_primitives, accessors, vertices, indices, missing_tangents);
     }
     return meshes;
 }
@@ -449,6 +720,8 @@ static void compute_nodes_transform(const std::vector<uint32_t>& scene, std::vec
 
 Model load(std::string_view gltf_path)
 {
+    PROFILE_SCOPE("gltf::load");
+    bul::memory::Scope memory_scope{bul::memory::Tag::Loaders};
     std::cout << "Loading model " << gltf_path << "...\n";
 
     size_t dir_separator_index = gltf_path.find_last_of('/');
@@ -458,18 +731,28 @@ Model load(std::string_view gltf_path)
     }
     std::string dir_path{gltf_path.substr(0, dir_separator_index + 1)};
 
+    // Parse in-situ: strings are decoded in place and the DOM points into json_data instead of copying them
     std::vector<uint8_t> json_data;
-    bul::read_file(gltf_path.data(), json_data);
     rapidjson_document json;
-    json.Parse((const char*)json_data.data(), json_data.size());
+    {
+        PROFILE_SCOPE("gltf::load json");
+        bul::read_file(gltf_path.data(), json_data);
+        json_data.push_back('\0');
+        json.ParseInsitu((char*)json_data.data());
+    }
 
+    // Resolve bufferViews and accessors once so primitive loading only indexes into typed tables
     const auto& buffers = load_buffers(dir_path, json);
+    const auto& buffer_views = load_buffer_views(json, buffers);
+    const auto& accessors = load_accessors(json, buffer_views);
 
     Model model;
     model.images = load_images(dir_path, json);
-    model.textures = load_textures(json);
+    model.textures = load_textures(json, model.images);
     model.materials = load_materials(json);
-    model.meshes = load_meshes(json, buffers, model.vertices, model.indices);
+    std::vector<Primitive> missing_tangents;
+    model.meshes = load_meshes(json, accessors, model.vertices, model.indices, missing_tangents);
+    generate_tangents(missing_tangents, model.vertices, model.indices);
     model.nodes = load_nodes(json);
     model.scene_nodes = load_scene(json);
     compute_nodes_transform(model.scene_nodes, model.nodes);
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <string>
 #include <string_view>
 #include <vector>
 
 #include "bul/math/vector.h"
 #include "bul/math/matrix.h"
+#include "bul/containers/small_vector.h"
 
 namespace gltf
 {
@@ -23,6 +25,8 @@ struct Vertex
 {
     bul::vec4f position{0, 0, 0, 0};
     bul::vec4f normal{0, 0, 0, 0};
+    // w is the handedness of the bitangent
+    bul::vec4f tangent{0, 0, 0, 0};
     bul::vec2f uv_0{0, 0};
     bul::vec2f uv_1{0, 0};
 };
@@ -30,6 +34,10 @@ struct Vertex
 struct Image
 {
     std::string uri;
+    // Encoded file contents for images embedded as data URIs, uri is empty in that case
+    std::vector<uint8_t> data;
+    // KTX2 container with pre-built mips, uploaded as is
+    bool ktx2 = false;
 };
 
 struct Texture
@@ -37,15 +45,20 @@ struct Texture
     uint32_t source_image;
 };
 
+// Textures are indices into Model::textures, -1 when the material has none
 struct Material
 {
     bul::vec4f base_color_factor{1, 1, 1, 1};
     uint32_t base_color_tex;
+    uint32_t metallic_roughness_tex = -1;
+    uint32_t normal_tex = -1;
+    uint32_t occlusion_tex = -1;
 };
 
 struct Primitive
 {
     uint32_t vertex_start;
+    uint32_t vertex_count;
     uint32_t index_start;
     uint32_t index_count;
     uint32_t material;
@@ -59,7 +72,7 @@ struct Mesh
 
 struct Node
 {
-    std::vector<uint32_t> children;
+    bul::SmallVector<uint32_t, 4> children;
     uint32_t mesh = -1;
     bul::mat4f transform = bul::mat4f::identity();
 };
@@ -78,4 +91,9 @@ struct Model
 };
 
 Model load(std::string_view gltf_path);
+
+// Tangents of triangle list primitives from their normals and first uvs, one primitive per job. load calls it for the
+// primitives without tangents
+void generate_tangents(const std::vector<Primitive>& primitives, std::vector<Vertex>& vertices,
+                       const std::vector<uint32_t>& indices);
 } // namespace gltf
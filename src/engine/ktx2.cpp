@@ -0,0 +1,130 @@
+#include "ktx2.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "bul/file.h"
+
+namespace ktx2
+{
+static constexpr uint8_t IDENTIFIER[12] = {0xab, 'K', 'T', 'X', ' ', '2', '0', 0xbb, '\r', '\n', 0x1a, '\n'};
+
+struct Header
+{
+    uint8_t identifier[12];
+    uint32_t vk_format;
+    uint32_t type_size;
+    uint32_t pixel_width;
+    uint32_t pixel_height;
+    uint32_t pixel_depth;
+    uint32_t layer_count;
+    uint32_t face_count;
+    uint32_t level_count;
+    uint32_t supercompression_scheme;
+
+    uint32_t dfd_byte_offset;
+    uint32_t dfd_byte_length;
+    uint32_t kvd_byte_offset;
+    uint32_t kvd_byte_length;
+    uint64_t sgd_byte_offset;
+    uint64_t sgd_byte_length;
+};
+static_assert(sizeof(Header) == 80);
+
+struct LevelIndex
+{
+    uint64_t byte_offset;
+    uint64_t byte_length;
+    uint64_t uncompressed_byte_length;
+};
+
+// Returns the reason the file cannot be loaded, or nullptr
+static const char* unsupported(const Header& header)
+{
+    if (std::memcmp(header.identifier, IDENTIFIER, sizeof(IDENTIFIER)) != 0)
+    {
+        return "Invalid KTX2 identifier";
+    }
+    if (header.vk_format == VK_FORMAT_UNDEFINED || header.supercompression_scheme != 0)
+    {
+        return "Supercompressed KTX2 files are not supported";
+    }
+    if (header.layer_count > 1 || header.face_count != 1)
+    {
+        return "KTX2 arrays and cube maps are not supported";
+    }
+    return nullptr;
+}
+
+bool can_load(std::span<const uint8_t> file_data)
+{
+    Header header;
+    if (file_data.size() < sizeof(header))
+    {
+        return false;
+    }
+    std::memcpy(&header, file_data.data(), sizeof(header));
+    return unsupported(header) == nullptr;
+}
+
+bool can_load(const std::string& path)
+{
+    uint8_t header[sizeof(Header)];
+    return bul::read_file(path.c_str(), header, sizeof(header)) && can_load(header);
+}
+
+Texture load(const std::string& path)
+{
+    std::vector<uint8_t> file_data;
+    if (!bul::read_file(path.c_str(), file_data))
+    {
+        throw std::runtime_error("Could not read KTX2 file " + path);
+    }
+    return load(std::move(file_data));
+}
+
+Texture load(std::vector<uint8_t> file_data)
+{
+    Header header;
+    if (file_data.size() < sizeof(header))
+    {
+        throw std::runtime_error("Invalid KTX2 file");
+    }
+    std::memcpy(&header, file_data.data(), sizeof(header));
+
+    if (const char* reason = unsupported(header))
+    {
+        throw std::runtime_error(reason);
+    }
+
+    // A level count of 0 asks the loader to generate the mips, only the base level is stored
+    uint32_t level_count = std::max(header.level_count, 1u);
+    if (file_data.size() < sizeof(header) + level_count * sizeof(LevelIndex))
+    {
+        throw std::runtime_error("Invalid KTX2 level index");
+    }
+
+    Texture texture;
+    texture.format = (VkFormat)header.vk_format;
+    texture.width = header.pixel_width;
+    texture.height = std::max(header.pixel_height, 1u);
+    texture.depth = std::max(header.pixel_depth, 1u);
+    texture.levels.resize(level_count);
+
+    const uint8_t* level_index = file_data.data() + sizeof(header);
+    for (uint32_t i = 0; i < level_count; ++i)
+    {
+        LevelIndex index;
+        std::memcpy(&index, level_index + i * sizeof(LevelIndex), sizeof(LevelIndex));
+        if (index.byte_offset + index.byte_length > file_data.size())
+        {
+            throw std::runtime_error("KTX2 level out of bounds");
+        }
+        texture.levels[i] = Level{.offset = index.byte_offset, .size = index.byte_length};
+    }
+
+    texture.data = std::move(file_data);
+    return texture;
+}
+} // namespace ktx2
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <volk.h>
+
+namespace ktx2
+{
+struct Level
+{
+    uint64_t offset;
+    uint64_t size;
+};
+
+struct Texture
+{
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t depth = 1;
+    // Level 0 is the largest, offsets point into data
+    std::vector<Level> levels;
+    std::vector<uint8_t> data;
+};
+
+// Only files with a Vulkan format and no supercompression are supported, Basis Universal payloads need transcoding
+Texture load(const std::string& path);
+Texture load(std::vector<uint8_t> file_data);
+
+// Checks the header only, false for the files load rejects such as the Basis Universal ones
+bool can_load(std::span<const uint8_t> file_data);
+bool can_load(const std::string& path);
+} // namespace ktx2
@@ -3,6 +3,7 @@
 #include <iostream>
 
 #include "bul/math/matrix.h"
+#include "bul/profiler.h"
 #include "bul/window.h"
 #include "bul/time.h"
 
@@ -178,6 +179,7 @@ void PathTracingRenderer::reload_shaders()
 
 void PathTracingRenderer::render()
 {
+    PROFILE_SCOPE("PathTracingRenderer::render");
     if (!p_device->acquire_next_image(*p_surface))
     {
         resize();
@@ -194,6 +196,7 @@ void PathTracingRenderer::render()
     {
         frame_number = 0;
     }
+    PROFILE_COUNTER("accumulated frames", frame_number);
 
     auto& fc = p_device->frame_context();
     auto& cmd = p_device->get_graphics_command();
@@ -312,4 +315,5 @@ void PathTracingRenderer::render_gui()
     }
 
     ImGui::End();
+    vk::imgui_profiler();
 }
@@ -3,6 +3,7 @@
 #include <iostream>
 
 #include "bul/math/matrix.h"
+#include "bul/profiler.h"
 #include "bul/time.h"
 #include "bul/window.h"
 
@@ -10,6 +11,8 @@
 #include "device.h"
 #include "surface.h"
 #include "imgui.h"
+#include "texture.h"
+#include "ktx2.h"
 
 struct GlobalUniformSet
 {
@@ -23,6 +26,64 @@ struct GlobalUniformSet
     uint32_t frame_number;
 };
 
+// Push constants of test.vert and test.frag, the resources are indices in the bindless set
+struct DrawConstants
+{
+    bul::mat4f transform;
+    uint32_t vertex_buffer;
+    uint32_t base_color;
+};
+static_assert(sizeof(DrawConstants) <= vk::Device::PUSH_CONSTANTS_SIZE);
+
+static VkFormat to_vk_format(const texture::Texture& texture)
+{
+    switch (texture.format)
+    {
+    case texture::Format::BC1:
+        return texture.srgb ? VK_FORMAT_BC1_RGBA_SRGB_BLOCK : VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+    case texture::Format::BC3:
+        return texture.srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+    case texture::Format::BC4:
+        return VK_FORMAT_BC4_UNORM_BLOCK;
+    case texture::Format::BC5:
+        return VK_FORMAT_BC5_UNORM_BLOCK;
+    case texture::Format::BC7:
+        return texture.srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+    default:
+        return texture.srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+    }
+}
+
+// Cooked KTX2 levels are copied as is, the staging buffer only spans the level data of the file
+static bul::Handle<vk::Image> upload_ktx2(vk::Device& device, vk::TransferCommand& transfer_cmd,
+                                         const gltf::Image& image)
+{
+    ktx2::Texture texture = image.data.empty() ? ktx2::load(image.uri) : ktx2::load(image.data);
+
+    uint64_t begin = UINT64_MAX;
+    uint64_t end = 0;
+    for (const auto& level : texture.levels)
+    {
+        begin = std::min(begin, level.offset);
+        end = std::max(end, level.offset + level.size);
+    }
+
+    std::vector<uint32_t> level_offsets;
+    for (const auto& level : texture.levels)
+    {
+        level_offsets.push_back((uint32_t)(level.offset - begin));
+    }
+
+    auto handle = device.create_image({.width = texture.width,
+                                       .height = texture.height,
+                                       .depth = texture.depth,
+                                       .type = texture.depth > 1 ? VK_IMAGE_TYPE_3D : VK_IMAGE_TYPE_2D,
+                                       .format = texture.format,
+                                       .mip_levels = (uint32_t)texture.levels.size()});
+    transfer_cmd.upload_image(handle, texture.data.data() + begin, (uint32_t)(end - begin), level_offsets);
+    return handle;
+}
+
 Renderer Renderer::create(vk::Context& context, vk::Device& device, vk::Surface& surface)
 {
     Renderer renderer;
@@ -48,8 +109,9 @@ void Renderer::init()
     auto& cmd = p_device->get_graphics_command();
     {
         auto& transfer_cmd = p_device->get_transfer_command();
-        model = gltf::load("../models/Sponza/glTF/Sponza.gltf");
-        // model = gltf::load("../models/backpack/scene.gltf");
+        std::string model_path = "../models/Sponza/glTF/Sponza.gltf";
+        // std::string model_path = "../models/backpack/scene.gltf";
+        model = gltf::load(model_path);
         model_vertex_buffer =
             p_device->create_buffer({.size = (uint32_t)(model.vertices.size() * sizeof(gltf::Vertex))});
         model_index_buffer =
@@ -59,26 +121,50 @@ void Renderer::init()
         transfer_cmd.upload_buffer(model_vertex_buffer, model.vertices.data(), model.vertices.size() * sizeof(gltf::Vertex));
         transfer_cmd.upload_buffer(model_index_buffer, model.indices.data(), model.indices.size() * sizeof(uint32_t));
 
-        model_images.reserve(model.images.size());
-        for (const auto& image : model.images)
+        // Images no material uses get no handle
+        auto import_options = texture::material_import_options(model);
+        std::vector<texture::Texture> textures =
+            texture::import_images(model.images, import_options, texture::cache_dir(model_path));
+        model_images.resize(textures.size());
+        for (uint32_t i = 0; i < model.images.size(); ++i)
         {
-            model_images.push_back(p_device->create_image({}, image.uri));
-            transfer_cmd.upload_image(model_images.back(), image.uri);
+            if (!import_options[i])
+            {
+                continue;
+            }
+            if (model.images[i].ktx2)
+            {
+                model_images[i] = upload_ktx2(*p_device, transfer_cmd, model.images[i]);
+                continue;
+            }
+
+            const auto& texture = textures[i];
+            model_images[i] = p_device->create_image({.width = texture.width,
+                                                      .height = texture.height,
+                                                      .format = to_vk_format(texture),
+                                                      .mip_levels = (uint32_t)texture.levels.size()});
+            std::vector<uint32_t> level_offsets;
+            for (const auto& level : texture.levels)
+            {
+                level_offsets.push_back(level.offset);
+            }
+            transfer_cmd.upload_image(model_images[i], texture.data.data(), (uint32_t)texture.data.size(),
+                                      level_offsets);
         }
 
         p_device->submit_blocking(transfer_cmd);
 
         for (auto& image : model_images)
         {
-            cmd.barrier(image, vk::ImageUsage::GraphicsShaderRead);
+            if (image.is_valid())
+            {
+                cmd.barrier(image, vk::ImageUsage::GraphicsShaderRead);
+            }
         }
     }
     {
         vk::GraphicsProgramDescription prog_desc{};
         prog_desc.attachment_formats = p_device->framebuffers.get(render_target).description;
-        prog_desc.descriptor_types = {vk::DescriptorType::create(vk::DescriptorType::Type::StorageBuffer),
-                                      vk::DescriptorType::create(vk::DescriptorType::Type::DynamicBuffer),
-                                      vk::DescriptorType::create(vk::DescriptorType::Type::SampledImage)};
         prog_desc.vertex_shader = p_device->create_shader("shaders/test.vert");
         prog_desc.fragment_shader = p_device->create_shader("shaders/test.frag");
         graphics_program = p_device->create_graphics_program(prog_desc);
@@ -153,6 +239,7 @@ void Renderer::resize()
 
 void Renderer::render()
 {
+    PROFILE_SCOPE("Renderer::render");
     if (!p_device->acquire_next_image(*p_surface))
     {
         resize();
@@ -191,14 +278,19 @@ void Renderer::render()
     cmd.barrier(rt_color, vk::ImageUsage::ColorAttachment);
     cmd.begin_renderpass(render_target, {vk::LoadOp::clear_color(), vk::LoadOp::clear_depth()});
     cmd.bind_index_buffer(model_index_buffer, VK_INDEX_TYPE_UINT32, 0);
-    cmd.bind_storage_buffer(graphics_program, model_vertex_buffer, 0);
+    cmd.bind_pipeline(graphics_program);
+    cmd.bind_bindless_set(graphics_program);
 
+    // The only per draw state, no descriptor set is bound in the loop
+    DrawConstants constants{};
+    constants.vertex_buffer = vk::bindless_index(model_vertex_buffer);
+    uint32_t draw_count = 0;
     for (const auto& node : model.nodes)
     {
         if (node.mesh == (uint32_t)-1)
             continue;
 
-        uniform_offset = global_uniform_buffer.push(&node.transform, sizeof(bul::mat4f));
+        constants.transform = node.transform;
 
         const auto& mesh = model.meshes[node.mesh];
         for (const auto& primitive : mesh.primitives)
@@ -206,15 +298,15 @@ void Renderer::render()
             const auto& material = model.materials[primitive.material];
             const auto& image_handle = model_images[model.textures[material.base_color_tex].source_image];
 
-            cmd.bind_uniform_buffer(graphics_program, global_uniform_buffer.buffer_handle, 1, uniform_offset,
-                                    sizeof(bul::mat4f));
-            cmd.bind_image(graphics_program, image_handle, 2);
-            cmd.bind_pipeline(graphics_program);
+            constants.base_color = vk::bindless_index(image_handle);
+            cmd.push_constants(graphics_program, &constants, sizeof(constants));
 
             cmd.draw_indexed(primitive.index_count, primitive.index_start);
+            ++draw_count;
         }
     }
     cmd.end_renderpass();
+    PROFILE_COUNTER("draws", draw_count);
 
     // tonemap
 
@@ -300,4 +392,5 @@ void Renderer::render_gui()
     }
 
     ImGui::End();
+    vk::imgui_profiler();
 }
@@ -0,0 +1,1279 @@
+#include "texture.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+
+#include <stb/stb_image.h>
+
+#include "bul/bul.h"
+#include "bul/file.h"
+#include "bul/hash.h"
+#include "bul/io.h"
+#include "bul/jobs.h"
+#include "bul/memory.h"
+#include "bul/time.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define TEXTURE_SSE
+#include <emmintrin.h>
+#endif
+
+namespace texture
+{
+static constexpr uint32_t CACHE_MAGIC = 0x58455442; // BTEX
+static constexpr uint32_t CACHE_VERSION = 1;
+
+struct CacheHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    Format format;
+    uint32_t srgb;
+    uint32_t width;
+    uint32_t height;
+    uint32_t level_count;
+    uint32_t data_size;
+};
+
+uint32_t mip_count(uint32_t width, uint32_t height)
+{
+    uint32_t count = 1;
+    while (width > 1 || height > 1)
+    {
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+        ++count;
+    }
+    return count;
+}
+
+static uint32_t block_size(Format format)
+{
+    return format == Format::BC1 || format == Format::BC4 ? 8 : 16;
+}
+
+static uint32_t level_size(Format format, uint32_t width, uint32_t height)
+{
+    if (format == Format::RGBA8)
+    {
+        return width * height * 4;
+    }
+    return ((width + 3) / 4) * ((height + 3) / 4) * block_size(format);
+}
+
+/* sRGB conversions */
+
+static constexpr uint32_t LINEAR_TO_SRGB_SIZE = 8192;
+
+struct SrgbTables
+{
+    SrgbTables()
+    {
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            float c = i / 255.0f;
+            to_linear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        for (uint32_t i = 0; i < LINEAR_TO_SRGB_SIZE; ++i)
+        {
+            float l = (float)i / (LINEAR_TO_SRGB_SIZE - 1);
+            float s = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+            from_linear[i] = (uint8_t)(s * 255.0f + 0.5f);
+        }
+    }
+
+    float to_linear[256];
+    uint8_t from_linear[LINEAR_TO_SRGB_SIZE];
+};
+
+static const SrgbTables& srgb_tables()
+{
+    static const SrgbTables tables;
+    return tables;
+}
+
+static void to_float(const uint8_t* rgba, uint32_t pixel_count, bool srgb, float* dst)
+{
+    const float* to_linear = srgb_tables().to_linear;
+    for (uint32_t i = 0; i < pixel_count * 4; i += 4)
+    {
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            dst[i + c] = srgb ? to_linear[rgba[i + c]] : rgba[i + c] / 255.0f;
+        }
+        dst[i + 3] = rgba[i + 3] / 255.0f;
+    }
+}
+
+static void to_rgba8(const float* src, uint32_t pixel_count, bool srgb, uint8_t* rgba)
+{
+    const uint8_t* from_linear = srgb_tables().from_linear;
+    float color_scale = srgb ? LINEAR_TO_SRGB_SIZE - 1 : 255.0f;
+#if defined(TEXTURE_SSE)
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_setr_ps(color_scale, color_scale, color_scale, 255.0f);
+    for (uint32_t i = 0; i < pixel_count * 4; i += 4)
+    {
+        __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), zero), one);
+        alignas(16) int32_t indices[4];
+        _mm_store_si128((__m128i*)indices, _mm_cvtps_epi32(_mm_mul_ps(v, scale)));
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            rgba[i + c] = srgb ? from_linear[indices[c]] : (uint8_t)indices[c];
+        }
+        rgba[i + 3] = (uint8_t)indices[3];
+    }
+#else
+    for (uint32_t i = 0; i < pixel_count * 4; i += 4)
+    {
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            float v = std::clamp(src[i + c], 0.0f, 1.0f);
+            uint32_t index = (uint32_t)(v * (c < 3 ? color_scale : 255.0f) + 0.5f);
+            rgba[i + c] = srgb && c < 3 ? from_linear[index] : (uint8_t)index;
+        }
+    }
+#endif
+}
+
+/* Mip generation */
+
+// 2x2 box filter on linear RGBA32F, edge texels are repeated for odd sizes
+static void downsample_box(const float* src, uint32_t src_width, uint32_t src_height, float* dst, uint32_t dst_width,
+                       uint32_t dst_height)
+{
+    for (uint32_t y = 0; y < dst_height; ++y)
+    {
+        const float* row_0 = src + std::min(2 * y, src_height - 1) * src_width * 4;
+        const float* row_1 = src + std::min(2 * y + 1, src_height - 1) * src_width * 4;
+        for (uint32_t x = 0; x < dst_width; ++x)
+        {
+            uint32_t x_0 = std::min(2 * x, src_width - 1) * 4;
+            uint32_t x_1 = std::min(2 * x + 1, src_width - 1) * 4;
+            float* out = dst + (y * dst_width + x) * 4;
+#if defined(TEXTURE_SSE)
+            __m128 top = _mm_add_ps(_mm_loadu_ps(row_0 + x_0), _mm_loadu_ps(row_0 + x_1));
+            __m128 bottom = _mm_add_ps(_mm_loadu_ps(row_1 + x_0), _mm_loadu_ps(row_1 + x_1));
+            _mm_storeu_ps(out, _mm_mul_ps(_mm_add_ps(top, bottom), _mm_set1_ps(0.25f)));
+#else
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                out[c] = (row_0[x_0 + c] + row_0[x_1 + c] + row_1[x_0 + c] + row_1[x_1 + c]) * 0.25f;
+            }
+#endif
+        }
+    }
+}
+
+// Kaiser windowed sinc, 3 destination texels on each side with alpha 4 like NVTT
+static constexpr float KAISER_WIDTH = 3.0f;
+static constexpr float KAISER_ALPHA = 4.0f;
+
+static float bessel_i0(float x)
+{
+    float sum = 1.0f;
+    float term = 1.0f;
+    for (uint32_t k = 1; k < 16; ++k)
+    {
+        float t = x / (2.0f * k);
+        term *= t * t;
+        sum += term;
+    }
+    return sum;
+}
+
+// x is in destination texels
+static float kaiser(float x)
+{
+    float t = x / KAISER_WIDTH;
+    if (std::abs(t) >= 1.0f)
+    {
+        return 0.0f;
+    }
+    float sinc = x == 0.0f ? 1.0f : std::sin(3.14159265f * x) / (3.14159265f * x);
+    return sinc * bessel_i0(KAISER_ALPHA * std::sqrt(1.0f - t * t)) / bessel_i0(KAISER_ALPHA);
+}
+
+// Source texels and normalized weights of every destination texel along one axis, edge texels are repeated
+struct Kernel
+{
+    uint32_t taps = 0;
+    std::vector<uint32_t> indices;
+    std::vector<float> weights;
+};
+
+static Kernel kaiser_kernel(uint32_t src_size, uint32_t dst_size)
+{
+    float scale = (float)src_size / dst_size;
+    float radius = KAISER_WIDTH * scale;
+
+    Kernel kernel;
+    kernel.taps = (uint32_t)std::ceil(2.0f * radius) + 1;
+    kernel.indices.resize(dst_size * kernel.taps);
+    kernel.weights.resize(dst_size * kernel.taps);
+    for (uint32_t x = 0; x < dst_size; ++x)
+    {
+        float center = (x + 0.5f) * scale;
+        int32_t first = (int32_t)std::floor(center - radius);
+        float sum = 0.0f;
+        for (uint32_t t = 0; t < kernel.taps; ++t)
+        {
+            int32_t i = first + (int32_t)t;
+            float weight = kaiser((i + 0.5f - center) / scale);
+            kernel.indices[x * kernel.taps + t] = (uint32_t)std::clamp(i, 0, (int32_t)src_size - 1);
+            kernel.weights[x * kernel.taps + t] = weight;
+            sum += weight;
+        }
+        for (uint32_t t = 0; t < kernel.taps; ++t)
+        {
+            kernel.weights[x * kernel.taps + t] /= sum;
+        }
+    }
+    return kernel;
+}
+
+// Weighted sum of the texels at src + indices[t] * stride, RGBA32F
+static void filter_texel(const float* src, uint32_t stride, const uint32_t* indices, const float* weights,
+                         uint32_t taps, float* out)
+{
+#if defined(TEXTURE_SSE)
+    __m128 sum = _mm_setzero_ps();
+    for (uint32_t t = 0; t < taps; ++t)
+    {
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + indices[t] * stride), _mm_set1_ps(weights[t])));
+    }
+    _mm_storeu_ps(out, sum);
+#else
+    float sum[4] = {};
+    for (uint32_t t = 0; t < taps; ++t)
+    {
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            sum[c] += src[indices[t] * stride + c] * weights[t];
+        }
+    }
+    std::memcpy(out, sum, sizeof(sum));
+#endif
+}
+
+// Separable, rows then columns. Sharper than the box filter, the negative lobes can overshoot and get clamped
+static void downsample_kaiser(const float* src, uint32_t src_width, uint32_t src_height, float* dst,
+                              uint32_t dst_width, uint32_t dst_height)
+{
+    Kernel horizontal = kaiser_kernel(src_width, dst_width);
+    Kernel vertical = kaiser_kernel(src_height, dst_height);
+
+    std::vector<float> rows(dst_width * src_height * 4);
+    for (uint32_t y = 0; y < src_height; ++y)
+    {
+        for (uint32_t x = 0; x < dst_width; ++x)
+        {
+            filter_texel(src + y * src_width * 4, 4, &horizontal.indices[x * horizontal.taps],
+                         &horizontal.weights[x * horizontal.taps], horizontal.taps, &rows[(y * dst_width + x) * 4]);
+        }
+    }
+    for (uint32_t y = 0; y < dst_height; ++y)
+    {
+        for (uint32_t x = 0; x < dst_width; ++x)
+        {
+            filter_texel(rows.data() + x * 4, dst_width * 4, &vertical.indices[y * vertical.taps],
+                         &vertical.weights[y * vertical.taps], vertical.taps, dst + (y * dst_width + x) * 4);
+        }
+    }
+}
+
+/* BC1 */
+
+static uint16_t to_565(const float color[3])
+{
+    uint32_t r = (uint32_t)(std::clamp(color[0], 0.0f, 255.0f) * 31.0f / 255.0f + 0.5f);
+    uint32_t g = (uint32_t)(std::clamp(color[1], 0.0f, 255.0f) * 63.0f / 255.0f + 0.5f);
+    uint32_t b = (uint32_t)(std::clamp(color[2], 0.0f, 255.0f) * 31.0f / 255.0f + 0.5f);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static void from_565(uint16_t value, int32_t color[3])
+{
+    int32_t r = (value >> 11) & 31;
+    int32_t g = (value >> 5) & 63;
+    int32_t b = value & 31;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+static void bc1_palette(uint16_t c_0, uint16_t c_1, bool four_colors, int32_t palette[4][3])
+{
+    from_565(c_0, palette[0]);
+    from_565(c_1, palette[1]);
+    for (uint32_t c = 0; c < 3; ++c)
+    {
+        if (four_colors)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        else
+        {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+}
+
+// Picks the closest palette entry for every pixel, c_0 > c_1 so that the block is always decoded with 4 colors
+static uint32_t bc1_indices(const uint8_t* rgba, uint16_t& c_0, uint16_t& c_1, uint32_t& indices)
+{
+    if (c_0 < c_1)
+    {
+        std::swap(c_0, c_1);
+    }
+
+    int32_t palette[4][3];
+    bc1_palette(c_0, c_1, true, palette);
+    uint32_t palette_size = c_0 == c_1 ? 1 : 4;
+
+    uint32_t error = 0;
+    indices = 0;
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        const uint8_t* pixel = rgba + i * 4;
+        uint32_t best_error = UINT32_MAX;
+        uint32_t best_index = 0;
+        for (uint32_t j = 0; j < palette_size; ++j)
+        {
+            int32_t dr = pixel[0] - palette[j][0];
+            int32_t dg = pixel[1] - palette[j][1];
+            int32_t db = pixel[2] - palette[j][2];
+            uint32_t e = dr * dr + dg * dg + db * db;
+            if (e < best_error)
+            {
+                best_error = e;
+                best_index = j;
+            }
+        }
+        indices |= best_index << (2 * i);
+        error += best_error;
+    }
+    return error;
+}
+
+// Least squares endpoints for a fixed set of indices
+static bool bc1_refit(const uint8_t* rgba, uint32_t indices, float e_0[3], float e_1[3])
+{
+    static constexpr float weights[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+
+    float aa = 0, bb = 0, ab = 0;
+    float ax[3] = {}, bx[3] = {};
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        float a = weights[(indices >> (2 * i)) & 3];
+        float b = 1.0f - a;
+        aa += a * a;
+        bb += b * b;
+        ab += a * b;
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            ax[c] += a * rgba[i * 4 + c];
+            bx[c] += b * rgba[i * 4 + c];
+        }
+    }
+
+    float det = aa * bb - ab * ab;
+    if (std::abs(det) < 1e-6f)
+    {
+        return false;
+    }
+    for (uint32_t c = 0; c < 3; ++c)
+    {
+        e_0[c] = (ax[c] * bb - bx[c] * ab) / det;
+        e_1[c] = (bx[c] * aa - ax[c] * ab) / det;
+    }
+    return true;
+}
+
+/*
+ * Endpoints start from the inset bounding box of the block with its diagonal flipped to follow the
+ * covariance of the channels (J.M.P. van Waveren, Real-Time DXT Compression), then get refined by a
+ * couple of least squares fits on the selected indices.
+ */
+void encode_bc1(const uint8_t* rgba, uint8_t* block)
+{
+    int32_t min[3] = {255, 255, 255};
+    int32_t max[3] = {0, 0, 0};
+    int32_t sum[3] = {0, 0, 0};
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            min[c] = std::min(min[c], (int32_t)rgba[i * 4 + c]);
+            max[c] = std::max(max[c], (int32_t)rgba[i * 4 + c]);
+            sum[c] += rgba[i * 4 + c];
+        }
+    }
+
+    uint32_t axis = 0;
+    for (uint32_t c = 1; c < 3; ++c)
+    {
+        if (max[c] - min[c] > max[axis] - min[axis])
+        {
+            axis = c;
+        }
+    }
+
+    float e_0[3], e_1[3];
+    for (uint32_t c = 0; c < 3; ++c)
+    {
+        int32_t covariance = 0;
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            covariance += (16 * rgba[i * 4 + c] - sum[c]) * (16 * rgba[i * 4 + axis] - sum[axis]);
+        }
+        float inset = (max[c] - min[c]) / 16.0f;
+        e_0[c] = max[c] - inset;
+        e_1[c] = min[c] + inset;
+        if (covariance < 0)
+        {
+            std::swap(e_0[c], e_1[c]);
+        }
+    }
+
+    uint16_t c_0 = to_565(e_0);
+    uint16_t c_1 = to_565(e_1);
+    uint32_t indices = 0;
+    uint32_t error = bc1_indices(rgba, c_0, c_1, indices);
+
+    for (uint32_t iteration = 0; iteration < 2 && error > 0; ++iteration)
+    {
+        if (!bc1_refit(rgba, indices, e_0, e_1))
+        {
+            break;
+        }
+        uint16_t new_c_0 = to_565(e_0);
+        uint16_t new_c_1 = to_565(e_1);
+        uint32_t new_indices = 0;
+        uint32_t new_error = bc1_indices(rgba, new_c_0, new_c_1, new_indices);
+        if (new_error >= error)
+        {
+            break;
+        }
+        c_0 = new_c_0;
+        c_1 = new_c_1;
+        indices = new_indices;
+        error = new_error;
+    }
+
+    std::memcpy(block, &c_0, 2);
+    std::memcpy(block + 2, &c_1, 2);
+    std::memcpy(block + 4, &indices, 4);
+}
+
+/* BC4 */
+
+void encode_bc4(const uint8_t* values, uint32_t stride, uint8_t* block)
+{
+    uint8_t min = 255;
+    uint8_t max = 0;
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        min = std::min(min, values[i * stride]);
+        max = std::max(max, values[i * stride]);
+    }
+
+    // a_0 > a_1 selects the 8 values mode, index 0 is a_0, 1 is a_1 and 2..7 interpolate from a_0 to a_1
+    uint64_t indices = 0;
+    if (max > min)
+    {
+        uint32_t range = max - min;
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            uint32_t position = ((values[i * stride] - min) * 14 + range) / (2 * range);
+            uint64_t index = position == 7 ? 0 : position == 0 ? 1 : 8 - position;
+            indices |= index << (3 * i);
+        }
+    }
+
+    block[0] = max;
+    block[1] = min;
+    std::memcpy(block + 2, &indices, 6);
+}
+
+void encode_bc3(const uint8_t* rgba, uint8_t* block)
+{
+    encode_bc4(rgba + 3, 4, block);
+    encode_bc1(rgba, block + 8);
+}
+
+void encode_bc5(const uint8_t* rgba, uint8_t* block)
+{
+    encode_bc4(rgba, 4, block);
+    encode_bc4(rgba + 1, 4, block + 8);
+}
+
+/* BC7 */
+
+// Blocks are read and written from the least significant bit of the first byte
+struct BitWriter
+{
+    void write(uint32_t value, uint32_t bits)
+    {
+        for (uint32_t i = 0; i < bits; ++i, ++position)
+        {
+            data[position / 8] |= (uint8_t)(((value >> i) & 1) << (position % 8));
+        }
+    }
+
+    uint8_t* data;
+    uint32_t position = 0;
+};
+
+struct BitReader
+{
+    uint32_t read(uint32_t bits)
+    {
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < bits; ++i, ++position)
+        {
+            value |= ((data[position / 8] >> (position % 8)) & 1u) << i;
+        }
+        return value;
+    }
+
+    const uint8_t* data;
+    uint32_t position = 0;
+};
+
+static constexpr int32_t BC7_WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+// Mode 6 endpoint, 7 bits per channel and a p bit shared by the channels as their least significant bit
+struct Bc7Endpoint
+{
+    uint32_t rgba[4];
+    uint32_t p;
+};
+
+static Bc7Endpoint bc7_quantize(const float value[4])
+{
+    Bc7Endpoint best{};
+    float best_error = INFINITY;
+    for (uint32_t p = 0; p < 2; ++p)
+    {
+        Bc7Endpoint endpoint{.rgba = {}, .p = p};
+        float error = 0;
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            float v = std::clamp(value[c], 0.0f, 255.0f);
+            endpoint.rgba[c] = (uint32_t)std::clamp((int32_t)std::lround((v - p) / 2.0f), 0, 127);
+            float d = (float)(endpoint.rgba[c] << 1 | p) - v;
+            error += d * d;
+        }
+        if (error < best_error)
+        {
+            best_error = error;
+            best = endpoint;
+        }
+    }
+    return best;
+}
+
+static void bc7_palette(const Bc7Endpoint& e_0, const Bc7Endpoint& e_1, int32_t palette[16][4])
+{
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        int32_t v_0 = (int32_t)(e_0.rgba[c] << 1 | e_0.p);
+        int32_t v_1 = (int32_t)(e_1.rgba[c] << 1 | e_1.p);
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            palette[i][c] = ((64 - BC7_WEIGHTS[i]) * v_0 + BC7_WEIGHTS[i] * v_1 + 32) >> 6;
+        }
+    }
+}
+
+static uint32_t bc7_indices(const uint8_t* rgba, const Bc7Endpoint& e_0, const Bc7Endpoint& e_1, uint8_t indices[16])
+{
+    int32_t palette[16][4];
+    bc7_palette(e_0, e_1, palette);
+
+    uint32_t error = 0;
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        const uint8_t* pixel = rgba + i * 4;
+        uint32_t best_error = UINT32_MAX;
+        for (uint8_t j = 0; j < 16; ++j)
+        {
+            uint32_t e = 0;
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                int32_t d = pixel[c] - palette[j][c];
+                e += d * d;
+            }
+            if (e < best_error)
+            {
+                best_error = e;
+                indices[i] = j;
+            }
+        }
+        error += best_error;
+    }
+    return error;
+}
+
+// Least squares endpoints for a fixed set of indices
+static bool bc7_refit(const uint8_t* rgba, const uint8_t indices[16], float e_0[4], float e_1[4])
+{
+    float aa = 0, bb = 0, ab = 0;
+    float ax[4] = {}, bx[4] = {};
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        float b = BC7_WEIGHTS[indices[i]] / 64.0f;
+        float a = 1.0f - b;
+        aa += a * a;
+        bb += b * b;
+        ab += a * b;
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            ax[c] += a * rgba[i * 4 + c];
+            bx[c] += b * rgba[i * 4 + c];
+        }
+    }
+
+    float det = aa * bb - ab * ab;
+    if (std::abs(det) < 1e-6f)
+    {
+        return false;
+    }
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        e_0[c] = (ax[c] * bb - bx[c] * ab) / det;
+        e_1[c] = (bx[c] * aa - ax[c] * ab) / det;
+    }
+    return true;
+}
+
+/*
+ * Mode 6 only: one subset with 16 interpolated RGBA colors. Endpoints are the extents of the block along its
+ * principal axis, then refined by a couple of least squares fits on the selected indices like BC1.
+ */
+void encode_bc7(const uint8_t* rgba, uint8_t* block)
+{
+    float mean[4] = {};
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            mean[c] += rgba[i * 4 + c] / 16.0f;
+        }
+    }
+
+    float covariance[4][4] = {};
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            for (uint32_t d = 0; d < 4; ++d)
+            {
+                covariance[c][d] += (rgba[i * 4 + c] - mean[c]) * (rgba[i * 4 + d] - mean[d]);
+            }
+        }
+    }
+
+    // Power iteration, from the diagonal which is never orthogonal to the principal axis of real content
+    float axis[4] = {covariance[0][0], covariance[1][1], covariance[2][2], covariance[3][3]};
+    for (uint32_t iteration = 0; iteration < 8; ++iteration)
+    {
+        float next[4] = {};
+        float length = 0;
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            for (uint32_t d = 0; d < 4; ++d)
+            {
+                next[c] += covariance[c][d] * axis[d];
+            }
+            length = std::max(length, std::abs(next[c]));
+        }
+        if (length == 0)
+        {
+            break;
+        }
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            axis[c] = next[c] / length;
+        }
+    }
+
+    float length_squared = 0;
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        length_squared += axis[c] * axis[c];
+    }
+    float min_t = 0, max_t = 0;
+    if (length_squared > 0)
+    {
+        min_t = INFINITY;
+        max_t = -INFINITY;
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            float t = 0;
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                t += (rgba[i * 4 + c] - mean[c]) * axis[c];
+            }
+            min_t = std::min(min_t, t / length_squared);
+            max_t = std::max(max_t, t / length_squared);
+        }
+    }
+
+    float e_0[4], e_1[4];
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        e_0[c] = mean[c] + axis[c] * min_t;
+        e_1[c] = mean[c] + axis[c] * max_t;
+    }
+
+    Bc7Endpoint q_0 = bc7_quantize(e_0);
+    Bc7Endpoint q_1 = bc7_quantize(e_1);
+    uint8_t indices[16];
+    uint32_t error = bc7_indices(rgba, q_0, q_1, indices);
+
+    for (uint32_t iteration = 0; iteration < 2 && error > 0; ++iteration)
+    {
+        if (!bc7_refit(rgba, indices, e_0, e_1))
+        {
+            break;
+        }
+        Bc7Endpoint new_q_0 = bc7_quantize(e_0);
+        Bc7Endpoint new_q_1 = bc7_quantize(e_1);
+        uint8_t new_indices[16];
+        uint32_t new_error = bc7_indices(rgba, new_q_0, new_q_1, new_indices);
+        if (new_error >= error)
+        {
+            break;
+        }
+        q_0 = new_q_0;
+        q_1 = new_q_1;
+        std::memcpy(indices, new_indices, sizeof(indices));
+        error = new_error;
+    }
+
+    // The most significant bit of the first index is implicitly 0
+    if (indices[0] & 8)
+    {
+        std::swap(q_0, q_1);
+        for (uint8_t& index : indices)
+        {
+            index = 15 - index;
+        }
+    }
+
+    std::memset(block, 0, 16);
+    BitWriter writer{block};
+    writer.write(1 << 6, 7);
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        writer.write(q_0.rgba[c], 7);
+        writer.write(q_1.rgba[c], 7);
+    }
+    writer.write(q_0.p, 1);
+    writer.write(q_1.p, 1);
+    writer.write(indices[0], 3);
+    for (uint32_t i = 1; i < 16; ++i)
+    {
+        writer.write(indices[i], 4);
+    }
+}
+
+/* Decoding */
+
+static void decode_bc1(const uint8_t* block, bool four_colors, uint8_t* rgba)
+{
+    uint16_t c_0, c_1;
+    uint32_t indices;
+    std::memcpy(&c_0, block, 2);
+    std::memcpy(&c_1, block + 2, 2);
+    std::memcpy(&indices, block + 4, 4);
+
+    four_colors = four_colors || c_0 > c_1;
+    int32_t palette[4][3];
+    bc1_palette(c_0, c_1, four_colors, palette);
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        uint32_t index = (indices >> (2 * i)) & 3;
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            rgba[i * 4 + c] = (uint8_t)palette[index][c];
+        }
+        rgba[i * 4 + 3] = !four_colors && index == 3 ? 0 : 255;
+    }
+}
+
+static void decode_bc4(const uint8_t* block, uint8_t* values, uint32_t stride)
+{
+    int32_t palette[8];
+    palette[0] = block[0];
+    palette[1] = block[1];
+    if (palette[0] > palette[1])
+    {
+        for (int32_t i = 2; i < 8; ++i)
+        {
+            palette[i] = ((8 - i) * palette[0] + (i - 1) * palette[1]) / 7;
+        }
+    }
+    else
+    {
+        for (int32_t i = 2; i < 6; ++i)
+        {
+            palette[i] = ((6 - i) * palette[0] + (i - 1) * palette[1]) / 5;
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    uint64_t indices = 0;
+    std::memcpy(&indices, block + 2, 6);
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        values[i * stride] = (uint8_t)palette[(indices >> (3 * i)) & 7];
+    }
+}
+
+// Only mode 6, the one encode_bc7 writes
+static void decode_bc7(const uint8_t* block, uint8_t* rgba)
+{
+    BitReader reader{block};
+    if (reader.read(7) != 1 << 6)
+    {
+        ASSERT(!"Unsupported BC7 mode");
+        std::memset(rgba, 0, 64);
+        return;
+    }
+
+    Bc7Endpoint e_0{}, e_1{};
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        e_0.rgba[c] = reader.read(7);
+        e_1.rgba[c] = reader.read(7);
+    }
+    e_0.p = reader.read(1);
+    e_1.p = reader.read(1);
+
+    int32_t palette[16][4];
+    bc7_palette(e_0, e_1, palette);
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        uint32_t index = reader.read(i == 0 ? 3 : 4);
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            rgba[i * 4 + c] = (uint8_t)palette[index][c];
+        }
+    }
+}
+
+static void decode_block(Format format, const uint8_t* block, uint8_t* rgba)
+{
+    switch (format)
+    {
+    case Format::BC1:
+        decode_bc1(block, false, rgba);
+        break;
+    case Format::BC3:
+        decode_bc1(block + 8, true, rgba);
+        decode_bc4(block, rgba + 3, 4);
+        break;
+    case Format::BC4:
+        std::memset(rgba, 0, 64);
+        decode_bc4(block, rgba, 4);
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            rgba[i * 4 + 3] = 255;
+        }
+        break;
+    case Format::BC5:
+        std::memset(rgba, 0, 64);
+        decode_bc4(block, rgba, 4);
+        decode_bc4(block + 8, rgba + 1, 4);
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            rgba[i * 4 + 3] = 255;
+        }
+        break;
+    case Format::BC7:
+        decode_bc7(block, rgba);
+        break;
+    default:
+        ASSERT(false);
+    }
+}
+
+std::vector<uint8_t> decode(const Texture& texture, uint32_t level)
+{
+    const Level& l = texture.levels[level];
+    const uint8_t* src = texture.data.data() + l.offset;
+    std::vector<uint8_t> rgba(l.width * l.height * 4);
+    if (texture.format == Format::RGBA8)
+    {
+        std::memcpy(rgba.data(), src, rgba.size());
+        return rgba;
+    }
+
+    uint8_t pixels[64];
+    for (uint32_t by = 0; by < l.height; by += 4)
+    {
+        for (uint32_t bx = 0; bx < l.width; bx += 4)
+        {
+            decode_block(texture.format, src, pixels);
+            src += block_size(texture.format);
+            for (uint32_t y = 0; y < 4 && by + y < l.height; ++y)
+            {
+                for (uint32_t x = 0; x < 4 && bx + x < l.width; ++x)
+                {
+                    std::memcpy(&rgba[((by + y) * l.width + bx + x) * 4], &pixels[(y * 4 + x) * 4], 4);
+                }
+            }
+        }
+    }
+    return rgba;
+}
+
+double psnr(const uint8_t* a, const uint8_t* b, size_t size)
+{
+    double error = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        double d = (double)a[i] - (double)b[i];
+        error += d * d;
+    }
+    if (error == 0)
+    {
+        return INFINITY;
+    }
+    double mse = error / size;
+    return 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+
+/* Import */
+
+std::string cache_dir(std::string_view asset_path)
+{
+    return (std::filesystem::path(asset_path).parent_path() / "texture_cache").string();
+}
+
+static void compress_level(const uint8_t* rgba, uint32_t width, uint32_t height, Format format, uint8_t* dst)
+{
+    uint8_t pixels[64];
+    for (uint32_t by = 0; by < height; by += 4)
+    {
+        for (uint32_t bx = 0; bx < width; bx += 4)
+        {
+            for (uint32_t y = 0; y < 4; ++y)
+            {
+                uint32_t sy = std::min(by + y, height - 1);
+                for (uint32_t x = 0; x < 4; ++x)
+                {
+                    uint32_t sx = std::min(bx + x, width - 1);
+                    std::memcpy(&pixels[(y * 4 + x) * 4], &rgba[(sy * width + sx) * 4], 4);
+                }
+            }
+
+            switch (format)
+            {
+            case Format::BC1:
+                encode_bc1(pixels, dst);
+                break;
+            case Format::BC3:
+                encode_bc3(pixels, dst);
+                break;
+            case Format::BC4:
+                encode_bc4(pixels, 4, dst);
+                break;
+            case Format::BC5:
+                encode_bc5(pixels, dst);
+                break;
+            case Format::BC7:
+                encode_bc7(pixels, dst);
+                break;
+            default:
+                ASSERT(false);
+            }
+            dst += block_size(format);
+        }
+    }
+}
+
+static bool has_alpha(const uint8_t* rgba, uint32_t pixel_count)
+{
+    for (uint32_t i = 0; i < pixel_count; ++i)
+    {
+        if (rgba[i * 4 + 3] != 255)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+Texture import(const uint8_t* rgba, uint32_t width, uint32_t height, const ImportOptions& options)
+{
+    Texture texture;
+    texture.width = width;
+    texture.height = height;
+    texture.srgb = options.srgb && !options.normal_map;
+    if (options.compress)
+    {
+        if (options.normal_map)
+        {
+            texture.format = Format::BC5;
+        }
+        else if (options.bc7)
+        {
+            texture.format = Format::BC7;
+        }
+        else
+        {
+            texture.format = has_alpha(rgba, width * height) ? Format::BC3 : Format::BC1;
+        }
+    }
+
+    uint32_t level_count = options.generate_mips ? mip_count(width, height) : 1;
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < level_count; ++i)
+    {
+        uint32_t w = std::max(width >> i, 1u);
+        uint32_t h = std::max(height >> i, 1u);
+        uint32_t size = level_size(texture.format, w, h);
+        texture.levels.push_back(Level{.width = w, .height = h, .offset = offset, .size = size});
+        offset += size;
+    }
+    texture.data.resize(offset);
+
+    std::vector<uint8_t> level_rgba(rgba, rgba + width * height * 4);
+    std::vector<float> linear;
+    std::vector<float> next_linear;
+    if (level_count > 1)
+    {
+        linear.resize(width * height * 4);
+        to_float(rgba, width * height, texture.srgb, linear.data());
+    }
+
+    for (uint32_t i = 0; i < level_count; ++i)
+    {
+        const Level& level = texture.levels[i];
+        if (i > 0)
+        {
+            const Level& prev = texture.levels[i - 1];
+            next_linear.resize(level.width * level.height * 4);
+            if (options.mip_filter == MipFilter::Kaiser)
+            {
+                downsample_kaiser(linear.data(), prev.width, prev.height, next_linear.data(), level.width,
+                                  level.height);
+            }
+            else
+            {
+                downsample_box(linear.data(), prev.width, prev.height, next_linear.data(), level.width, level.height);
+            }
+            std::swap(linear, next_linear);
+            level_rgba.resize(level.width * level.height * 4);
+            to_rgba8(linear.data(), level.width * level.height, texture.srgb, level_rgba.data());
+        }
+
+        if (texture.format == Format::RGBA8)
+        {
+            std::memcpy(texture.data.data() + level.offset, level_rgba.data(), level.size);
+        }
+        else
+        {
+            compress_level(level_rgba.data(), level.width, level.height, texture.format,
+                           texture.data.data() + level.offset);
+        }
+    }
+
+    return texture;
+}
+
+static bool read_cache(const std::string& path, Texture& texture)
+{
+    std::vector<uint8_t> file;
+    if (!bul::read_file(path.c_str(), file) || file.size() < sizeof(CacheHeader))
+    {
+        return false;
+    }
+
+    CacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    size_t levels_size = header.level_count * sizeof(Level);
+    if (header.magic != CACHE_MAGIC || header.version != CACHE_VERSION
+        || file.size() != sizeof(header) + levels_size + header.data_size)
+    {
+        return false;
+    }
+
+    texture.format = header.format;
+    texture.srgb = header.srgb;
+    texture.width = header.width;
+    texture.height = header.height;
+    texture.levels.resize(header.level_count);
+    std::memcpy(texture.levels.data(), file.data() + sizeof(header), levels_size);
+    texture.data.assign(file.begin() + sizeof(header) + levels_size, file.end());
+    return true;
+}
+
+static void write_cache(const std::string& path, const Texture& texture)
+{
+    CacheHeader header{.magic = CACHE_MAGIC,
+                       .version = CACHE_VERSION,
+                       .format = texture.format,
+                       .srgb = texture.srgb,
+                       .width = texture.width,
+                       .height = texture.height,
+                       .level_count = (uint32_t)texture.levels.size(),
+                       .data_size = (uint32_t)texture.data.size()};
+
+    size_t levels_size = texture.levels.size() * sizeof(Level);
+    std::vector<uint8_t> file(sizeof(header) + levels_size + texture.data.size());
+    std::memcpy(file.data(), &header, sizeof(header));
+    std::memcpy(file.data() + sizeof(header), texture.levels.data(), levels_size);
+    std::memcpy(file.data() + sizeof(header) + levels_size, texture.data.data(), texture.data.size());
+    bul::write_file(path.c_str(), file.data(), file.size());
+}
+
+static std::string cache_path(const std::string& cache_dir, std::span<const uint8_t> file_data,
+                              const ImportOptions& options)
+{
+    struct
+    {
+        uint64_t data_hash;
+        uint32_t flags;
+        uint32_t version;
+    } key{.data_hash = bul::hash(file_data.data(), file_data.size()),
+          .flags = (uint32_t)options.srgb | (uint32_t)options.normal_map << 1 | (uint32_t)options.generate_mips << 2
+                 | (uint32_t)options.compress << 3 | (uint32_t)options.bc7 << 4
+                 | (uint32_t)options.mip_filter << 5,
+          .version = CACHE_VERSION};
+
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.tex", (unsigned long long)bul::hash(key));
+    return cache_dir + "/" + name;
+}
+
+// Returns true if the texture was found in the cache
+static bool import_image(const gltf::Image& image, std::span<const uint8_t> encoded, const ImportOptions& options,
+                         const std::string& cache_dir, Texture& texture)
+{
+    std::string path = cache_path(cache_dir, encoded, options);
+    if (read_cache(path, texture))
+    {
+        return true;
+    }
+
+    int width, height, channels;
+    uint8_t* rgba = stbi_load_from_memory(encoded.data(), (int)encoded.size(), &width, &height, &channels,
+                                          STBI_rgb_alpha);
+    if (rgba == nullptr)
+    {
+        throw std::runtime_error("Could not decode image " + image.uri);
+    }
+
+    texture = import(rgba, width, height, options);
+    stbi_image_free(rgba);
+    write_cache(path, texture);
+    return false;
+}
+
+std::vector<std::optional<ImportOptions>> material_import_options(const gltf::Model& model)
+{
+    std::vector<std::optional<ImportOptions>> options(model.images.size());
+    auto use = [&](uint32_t texture, const ImportOptions& usage) {
+        if (texture == (uint32_t)-1)
+        {
+            return;
+        }
+        std::optional<ImportOptions>& image_options = options[model.textures[texture].source_image];
+        // A normal map shared with another usage stays one, a color texture stays sRGB
+        if (!image_options || usage.normal_map || (usage.srgb && !image_options->normal_map))
+        {
+            image_options = usage;
+        }
+    };
+    for (const gltf::Material& material : model.materials)
+    {
+        use(material.metallic_roughness_tex, {.srgb = false});
+        use(material.occlusion_tex, {.srgb = false});
+        use(material.base_color_tex, {.srgb = true});
+        use(material.normal_tex, {.srgb = false, .normal_map = true});
+    }
+    return options;
+}
+
+std::vector<Texture> import_images(const std::vector<gltf::Image>& images,
+                                   const std::vector<std::optional<ImportOptions>>& options,
+                                   const std::string& cache_dir)
+{
+    ASSERT(options.size() == images.size());
+    // The decoding jobs and reads inherit the tag
+    bul::memory::Scope memory_scope{bul::memory::Tag::Loaders};
+    std::filesystem::create_directories(cache_dir);
+
+    bul::Timer timer;
+    std::vector<Texture> textures(images.size());
+    std::atomic<uint32_t> cache_hits = 0;
+    std::exception_ptr exception;
+    std::atomic_flag has_exception;
+
+    auto import_encoded = [&](uint32_t i, std::span<const uint8_t> encoded, bool ok) {
+        try
+        {
+            if (!ok)
+            {
+                throw std::runtime_error("Could not load image from file " + images[i].uri);
+            }
+            cache_hits += import_image(images[i], encoded, *options[i], cache_dir, textures[i]);
+        }
+        catch (...)
+        {
+            if (!has_exception.test_and_set())
+            {
+                exception = std::current_exception();
+            }
+        }
+    };
+
+    // Files are read in batches by bul::io, each one is decoded on a worker as soon as it is read while the next ones
+    // are still loading
+    bul::jobs::Counter counter;
+    uint32_t imported = 0;
+    for (uint32_t i = 0; i < images.size(); ++i)
+    {
+        if (images[i].ktx2 || !options[i])
+        {
+            continue;
+        }
+        ++imported;
+        if (!images[i].data.empty())
+        {
+            bul::jobs::run([&import_encoded, &images, i]() { import_encoded(i, images[i].data, true); }, &counter);
+            continue;
+        }
+        bul::io::read(
+            images[i].uri,
+            [&import_encoded, i](std::span<const uint8_t> data, bool ok) { import_encoded(i, data, ok); },
+            &counter);
+    }
+    bul::jobs::wait(counter);
+
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+
+    std::cout << "Imported " << imported << " textures in " << timer.total_ms() << "ms (" << cache_hits
+              << " from cache)\n";
+    return textures;
+}
+} // namespace texture
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gltf.h"
+
+namespace texture
+{
+enum class Format : uint32_t
+{
+    RGBA8,
+    BC1,
+    BC3,
+    BC4,
+    BC5,
+    BC7,
+};
+
+struct Level
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t offset;
+    uint32_t size;
+};
+
+struct Texture
+{
+    Format format = Format::RGBA8;
+    bool srgb = true;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<Level> levels;
+    std::vector<uint8_t> data;
+};
+
+enum class MipFilter : uint32_t
+{
+    Box,
+    Kaiser,
+};
+
+struct ImportOptions
+{
+    // sRGB textures are filtered in linear space
+    bool srgb = true;
+    // Encoded to BC5 from the red and green channels, otherwise BC1 or BC3 when the image has alpha
+    bool normal_map = false;
+    // Color textures are encoded to BC7 rather than BC1 or BC3, slower to encode but higher quality
+    bool bc7 = false;
+    bool generate_mips = true;
+    MipFilter mip_filter = MipFilter::Box;
+    bool compress = true;
+};
+
+uint32_t mip_count(uint32_t width, uint32_t height);
+
+// rgba is width * height RGBA8 pixels
+Texture import(const uint8_t* rgba, uint32_t width, uint32_t height, const ImportOptions& options);
+
+// Where the textures imported from the asset at asset_path are cached, next to it
+std::string cache_dir(std::string_view asset_path);
+
+// Options for each image of the model from how its materials use it: sRGB for base colors, BC5 for normal maps and
+// linear for the other maps. Images no material uses have none.
+std::vector<std::optional<ImportOptions>> material_import_options(const gltf::Model& model);
+
+// Decodes the images and imports them on the job system with the options at the same index, results are cached in
+// cache_dir keyed on the file contents. KTX2 images and images without options are skipped and left empty.
+std::vector<Texture> import_images(const std::vector<gltf::Image>& images,
+                                   const std::vector<std::optional<ImportOptions>>& options,
+                                   const std::string& cache_dir);
+
+void encode_bc1(const uint8_t* rgba, uint8_t* block);
+void encode_bc3(const uint8_t* rgba, uint8_t* block);
+void encode_bc4(const uint8_t* values, uint32_t stride, uint8_t* block);
+void encode_bc5(const uint8_t* rgba, uint8_t* block);
+void encode_bc7(const uint8_t* rgba, uint8_t* block);
+
+// Returns the RGBA8 pixels of a level
+std::vector<uint8_t> decode(const Texture& texture, uint32_t level);
+
+double psnr(const uint8_t* a, const uint8_t* b, size_t size);
+} // namespace texture
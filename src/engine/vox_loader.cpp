@@ -1,12 +1,16 @@
 #include "vox_loader.h"
 
+#include <charconv>
 #include <cstring>
 #include <iostream>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 
 #include "bul/bul.h"
+#include "bul/arena.h"
 #include "bul/file.h"
+#include "bul/memory.h"
+#include "bul/profiler.h"
 
 namespace Vox
 {
@@ -51,29 +55,65 @@ static const void* chunk_data(const ChunkId* chunk)
     return bul::offset_ptr(chunk, sizeof(ChunkId));
 }
 
-static bool end_of_data(const ChunkId* chunk, const std::vector<uint8_t>& bytes)
+static bool end_of_data(const ChunkId* chunk, std::span<const uint8_t> bytes)
 {
     return chunk == (void*)(bytes.data() + bytes.size());
 }
 
-static std::string parse_string(const void* data)
+static std::string_view parse_string(const void* data)
 {
     uint32_t size = *(uint32_t*)data;
-    return std::string(bul::offset_ptr<char*>(data, sizeof(uint32_t)), size);
+    return std::string_view(bul::offset_ptr<const char*>(data, sizeof(uint32_t)), size);
 }
 
-static std::unordered_map<std::string, std::string> parse_dict(const void* data)
+static float parse_float(std::string_view str)
+{
+    float value = 0.0f;
+    std::from_chars(str.data(), str.data() + str.size(), value);
+    return value;
+}
+
+// Keys and values point into the file bytes, only the pair list is allocated
+struct Dict
+{
+    bul::ArenaVector<std::pair<std::string_view, std::string_view>> pairs;
+
+    const std::string_view* find(std::string_view key) const
+    {
+        for (const auto& [k, v] : pairs)
+        {
+            if (k == key)
+            {
+                return &v;
+            }
+        }
+        return nullptr;
+    }
+
+    bool contains(std::string_view key) const
+    {
+        return find(key) != nullptr;
+    }
+
+    std::string_view at(std::string_view key) const
+    {
+        return *find(key);
+    }
+};
+
+static Dict parse_dict(const void* data, bul::Arena& arena)
 {
     uint32_t n_pairs = *(uint32_t*)data;
-    std::unordered_map<std::string, std::string> dict(n_pairs);
+    Dict dict{bul::ArenaVector<std::pair<std::string_view, std::string_view>>{arena}};
+    dict.pairs.reserve(n_pairs);
     data = bul::offset_ptr(data, sizeof(uint32_t));
     for (size_t i = 0; i < n_pairs; ++i)
     {
-        std::string key = parse_string(data);
+        std::string_view key = parse_string(data);
         data = bul::offset_ptr(data, sizeof(uint32_t) + key.size());
-        std::string val = parse_string(data);
+        std::string_view val = parse_string(data);
         data = bul::offset_ptr(data, sizeof(uint32_t) + val.size());
-        dict.emplace(key, val);
+        dict.pairs.emplace_back(key, val);
     }
     return dict;
 }
@@ -85,14 +125,27 @@ Model::Model(const std::string_view path)
 
 void Model::load(const std::string_view path)
 {
+    PROFILE_SCOPE("Vox::Model::load");
+    bul::memory::Scope memory_scope{bul::memory::Tag::Loaders};
+    ENSURE(file_.open(path.data(), bul::MappedFile::Access::Sequential));
+    load(file_.span());
+    if (bytes_.empty())
+    {
+        std::cerr << "Invalid vox model " << path << "\n";
+        file_.close();
+    }
+}
+
+void Model::load(std::span<const uint8_t> bytes)
+{
+    PROFILE_SCOPE("Vox::Model::load chunks");
     chunks.clear();
-    ENSURE(bul::read_file(path.data(), bytes_));
+    bytes_ = bytes;
 
-    auto vox_header = (Header*)(bytes_.data());
-    if (strncmp(vox_header->magic, "VOX ", 4) != 0)
+    auto vox_header = (const Header*)(bytes_.data());
+    if (bytes_.size() < sizeof(Header) + sizeof(ChunkId) || strncmp(vox_header->magic, "VOX ", 4) != 0)
     {
-        std::cerr << "Invalid vox model " << path << "\n";
-        bytes_.resize(0);
+        bytes_ = {};
         return;
     }
 
@@ -124,6 +177,7 @@ void Model::load(const std::string_view path)
             parse_matl(chunk);
         }
     }
+    PROFILE_COUNTER("vox chunks", chunks.size());
 }
 
 void Model::parse_pack(const ChunkId* chunk)
@@ -134,13 +188,13 @@ void Model::parse_pack(const ChunkId* chunk)
 void Model::parse_size(const ChunkId* chunk)
 {
     auto& c = chunks.emplace_back();
-    c.size = (SIZE*)chunk_data(chunk);
+    c.size = (const SIZE*)chunk_data(chunk);
 }
 
 void Model::parse_xyzi(const ChunkId* chunk)
 {
     uint32_t n_voxels = *(uint32_t*)chunk_data(chunk);
-    XYZI* xyzi = bul::offset_ptr<XYZI*>(chunk_data(chunk), sizeof(uint32_t));
+    const XYZI* xyzi = bul::offset_ptr<const XYZI*>(chunk_data(chunk), sizeof(uint32_t));
     auto& c = chunks.back();
     c.n_voxels = n_voxels;
     c.xyzi = xyzi;
@@ -171,10 +225,12 @@ void Model::parse_matl(const ChunkId* chunk)
     {
         return;
     }
-    const auto& dict = parse_dict(bul::offset_ptr(chunk_data(chunk), sizeof(uint32_t)));
+    alignas(16) uint8_t scratch_buffer[1_KB];
+    bul::Arena scratch(scratch_buffer, sizeof(scratch_buffer));
+    const Dict dict = parse_dict(bul::offset_ptr(chunk_data(chunk), sizeof(uint32_t)), scratch);
 
     /* std::cout << "MATL: " << id << "\n";
-    for (const auto& [key, val] : dict)
+    for (const auto& [key, val] : dict.pairs)
     {
         std::cout << key << ": " << val << "\n";
     }
@@ -189,11 +245,11 @@ void Model::parse_matl(const ChunkId* chunk)
             matl.type = EMISSIVE;
             if (dict.contains("_emit"))
             {
-                matl.emit = std::stof(dict.at("_emit"));
+                matl.emit = parse_float(dict.at("_emit"));
             }
             if (dict.contains("_flux"))
             {
-                matl.flux = std::stof(dict.at("_flux"));
+                matl.flux = parse_float(dict.at("_flux"));
             }
         }
         else if (type == "_metal")
@@ -201,15 +257,15 @@ void Model::parse_matl(const ChunkId* chunk)
             matl.type = METAL;
             if (dict.contains("_metal"))
             {
-                matl.metal = std::stof(dict.at("_metal"));
+                matl.metal = parse_float(dict.at("_metal"));
             }
             if (dict.contains("_rough"))
             {
-                matl.rough = std::stof(dict.at("_rough"));
+                matl.rough = parse_float(dict.at("_rough"));
             }
             /* if (dict.contains("_ior"))
             {
-                matl.ior = std::stof(dict.at("_ior"));
+                matl.ior = parse_float(dict.at("_ior"));
             } */
         }
         else if (type == "_glass")
@@ -217,11 +273,11 @@ void Model::parse_matl(const ChunkId* chunk)
             matl.type = GLASS;
             if (dict.contains("_trans"))
             {
-                matl.trans = std::stof(dict.at("_trans"));
+                matl.trans = parse_float(dict.at("_trans"));
             }
             if (dict.contains("_ior"))
             {
-                matl.ior = std::stof(dict.at("_ior"));
+                matl.ior = parse_float(dict.at("_ior"));
             }
         }
     }
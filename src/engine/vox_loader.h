@@ -2,8 +2,11 @@
 
 #include <vector>
 #include <array>
+#include <span>
 #include <string_view>
 
+#include "bul/file.h"
+
 namespace Vox
 {
 struct Header
@@ -63,9 +66,9 @@ struct MATL
 
 struct Chunk
 {
-    SIZE* size = nullptr;
+    const SIZE* size = nullptr;
     uint32_t n_voxels = 0;
-    XYZI* xyzi = nullptr;
+    const XYZI* xyzi = nullptr;
 };
 
 class Model
@@ -74,14 +77,18 @@ public:
     Model(const std::string_view path);
     Model() = default;
 
+    // Maps the file, the chunks point into the mapping
     void load(const std::string_view path);
+    // The chunks point into bytes, which has to outlive the model
+    void load(std::span<const uint8_t> bytes);
 
     std::vector<Chunk> chunks;
     std::array<RGBA, 256> palette;
     std::array<MATL, 256> materials;
 
 private:
-    std::vector<uint8_t> bytes_;
+    bul::MappedFile file_;
+    std::span<const uint8_t> bytes_;
 
     void parse_pack(const ChunkId* chunk);
     void parse_size(const ChunkId* chunk);
@@ -1,10 +1,20 @@
 #include "buffer.h"
 
+#include "bul/memory.h"
+
 #include "vk_tools.h"
 #include "device.h"
 
 namespace vk
 {
+// Host buffers only used as a copy source are the staging buffers of the uploads
+static bul::memory::Tag memory_tag(const BufferDescription& description)
+{
+    bool staging = description.memory_usage == VMA_MEMORY_USAGE_CPU_ONLY
+                   && description.usage == VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    return staging ? bul::memory::Tag::VulkanStaging : bul::memory::Tag::VulkanBuffers;
+}
+
 bul::Handle<Buffer> Device::create_buffer(const BufferDescription& description)
 {
     VkBufferCreateInfo buffer_info{};
@@ -18,9 +28,13 @@ bul::Handle<Buffer> Device::create_buffer(const BufferDescription& description)
 
     VkBuffer vk_buffer = VK_NULL_HANDLE;
     VmaAllocation allocation = VK_NULL_HANDLE;
-    VK_CHECK(vmaCreateBuffer(allocator, &buffer_info, &alloc_info, &vk_buffer, &allocation, nullptr));
+    VmaAllocationInfo allocation_info{};
+    VK_CHECK(vmaCreateBuffer(allocator, &buffer_info, &alloc_info, &vk_buffer, &allocation, &allocation_info));
+    bul::memory::track(memory_tag(description), allocation_info.size);
 
-    return buffers.insert({.description = description, .vk_handle = vk_buffer, .allocation = allocation});
+    auto handle = buffers.insert({.description = description, .vk_handle = vk_buffer, .allocation = allocation});
+    write_bindless(handle);
+    return handle;
 }
 
 void Device::destroy_buffer(Buffer& buffer)
@@ -31,6 +45,9 @@ void Device::destroy_buffer(Buffer& buffer)
     }
     if (buffer.allocation != VK_NULL_HANDLE)
     {
+        VmaAllocationInfo allocation_info{};
+        vmaGetAllocationInfo(allocator, buffer.allocation, &allocation_info);
+        bul::memory::untrack(memory_tag(buffer.description), allocation_info.size);
         vmaDestroyBuffer(allocator, buffer.vk_handle, buffer.allocation);
         buffer.allocation = VK_NULL_HANDLE;
         buffer.vk_handle = VK_NULL_HANDLE;
@@ -1,5 +1,7 @@
 #include "command.h"
 
+#include <algorithm>
+
 #include <stb/stb_image.h>
 
 #include "bul/bul.h"
@@ -64,6 +66,7 @@ void Device::submit_blocking(Command& command)
 {
     submit(command, VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE);
     wait_idle();
+    command.release_staging_buffers();
 }
 
 /* CommandContext */
@@ -108,6 +111,16 @@ void Command::end()
     vkEndCommandBuffer(vk_handle);
 }
 
+void Command::release_staging_buffers()
+{
+    for (const auto& staging_handle : staging_buffers)
+    {
+        p_device->destroy_buffer(p_device->buffers.get(staging_handle));
+        p_device->buffers.erase(staging_handle);
+    }
+    staging_buffers.clear();
+}
+
 void Command::barrier(const bul::Handle<Image>& image_handle, ImageUsage dst_usage)
 {
     auto& image = p_device->images.get(image_handle);
@@ -187,6 +200,21 @@ void GraphicsCommand::bind_descriptor_set(const bul::Handle<GraphicsProgram>& pr
                             set.dynamic_offsets.size(), set.dynamic_offsets.data());
 }
 
+void GraphicsCommand::bind_bindless_set(const bul::Handle<GraphicsProgram>& program_handle)
+{
+    auto& program = p_device->graphics_programs.get(program_handle);
+    vkCmdBindDescriptorSets(vk_handle, VK_PIPELINE_BIND_POINT_GRAPHICS, program.layout, 2, 1,
+                            &p_device->bindless_set.vk_set, 0, nullptr);
+}
+
+void GraphicsCommand::push_constants(const bul::Handle<GraphicsProgram>& program_handle, const void* data,
+                                     uint32_t size)
+{
+    ASSERT(size <= Device::PUSH_CONSTANTS_SIZE);
+    auto& program = p_device->graphics_programs.get(program_handle);
+    vkCmdPushConstants(vk_handle, program.layout, VK_SHADER_STAGE_ALL, 0, size, data);
+}
+
 void GraphicsCommand::bind_pipeline(const bul::Handle<GraphicsProgram>& program_handle, uint32_t pipeline_index)
 {
     auto& program = p_device->graphics_programs.get(program_handle);
@@ -198,13 +226,13 @@ void GraphicsCommand::bind_pipeline(const bul::Handle<GraphicsProgram>& program_
 }
 
 void GraphicsCommand::begin_renderpass(const bul::Handle<FrameBuffer>& framebuffer_handle,
-                                       const std::vector<LoadOp>& load_ops)
+                                       const LoadOps& load_ops)
 {
     auto& framebuffer = p_device->framebuffers.get(framebuffer_handle);
     const auto& renderpass = p_device->get_or_create_renderpass(framebuffer_handle, load_ops);
 
-    static std::vector<VkClearValue> clear_values;
-    clear_values.clear();
+    auto clear_values = p_device->scratch.vector<VkClearValue>();
+    clear_values.reserve(renderpass.load_ops.size());
     for (const auto& load_op : renderpass.load_ops)
     {
         clear_values.push_back(load_op.clear_value);
@@ -249,6 +277,20 @@ void ComputeCommand::bind_descriptor_set(const bul::Handle<ComputeProgram>& prog
                             set.dynamic_offsets.size(), set.dynamic_offsets.data());
 }
 
+void ComputeCommand::bind_bindless_set(const bul::Handle<ComputeProgram>& program_handle)
+{
+    auto& program = p_device->compute_programs.get(program_handle);
+    vkCmdBindDescriptorSets(vk_handle, VK_PIPELINE_BIND_POINT_COMPUTE, program.layout, 2, 1,
+                            &p_device->bindless_set.vk_set, 0, nullptr);
+}
+
+void ComputeCommand::push_constants(const bul::Handle<ComputeProgram>& program_handle, const void* data, uint32_t size)
+{
+    ASSERT(size <= Device::PUSH_CONSTANTS_SIZE);
+    auto& program = p_device->compute_programs.get(program_handle);
+    vkCmdPushConstants(vk_handle, program.layout, VK_SHADER_STAGE_ALL, 0, size, data);
+}
+
 void ComputeCommand::bind_pipeline(const bul::Handle<ComputeProgram>& program_handle)
 {
     auto& program = p_device->compute_programs.get(program_handle);
@@ -266,9 +308,8 @@ void ComputeCommand::dispatch(uint32_t x, uint32_t y, uint32_t z)
 
 /* Transfer */
 
-void TransferCommand::upload_buffer(const bul::Handle<Buffer>& buffer_handle, void* data, uint32_t size)
+bul::Handle<Buffer> TransferCommand::create_staging_buffer(const void* data, uint32_t size)
 {
-    // FIXME delete buffer after use
     auto staging_handle = p_device->create_buffer(
         {.size = size, .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT, .memory_usage = VMA_MEMORY_USAGE_CPU_ONLY});
 
@@ -276,6 +317,14 @@ void TransferCommand::upload_buffer(const bul::Handle<Buffer>& buffer_handle, vo
     std::memcpy(staging_area, data, size);
     p_device->unmap_buffer(p_device->buffers.get(staging_handle));
 
+    staging_buffers.push_back(staging_handle);
+    return staging_handle;
+}
+
+void TransferCommand::upload_buffer(const bul::Handle<Buffer>& buffer_handle, void* data, uint32_t size)
+{
+    auto staging_handle = create_staging_buffer(data, size);
+
     auto& buffer = p_device->buffers.get(buffer_handle);
     auto& staging_buffer = p_device->buffers.get(staging_handle);
 
@@ -290,13 +339,7 @@ void TransferCommand::upload_buffer(const bul::Handle<Buffer>& buffer_handle, vo
 
 void TransferCommand::upload_image(const bul::Handle<Image>& image_handle, void* data, uint32_t size)
 {
-    // FIXME delete buffer after use
-    auto staging_handle = p_device->create_buffer(
-        {.size = size, .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT, .memory_usage = VMA_MEMORY_USAGE_CPU_ONLY});
-
-    void* staging_area = p_device->map_buffer(p_device->buffers.get(staging_handle));
-    std::memcpy(staging_area, data, size);
-    p_device->unmap_buffer(p_device->buffers.get(staging_handle));
+    auto staging_handle = create_staging_buffer(data, size);
 
     auto& image = p_device->images.get(image_handle);
     auto& staging_buffer = p_device->buffers.get(staging_handle);
@@ -319,6 +362,40 @@ void TransferCommand::upload_image(const bul::Handle<Image>& image_handle, void*
                            1, &buffer_image_copy);
 }
 
+void TransferCommand::upload_image(const bul::Handle<Image>& image_handle, const void* data, uint32_t size,
+                                   const std::vector<uint32_t>& level_offsets)
+{
+    auto staging_handle = create_staging_buffer(data, size);
+
+    auto& image = p_device->images.get(image_handle);
+    auto& staging_buffer = p_device->buffers.get(staging_handle);
+
+    ASSERT(level_offsets.size() <= image.description.mip_levels);
+
+    std::vector<VkBufferImageCopy> buffer_image_copies(level_offsets.size());
+    for (uint32_t level = 0; level < level_offsets.size(); ++level)
+    {
+        VkBufferImageCopy& buffer_image_copy = buffer_image_copies[level];
+        buffer_image_copy.bufferOffset = level_offsets[level];
+        buffer_image_copy.bufferRowLength = 0;
+        buffer_image_copy.bufferImageHeight = 0;
+
+        buffer_image_copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        buffer_image_copy.imageSubresource.mipLevel = level;
+        buffer_image_copy.imageSubresource.baseArrayLayer = 0;
+        buffer_image_copy.imageSubresource.layerCount = 1;
+
+        buffer_image_copy.imageOffset = {0, 0, 0};
+        buffer_image_copy.imageExtent = {std::max(image.description.width >> level, 1u),
+                                         std::max(image.description.height >> level, 1u),
+                                         std::max(image.description.depth >> level, 1u)};
+    }
+
+    barrier(image_handle, vk::ImageUsage::TransferDst);
+    vkCmdCopyBufferToImage(vk_handle, staging_buffer.vk_handle, image.vk_handle, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           (uint32_t)buffer_image_copies.size(), buffer_image_copies.data());
+}
+
 void TransferCommand::upload_image(const bul::Handle<Image>& image_handle, const std::string& path)
 {
     int width, height, channels;
@@ -331,6 +408,19 @@ void TransferCommand::upload_image(const bul::Handle<Image>& image_handle, const
     stbi_image_free(data);
 }
 
+void TransferCommand::upload_image(const bul::Handle<Image>& image_handle, const std::vector<uint8_t>& file_data)
+{
+    int width, height, channels;
+    uint8_t* data =
+        stbi_load_from_memory(file_data.data(), (int)file_data.size(), &width, &height, &channels, STBI_rgb_alpha);
+    if (data == nullptr)
+    {
+        throw std::runtime_error("Could not load image from memory");
+    }
+    upload_image(image_handle, data, width * height * 4);
+    stbi_image_free(data);
+}
+
 void TransferCommand::blit_image(const bul::Handle<Image>& src, const bul::Handle<Image>& dst)
 {
     auto& src_image = p_device->images.get(src);
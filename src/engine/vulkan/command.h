@@ -15,6 +15,8 @@ struct Command
 {
     void begin();
     void end();
+    // Called once the GPU is done with the command, by submit_blocking or when its pool is reset
+    void release_staging_buffers();
 
     void barrier(const bul::Handle<Image>& image_handle, ImageUsage dst_usage);
 
@@ -33,19 +35,29 @@ struct Command
     VkCommandBuffer vk_handle = VK_NULL_HANDLE;
     VkQueue vk_queue = VK_NULL_HANDLE;
     VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    // Source buffers of the uploads recorded in the command
+    std::vector<bul::Handle<Buffer>> staging_buffers;
 };
 
 struct TransferCommand : public Command
 {
     void upload_buffer(const bul::Handle<Buffer>& buffer_handle, void* data, uint32_t size);
     void upload_image(const bul::Handle<Image>& image_handle, void* data, uint32_t size);
+    // data holds every mip level of the image, tightly packed, starting at level_offsets[level]
+    void upload_image(const bul::Handle<Image>& image_handle, const void* data, uint32_t size,
+                      const std::vector<uint32_t>& level_offsets);
     void upload_image(const bul::Handle<Image>& image_handle, const std::string& path);
+    void upload_image(const bul::Handle<Image>& image_handle, const std::vector<uint8_t>& file_data);
     void blit_image(const bul::Handle<Image>& src, const bul::Handle<Image>& dst);
+
+    bul::Handle<Buffer> create_staging_buffer(const void* data, uint32_t size);
 };
 
 struct ComputeCommand : public TransferCommand
 {
     void bind_descriptor_set(const bul::Handle<ComputeProgram>& program_handle, DescriptorSet& set, uint32_t set_index);
+    void bind_bindless_set(const bul::Handle<ComputeProgram>& program_handle);
+    void push_constants(const bul::Handle<ComputeProgram>& program_handle, const void* data, uint32_t size);
     void bind_pipeline(const bul::Handle<ComputeProgram>& program_handle);
     void dispatch(uint32_t x, uint32_t y, uint32_t z = 1);
 };
@@ -57,15 +69,20 @@ struct GraphicsCommand : public ComputeCommand
 
     void bind_index_buffer(const bul::Handle<Buffer>& buffer_handle, VkIndexType index_type, uint32_t offset);
     void bind_descriptor_set(const bul::Handle<GraphicsProgram>& program_handle, DescriptorSet& set, uint32_t set_index);
+    // Set 2, it stays bound across programs as long as the sets before it are not rebound
+    void bind_bindless_set(const bul::Handle<GraphicsProgram>& program_handle);
+    void push_constants(const bul::Handle<GraphicsProgram>& program_handle, const void* data, uint32_t size);
     void bind_pipeline(const bul::Handle<GraphicsProgram>& program_handle, uint32_t pipeline_index = 0);
 
-    void begin_renderpass(const bul::Handle<FrameBuffer>& framebuffer_handle, const std::vector<LoadOp>& load_ops);
+    void begin_renderpass(const bul::Handle<FrameBuffer>& framebuffer_handle, const LoadOps& load_ops);
     void end_renderpass();
 
     void draw(uint32_t vertex_count, uint32_t first_vertex = 0);
     void draw_indexed(uint32_t index_count, uint32_t first_index = 0, uint32_t vertex_offset = 0);
 
     using ComputeCommand::bind_descriptor_set;
+    using ComputeCommand::bind_bindless_set;
+    using ComputeCommand::push_constants;
     using ComputeCommand::bind_pipeline;
 };
 
@@ -106,6 +123,10 @@ struct CommandPool
     void reset()
     {
         VK_CHECK(vkResetCommandPool(p_device->vk_handle, vk_handle, 0));
+        for (size_t i = 0; i < index; ++i)
+        {
+            commands[i].release_staging_buffers();
+        }
         index = 0;
     }
 
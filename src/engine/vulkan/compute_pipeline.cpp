@@ -14,12 +14,15 @@ bul::Handle<ComputeProgram> Device::create_compute_program(const ComputeProgramD
     program.description = description;
     program.descriptor_set = set;
 
-    std::array sets{global_uniform_set.layout, set.layout};
+    std::array sets{global_uniform_set.layout, set.layout, bindless_set.layout};
+    VkPushConstantRange push_constants{.stageFlags = VK_SHADER_STAGE_ALL, .offset = 0, .size = PUSH_CONSTANTS_SIZE};
 
     VkPipelineLayoutCreateInfo layout_info{};
     layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
     layout_info.setLayoutCount = sets.size();
     layout_info.pSetLayouts = sets.data();
+    layout_info.pushConstantRangeCount = 1;
+    layout_info.pPushConstantRanges = &push_constants;
 
     VK_CHECK(vkCreatePipelineLayout(vk_handle, &layout_info, nullptr, &program.layout));
 
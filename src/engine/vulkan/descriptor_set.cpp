@@ -1,6 +1,9 @@
 #include "descriptor_set.h"
 
+#include <array>
+
 #include "bul/bul.h"
+#include "bul/containers/small_vector.h"
 
 #include "hash.h"
 #include "vk_tools.h"
@@ -23,6 +26,12 @@ static VkDescriptorType to_vk(DescriptorType::Type type)
     }
 }
 
+// Every byte is set, the descriptors are compared and hashed as a whole
+static Descriptor make_descriptor()
+{
+    return Descriptor{{.binary = {0, 0}}};
+}
+
 DescriptorSet Device::create_descriptor_set(const std::vector<DescriptorType>& descriptor_types)
 {
     DescriptorSet descriptor_set{};
@@ -45,8 +54,7 @@ DescriptorSet Device::create_descriptor_set(const std::vector<DescriptorType>& d
         }
     }
 
-    Descriptor empty = {{{}}};
-    descriptor_set.descriptors.resize(descriptor_types.size(), empty);
+    descriptor_set.descriptors.resize(descriptor_types.size(), make_descriptor());
     descriptor_set.dynamic_offsets.resize(descriptor_set.dynamic_descriptors.size());
 
     VkDescriptorSetLayoutCreateInfo layout_info{};
@@ -61,23 +69,208 @@ DescriptorSet Device::create_descriptor_set(const std::vector<DescriptorType>& d
     return descriptor_set;
 }
 
+VkDescriptorPool Device::create_descriptor_pool()
+{
+    std::array pool_sizes{
+        VkDescriptorPoolSize{.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, .descriptorCount = DESCRIPTORS_PER_POOL},
+        VkDescriptorPoolSize{.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .descriptorCount = DESCRIPTORS_PER_POOL},
+        VkDescriptorPoolSize{.type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, .descriptorCount = DESCRIPTORS_PER_POOL},
+        VkDescriptorPoolSize{.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .descriptorCount = DESCRIPTORS_PER_POOL},
+    };
+    VkDescriptorPoolCreateInfo pool_info{};
+    pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pool_info.poolSizeCount = pool_sizes.size();
+    pool_info.pPoolSizes = pool_sizes.data();
+    pool_info.maxSets = SETS_PER_POOL;
+
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    VK_CHECK(vkCreateDescriptorPool(vk_handle, &pool_info, nullptr, &pool));
+    return pool;
+}
+
+// Sets are never freed on their own, the caches recycle them and the pools go away with the device
+VkDescriptorSet Device::allocate_descriptor_set(VkDescriptorSetLayout layout)
+{
+    VkDescriptorSetAllocateInfo set_info{};
+    set_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    set_info.pSetLayouts = &layout;
+    set_info.descriptorSetCount = 1;
+
+    VkDescriptorSet vk_set = VK_NULL_HANDLE;
+    VkResult res = VK_ERROR_OUT_OF_POOL_MEMORY;
+    if (!descriptor_pools.empty())
+    {
+        set_info.descriptorPool = descriptor_pools.back();
+        res = vkAllocateDescriptorSets(vk_handle, &set_info, &vk_set);
+    }
+    if (res == VK_ERROR_OUT_OF_POOL_MEMORY || res == VK_ERROR_FRAGMENTED_POOL)
+    {
+        descriptor_pools.push_back(create_descriptor_pool());
+        ++descriptor_stats.pools;
+        set_info.descriptorPool = descriptor_pools.back();
+        res = vkAllocateDescriptorSets(vk_handle, &set_info, &vk_set);
+    }
+    VK_CHECK(res);
+    ++descriptor_stats.allocations;
+    return vk_set;
+}
+
+void Device::create_bindless_set()
+{
+    std::array bindings{
+        VkDescriptorSetLayoutBinding{.binding = BindlessSet::SAMPLED_IMAGES_BINDING,
+                                     .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                                     .descriptorCount = BindlessSet::MAX_IMAGES,
+                                     .stageFlags = VK_SHADER_STAGE_ALL,
+                                     .pImmutableSamplers = nullptr},
+        VkDescriptorSetLayoutBinding{.binding = BindlessSet::STORAGE_IMAGES_BINDING,
+                                     .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                                     .descriptorCount = BindlessSet::MAX_IMAGES,
+                                     .stageFlags = VK_SHADER_STAGE_ALL,
+                                     .pImmutableSamplers = nullptr},
+        VkDescriptorSetLayoutBinding{.binding = BindlessSet::STORAGE_BUFFERS_BINDING,
+                                     .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                     .descriptorCount = BindlessSet::MAX_BUFFERS,
+                                     .stageFlags = VK_SHADER_STAGE_ALL,
+                                     .pImmutableSamplers = nullptr},
+    };
+    // Written while bound, and while the frames in flight use other entries
+    VkDescriptorBindingFlags binding_flag = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT
+                                            | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT
+                                            | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+    std::array binding_flags{binding_flag, binding_flag, binding_flag};
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo flags_info{};
+    flags_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    flags_info.bindingCount = binding_flags.size();
+    flags_info.pBindingFlags = binding_flags.data();
+
+    VkDescriptorSetLayoutCreateInfo layout_info{};
+    layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layout_info.pNext = &flags_info;
+    layout_info.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layout_info.bindingCount = bindings.size();
+    layout_info.pBindings = bindings.data();
+    VK_CHECK(vkCreateDescriptorSetLayout(vk_handle, &layout_info, nullptr, &bindless_set.layout));
+
+    std::array pool_sizes{
+        VkDescriptorPoolSize{.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                             .descriptorCount = BindlessSet::MAX_IMAGES},
+        VkDescriptorPoolSize{.type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, .descriptorCount = BindlessSet::MAX_IMAGES},
+        VkDescriptorPoolSize{.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .descriptorCount = BindlessSet::MAX_BUFFERS},
+    };
+    VkDescriptorPoolCreateInfo pool_info{};
+    pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    pool_info.poolSizeCount = pool_sizes.size();
+    pool_info.pPoolSizes = pool_sizes.data();
+    pool_info.maxSets = 1;
+    VK_CHECK(vkCreateDescriptorPool(vk_handle, &pool_info, nullptr, &bindless_set.pool));
+
+    VkDescriptorSetAllocateInfo set_info{};
+    set_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    set_info.descriptorPool = bindless_set.pool;
+    set_info.pSetLayouts = &bindless_set.layout;
+    set_info.descriptorSetCount = 1;
+    VK_CHECK(vkAllocateDescriptorSets(vk_handle, &set_info, &bindless_set.vk_set));
+}
+
+void Device::destroy_bindless_set()
+{
+    vkDestroyDescriptorPool(vk_handle, bindless_set.pool, nullptr);
+    vkDestroyDescriptorSetLayout(vk_handle, bindless_set.layout, nullptr);
+    bindless_set = {};
+}
+
+// The entry of a destroyed resource is left as is, it is overwritten by the next resource with the same handle value
+void Device::write_bindless(const bul::Handle<Image>& handle)
+{
+    const Image& image = images.get(handle);
+    uint32_t index = bindless_index(handle);
+    ASSERT(index < BindlessSet::MAX_IMAGES);
+
+    // A storage image can also be sampled
+    bul::SmallVector<VkWriteDescriptorSet, 2> writes;
+    bul::SmallVector<VkDescriptorImageInfo, 2> images_info;
+    if (image.description.usage & VK_IMAGE_USAGE_SAMPLED_BIT)
+    {
+        images_info.push_back({
+            .sampler = samplers[0],
+            .imageView = image.full_view.vk_handle,
+            .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        });
+        auto& write = writes.emplace_back();
+        write.dstBinding = BindlessSet::SAMPLED_IMAGES_BINDING;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    }
+    if (image.description.usage & VK_IMAGE_USAGE_STORAGE_BIT)
+    {
+        images_info.push_back({
+            .sampler = VK_NULL_HANDLE,
+            .imageView = image.full_view.vk_handle,
+            .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+        });
+        auto& write = writes.emplace_back();
+        write.dstBinding = BindlessSet::STORAGE_IMAGES_BINDING;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    }
+    for (size_t i = 0; i < writes.size(); ++i)
+    {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = bindless_set.vk_set;
+        writes[i].dstArrayElement = index;
+        writes[i].descriptorCount = 1;
+        writes[i].pImageInfo = &images_info[i];
+    }
+    if (!writes.empty())
+    {
+        vkUpdateDescriptorSets(vk_handle, writes.size(), writes.data(), 0, nullptr);
+    }
+}
+
+void Device::write_bindless(const bul::Handle<Buffer>& handle)
+{
+    const Buffer& buffer = buffers.get(handle);
+    if (!(buffer.description.usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT))
+    {
+        return;
+    }
+    uint32_t index = bindless_index(handle);
+    ASSERT(index < BindlessSet::MAX_BUFFERS);
+
+    VkDescriptorBufferInfo buffer_info{.buffer = buffer.vk_handle, .offset = 0, .range = VK_WHOLE_SIZE};
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = bindless_set.vk_set;
+    write.dstBinding = BindlessSet::STORAGE_BUFFERS_BINDING;
+    write.dstArrayElement = index;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.pBufferInfo = &buffer_info;
+    vkUpdateDescriptorSets(vk_handle, 1, &write, 0, nullptr);
+}
+
 void DescriptorSet::bind_image(uint32_t binding, const bul::Handle<Image>& image)
 {
     ASSERT(descriptor_types[binding].info.type == DescriptorType::Type::SampledImage
            || descriptor_types[binding].info.type == DescriptorType::Type::StorageImage);
+    descriptors[binding] = make_descriptor();
     descriptors[binding].image = {image};
 }
 
 void DescriptorSet::bind_storage_buffer(uint32_t binding, const bul::Handle<Buffer>& buffer)
 {
     ASSERT(descriptor_types[binding].info.type == DescriptorType::Type::StorageBuffer);
+    descriptors[binding] = make_descriptor();
     descriptors[binding].buffer = {buffer};
 }
 
 void DescriptorSet::bind_uniform_buffer(uint32_t binding, const bul::Handle<Buffer>& buffer, uint32_t offset, uint32_t size)
 {
     ASSERT(descriptor_types[binding].info.type == DescriptorType::Type::DynamicBuffer);
-    descriptors[binding].dynamic = {buffer, offset, size};
+    // The offset only goes to the dynamic offsets, a new offset every draw is still the same set
+    descriptors[binding] = make_descriptor();
+    descriptors[binding].dynamic = {buffer, 0, size};
 
     for (size_t i = 0; i < dynamic_descriptors.size(); ++i)
     {
@@ -89,31 +282,74 @@ void DescriptorSet::bind_uniform_buffer(uint32_t binding, const bul::Handle<Buff
     }
 }
 
-VkDescriptorSet DescriptorSet::get_or_create_vk_set(Device& device)
+void DescriptorSetCache::touch(uint32_t index, uint64_t frame)
 {
-    size_t hash = hash_value(descriptors);
-    for (size_t i = 0; i < hashes.size(); ++i)
+    Entry& entry = entries[index];
+    entry.last_used_frame = frame;
+    if (most_recent == index)
     {
-        if (hashes[i] == hash)
-        {
-            return vk_sets[i];
-        }
+        return;
+    }
+    // Unlink, new entries are not linked yet
+    if (entry.prev != NONE)
+    {
+        entries[entry.prev].next = entry.next;
+    }
+    if (entry.next != NONE)
+    {
+        entries[entry.next].prev = entry.prev;
+    }
+    if (least_recent == index)
+    {
+        least_recent = entry.prev;
     }
+    entry.prev = NONE;
+    entry.next = most_recent;
+    if (most_recent != NONE)
+    {
+        entries[most_recent].prev = index;
+    }
+    most_recent = index;
+    if (least_recent == NONE)
+    {
+        least_recent = index;
+    }
+}
 
-    VkDescriptorSetAllocateInfo set_info{};
-    set_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    set_info.descriptorPool = device.descriptor_pool;
-    set_info.pSetLayouts = &layout;
-    set_info.descriptorSetCount = 1;
+VkDescriptorSet DescriptorSet::get_or_create_vk_set(Device& device)
+{
+    if (auto* found = cache.indices[descriptors])
+    {
+        ++device.descriptor_stats.hits;
+        cache.touch(found->val, device.frame_index);
+        return cache.entries[found->val].vk_set;
+    }
+    ++device.descriptor_stats.misses;
 
-    VkDescriptorSet vk_set = VK_NULL_HANDLE;
-    VK_CHECK(vkAllocateDescriptorSets(device.vk_handle, &set_info, &vk_set));
-    vk_sets.push_back(vk_set);
-    hashes.push_back(hash);
+    uint32_t index = cache.least_recent;
+    if (index != DescriptorSetCache::NONE
+        && cache.entries[index].last_used_frame + Device::MAX_FRAMES <= device.frame_index)
+    {
+        // Not used by the frames in flight, the fence of the frame context was waited on before recording
+        ++device.descriptor_stats.recycles;
+        cache.indices.erase(cache.entries[index].descriptors);
+    }
+    else
+    {
+        index = uint32_t(cache.entries.size());
+        cache.entries.emplace_back().vk_set = device.allocate_descriptor_set(layout);
+    }
+    DescriptorSetCache::Entry& entry = cache.entries[index];
+    entry.descriptors = descriptors;
+    cache.indices.emplace(descriptors, index);
+    cache.touch(index, device.frame_index);
+    VkDescriptorSet vk_set = entry.vk_set;
 
-    std::vector<VkWriteDescriptorSet> writes(descriptors.size());
-    std::vector<VkDescriptorImageInfo> images_info;
-    std::vector<VkDescriptorBufferInfo> buffers_info;
+    // Sized for the usual set layouts, the infos are referenced by the writes so they must not reallocate
+    bul::SmallVector<VkWriteDescriptorSet, 16> writes;
+    bul::SmallVector<VkDescriptorImageInfo, 16> images_info;
+    bul::SmallVector<VkDescriptorBufferInfo, 16> buffers_info;
+    writes.resize(descriptors.size());
     buffers_info.reserve(descriptors.size());
     images_info.reserve(descriptors.size());
 
@@ -6,6 +6,7 @@
 
 #include "fwd.h"
 #include "bul/containers/handle.h"
+#include "bul/containers/swiss_map.h"
 
 namespace vk
 {
@@ -19,6 +20,7 @@ struct BufferDescriptor
     bul::Handle<Buffer> handle;
 };
 
+// The offset is given when the set is bound, sets only differ by buffer and size
 struct DynamicDescriptor
 {
     bul::Handle<Buffer> handle;
@@ -66,16 +68,83 @@ struct Descriptor
         DynamicDescriptor dynamic;
         uint64_t binary[2];
     };
+
+    bool operator==(const Descriptor& other) const
+    {
+        return binary[0] == other.binary[0] && binary[1] == other.binary[1];
+    }
+};
+
+/*
+ * The sets written for a layout, looked up by their descriptors. On a miss the least recently used set is rewritten
+ * when the gpu is done with it, that is when it was not used by the frames in flight, otherwise a new one is allocated.
+ */
+struct DescriptorSetCache
+{
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Entry
+    {
+        VkDescriptorSet vk_set = VK_NULL_HANDLE;
+        std::vector<Descriptor> descriptors;
+        uint64_t last_used_frame = 0;
+        // Least recently used list
+        uint32_t prev = NONE;
+        uint32_t next = NONE;
+    };
+
+    bul::SwissMap<std::vector<Descriptor>, uint32_t> indices{};
+    std::vector<Entry> entries;
+    uint32_t most_recent = NONE;
+    uint32_t least_recent = NONE;
+
+    // Moves the entry to the front of the list
+    void touch(uint32_t index, uint64_t frame);
+};
+
+struct DescriptorStats
+{
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t allocations = 0;
+    uint64_t recycles = 0;
+    uint64_t pools = 0;
+};
+
+/*
+ * Every image and buffer of the device in a single set, at the value of its handle: sampled images, storage images and
+ * storage buffers each have their own array. The arrays are partially bound and updated after bind, entries are
+ * written when the resources are created and only the ones of live resources can be read by the shaders.
+ * Handle values are reused, so they stay below the peak count of live images or buffers. Images of every usage share
+ * one handle space, both image arrays span all of it.
+ */
+struct BindlessSet
+{
+    static constexpr uint32_t SAMPLED_IMAGES_BINDING = 0;
+    static constexpr uint32_t STORAGE_IMAGES_BINDING = 1;
+    static constexpr uint32_t STORAGE_BUFFERS_BINDING = 2;
+    static constexpr uint32_t MAX_IMAGES = 4096;
+    static constexpr uint32_t MAX_BUFFERS = 4096;
+
+    VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    VkDescriptorSet vk_set = VK_NULL_HANDLE;
 };
 
+// Index of the resource in the arrays of the bindless set
+template <typename T>
+uint32_t bindless_index(const bul::Handle<T>& handle)
+{
+    return handle.value;
+}
+
 struct DescriptorSet
 {
     VkDescriptorSetLayout layout = VK_NULL_HANDLE;
     std::vector<DescriptorType> descriptor_types;
     size_t layout_hash = 0;
 
-    std::vector<VkDescriptorSet> vk_sets;
-    std::vector<size_t> hashes;
+    DescriptorSetCache cache;
 
     std::vector<Descriptor> descriptors;
     std::vector<uint32_t> dynamic_descriptors;
@@ -87,24 +156,3 @@ struct DescriptorSet
     VkDescriptorSet get_or_create_vk_set(Device& device);
 };
 } // namespace vk
-
-namespace std
-{
-template <>
-struct hash<vk::Descriptor>
-{
-    size_t operator()(const vk::Descriptor& descriptor) const noexcept
-    {
-        return descriptor.binary[0];
-    }
-};
-
-template <>
-struct hash<vk::DescriptorType>
-{
-    size_t operator()(const vk::DescriptorType& descriptor_type) const noexcept
-    {
-        return descriptor_type.binary;
-    }
-};
-} // namespace std
@@ -1,7 +1,12 @@
 #include "device.h"
 
-#include <vector>
 #include <array>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bul/profiler.h"
 
 #include "vk_tools.h"
 #include "context.h"
@@ -53,8 +58,42 @@ Device Device::create(const Context& context)
     device_features.fillModeNonSolid = true;
     device_features.wideLines = true;
 
+    // For the bindless set, a device without one of them cannot run the renderer
+    VkPhysicalDeviceDescriptorIndexingFeatures supported_indexing_features{};
+    supported_indexing_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+    VkPhysicalDeviceFeatures2 supported_features{};
+    supported_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    supported_features.pNext = &supported_indexing_features;
+    vkGetPhysicalDeviceFeatures2(device.physical_device.vk_handle, &supported_features);
+
+#define INDEXING_FEATURE(name) std::pair{&VkPhysicalDeviceDescriptorIndexingFeatures::name, #name}
+    static constexpr std::array required_indexing_features{
+        INDEXING_FEATURE(shaderSampledImageArrayNonUniformIndexing),
+        INDEXING_FEATURE(shaderStorageImageArrayNonUniformIndexing),
+        INDEXING_FEATURE(shaderStorageBufferArrayNonUniformIndexing),
+        INDEXING_FEATURE(descriptorBindingSampledImageUpdateAfterBind),
+        INDEXING_FEATURE(descriptorBindingStorageImageUpdateAfterBind),
+        INDEXING_FEATURE(descriptorBindingStorageBufferUpdateAfterBind),
+        INDEXING_FEATURE(descriptorBindingUpdateUnusedWhilePending),
+        INDEXING_FEATURE(descriptorBindingPartiallyBound),
+        INDEXING_FEATURE(runtimeDescriptorArray),
+    };
+#undef INDEXING_FEATURE
+
+    VkPhysicalDeviceDescriptorIndexingFeatures indexing_features{};
+    indexing_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+    for (const auto& [feature, name] : required_indexing_features)
+    {
+        if (!(supported_indexing_features.*feature))
+        {
+            throw std::runtime_error(std::string("Missing descriptor indexing feature: ") + name);
+        }
+        indexing_features.*feature = VK_TRUE;
+    }
+
     VkDeviceCreateInfo create_info{};
     create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    create_info.pNext = &indexing_features;
     create_info.pQueueCreateInfos = queue_create_infos.data();
     create_info.queueCreateInfoCount = queue_create_infos.size();
     create_info.pEnabledFeatures = &device_features;
@@ -98,8 +137,8 @@ Device Device::create(const Context& context)
 
     VkSamplerCreateInfo sampler_info{};
     sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-    sampler_info.magFilter = VK_FILTER_NEAREST;
-    sampler_info.minFilter = VK_FILTER_NEAREST;
+    sampler_info.magFilter = VK_FILTER_LINEAR;
+    sampler_info.minFilter = VK_FILTER_LINEAR;
     sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
     sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
     sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
@@ -112,11 +151,14 @@ Device Device::create(const Context& context)
     sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
     sampler_info.mipLodBias = 0.0f;
     sampler_info.minLod = 0.0f;
-    sampler_info.maxLod = 0.0f;
+    sampler_info.maxLod = VK_LOD_CLAMP_NONE;
 
     device.samplers.resize(1);
     vkCreateSampler(device.vk_handle, &sampler_info, nullptr, &device.samplers.back());
 
+    // Before any image or buffer, they are written to it as they are created
+    device.create_bindless_set();
+
     device.create_frame_contexts();
 
     device.global_uniform_set =
@@ -162,6 +204,13 @@ void Device::destroy()
         vkDestroySampler(vk_handle, sampler, nullptr);
     }
 
+    destroy_bindless_set();
+
+    for (auto& pool : descriptor_pools)
+    {
+        vkDestroyDescriptorPool(vk_handle, pool, nullptr);
+    }
+    descriptor_pools.clear();
     vkDestroyDescriptorPool(vk_handle, descriptor_pool, nullptr);
     vmaDestroyAllocator(allocator);
     allocator = VK_NULL_HANDLE;
@@ -174,10 +223,13 @@ void Device::wait_idle()
     VK_CHECK(vkDeviceWaitIdle(vk_handle));
 }
 
+// Includes waiting for the gpu to be done with the frame context
 bool Device::acquire_next_image(Surface& surface)
 {
+    PROFILE_SCOPE("vk::Device::acquire_next_image");
     auto& fc = frame_contexts[current_frame];
     vkWaitForFences(vk_handle, 1, &fc.rendering_finished_fence, VK_TRUE, UINT64_MAX);
+    scratch.begin_frame();
     auto res = vkAcquireNextImageKHR(vk_handle, surface.swapchain, UINT64_MAX, fc.image_acquired_semaphore,
                                      VK_NULL_HANDLE, &fc.image_index);
 
@@ -197,6 +249,7 @@ bool Device::acquire_next_image(Surface& surface)
 
 bool Device::present(Surface& surface)
 {
+    PROFILE_SCOPE("vk::Device::present");
     auto& fc = frame_contexts[current_frame];
     VkPresentInfoKHR present_info{};
     present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -209,6 +262,9 @@ bool Device::present(Surface& surface)
     auto res = vkQueuePresentKHR(graphics_queue, &present_info);
 
     current_frame = (current_frame + 1) % MAX_FRAMES;
+    ++frame_index;
+    PROFILE_COUNTER("descriptor set hits", descriptor_stats.hits);
+    PROFILE_COUNTER("descriptor set allocations", descriptor_stats.allocations);
 
     if (res == VK_SUBOPTIMAL_KHR || res == VK_ERROR_OUT_OF_DATE_KHR)
     {
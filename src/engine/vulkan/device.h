@@ -1,9 +1,11 @@
 #pragma once
 
 #include <functional>
+#include <span>
 #include <volk.h>
 #include <vma/vk_mem_alloc.h>
 
+#include "bul/arena.h"
 #include "bul/containers/handle.h"
 #include "bul/containers/pool.h"
 
@@ -25,6 +27,8 @@ struct Device
 {
     static constexpr uint32_t MAX_FRAMES = 2;
     uint32_t current_frame = 0;
+    // Frames presented so far
+    uint64_t frame_index = 0;
 
     PhysicalDevice physical_device;
     VkDevice vk_handle = VK_NULL_HANDLE;
@@ -34,6 +38,7 @@ struct Device
     VkQueue graphics_queue = VK_NULL_HANDLE;
     VkQueue compute_queue = VK_NULL_HANDLE;
     VkQueue transfer_queue = VK_NULL_HANDLE;
+    // For imgui, the descriptor sets of the programs come from descriptor_pools
     VkDescriptorPool descriptor_pool = VK_NULL_HANDLE;
     VmaAllocator allocator = VK_NULL_HANDLE;
 
@@ -45,14 +50,28 @@ struct Device
     bul::Pool<ComputeProgram> compute_programs;
     std::vector<VkSampler> samplers;
     FrameContext frame_contexts[MAX_FRAMES];
+    // Temporaries of the frame being recorded, reset when its next image is acquired
+    bul::FrameArena scratch;
+    static_assert(bul::FrameArena::FRAMES == MAX_FRAMES, "The scratch arenas must be buffered like the frame contexts");
 
     DescriptorSet global_uniform_set;
+    // Set 2 of every program
+    BindlessSet bindless_set;
+    // Push constants of every program, for all the stages
+    static constexpr uint32_t PUSH_CONSTANTS_SIZE = 128;
+
+    static constexpr uint32_t SETS_PER_POOL = 256;
+    static constexpr uint32_t DESCRIPTORS_PER_POOL = 1024;
+    // A new pool is added when the last one is full
+    std::vector<VkDescriptorPool> descriptor_pools;
+    DescriptorStats descriptor_stats;
 
     static Device create(const Context& context);
     void destroy();
 
     bul::Handle<Image> create_image(const ImageDescription& description, VkImage vk_image = VK_NULL_HANDLE);
     bul::Handle<Image> create_image(const ImageDescription& description, const std::string& path);
+    bul::Handle<Image> create_image(const ImageDescription& description, const std::vector<uint8_t>& file_data);
     void destroy_image(Image& image);
 
     bul::Handle<Buffer> create_buffer(const BufferDescription& description);
@@ -60,8 +79,8 @@ struct Device
     void* map_buffer(Buffer& buffer);
     void unmap_buffer(Buffer& buffer);
 
-    RenderPass create_renderpass(const FrameBufferDescription& description, const std::vector<LoadOp>& load_ops);
-    const RenderPass& get_or_create_renderpass(const bul::Handle<FrameBuffer>& handle, const std::vector<LoadOp>& load_ops);
+    RenderPass create_renderpass(const FrameBufferDescription& description, const LoadOps& load_ops);
+    const RenderPass& get_or_create_renderpass(const bul::Handle<FrameBuffer>& handle, const LoadOps& load_ops);
     bul::Handle<FrameBuffer> create_framebuffer(const FrameBufferDescription& description,
                                            const std::vector<bul::Handle<Image>>& color_attachments,
                                            const bul::Handle<Image>& depth_attachment);
@@ -69,8 +88,16 @@ struct Device
 
     DescriptorSet create_descriptor_set(const std::vector<DescriptorType>& descriptor_types);
     void destroy_descriptor_set(DescriptorSet& descriptor_set);
+    VkDescriptorPool create_descriptor_pool();
+    VkDescriptorSet allocate_descriptor_set(VkDescriptorSetLayout layout);
+    void create_bindless_set();
+    void destroy_bindless_set();
+    void write_bindless(const bul::Handle<Image>& handle);
+    void write_bindless(const bul::Handle<Buffer>& handle);
 
     bul::Handle<Shader> create_shader(const std::string& path);
+    // spirv is 4 bytes aligned, path only names the shader
+    bul::Handle<Shader> create_shader(const std::string& path, std::span<const uint8_t> spirv);
     void destroy_shader(Shader& shader);
 
     bul::Handle<GraphicsProgram> create_graphics_program(const GraphicsProgramDescription& description);
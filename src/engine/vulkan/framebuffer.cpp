@@ -7,7 +7,7 @@
 
 namespace vk
 {
-RenderPass Device::create_renderpass(const FrameBufferDescription& description, const std::vector<LoadOp>& load_ops)
+RenderPass Device::create_renderpass(const FrameBufferDescription& description, const LoadOps& load_ops)
 {
     ASSERT(description.color_formats.size() + description.depth_format.has_value() == load_ops.size());
 
@@ -87,7 +87,7 @@ RenderPass Device::create_renderpass(const FrameBufferDescription& description,
 }
 
 const RenderPass& Device::get_or_create_renderpass(const bul::Handle<FrameBuffer>& handle,
-                                                   const std::vector<LoadOp>& load_ops)
+                                                   const LoadOps& load_ops)
 {
     auto& fb = framebuffers.get(handle);
 
@@ -132,8 +132,12 @@ bul::Handle<FrameBuffer> Device::create_framebuffer(const FrameBufferDescription
         ASSERT(image.full_view.format == description.depth_format);
     }
 
-    framebuffer.renderpasses.push_back(
-        create_renderpass(description, std::vector<LoadOp>(attachments_count, LoadOp::dont_care())));
+    LoadOps load_ops;
+    for (size_t i = 0; i < attachments_count; ++i)
+    {
+        load_ops.push_back(LoadOp::dont_care());
+    }
+    framebuffer.renderpasses.push_back(create_renderpass(description, load_ops));
 
     VkFramebufferCreateInfo framebuffer_info{};
     framebuffer_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
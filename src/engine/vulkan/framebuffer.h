@@ -67,7 +67,7 @@ struct LoadOp
 struct RenderPass
 {
     VkRenderPass vk_handle = VK_NULL_HANDLE;
-    std::vector<LoadOp> load_ops;
+    LoadOps load_ops;
 };
 
 struct FrameBufferDescription
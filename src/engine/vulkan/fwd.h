@@ -1,5 +1,7 @@
 #pragma once
 
+#include "bul/containers/small_vector.h"
+
 namespace vk
 {
 struct Buffer;
@@ -21,4 +23,7 @@ struct RenderPass;
 struct Shader;
 struct Surface;
 struct TransferCommand;
+
+// One per attachment
+using LoadOps = bul::SmallVector<LoadOp, 8>;
 } // namespace vk
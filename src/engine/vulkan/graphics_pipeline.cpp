@@ -15,19 +15,26 @@ bul::Handle<GraphicsProgram> Device::create_graphics_program(const GraphicsProgr
     program.description = description;
     program.descriptor_set = set;
 
-    std::array sets{global_uniform_set.layout, set.layout};
+    std::array sets{global_uniform_set.layout, set.layout, bindless_set.layout};
+    VkPushConstantRange push_constants{.stageFlags = VK_SHADER_STAGE_ALL, .offset = 0, .size = PUSH_CONSTANTS_SIZE};
 
     VkPipelineLayoutCreateInfo layout_info{};
     layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
     layout_info.setLayoutCount = sets.size();
     layout_info.pSetLayouts = sets.data();
+    layout_info.pushConstantRangeCount = 1;
+    layout_info.pPushConstantRanges = &push_constants;
 
     VK_CHECK(vkCreatePipelineLayout(vk_handle, &layout_info, nullptr, &program.layout));
 
     size_t attachment_count =
         description.attachment_formats.color_formats.size() + description.attachment_formats.depth_format.has_value();
-    program.renderpass =
-        create_renderpass(description.attachment_formats, std::vector<LoadOp>(attachment_count, LoadOp::dont_care()));
+    LoadOps load_ops;
+    for (size_t i = 0; i < attachment_count; ++i)
+    {
+        load_ops.push_back(LoadOp::dont_care());
+    }
+    program.renderpass = create_renderpass(description.attachment_formats, load_ops);
 
     return graphics_programs.insert(std::move(program));
 }
@@ -2,6 +2,8 @@
 
 #include <stb/stb_image.h>
 
+#include "bul/memory.h"
+
 #include "vk_tools.h"
 #include "device.h"
 
@@ -55,7 +57,9 @@ bul::Handle<Image> Device::create_image(const ImageDescription& description, VkI
         VmaAllocationCreateInfo alloc_info{};
         alloc_info.usage = description.memory_usage;
 
-        VK_CHECK(vmaCreateImage(allocator, &image_info, &alloc_info, &vk_image, &allocation, nullptr));
+        VmaAllocationInfo allocation_info{};
+        VK_CHECK(vmaCreateImage(allocator, &image_info, &alloc_info, &vk_image, &allocation, &allocation_info));
+        bul::memory::track(bul::memory::Tag::VulkanImages, allocation_info.size);
     }
 
     VkImageSubresourceRange full_range{};
@@ -68,8 +72,10 @@ bul::Handle<Image> Device::create_image(const ImageDescription& description, VkI
     ImageView full_view = create_image_view(*this, vk_image, full_range, description.format,
                                             static_cast<VkImageViewType>(description.type));
 
-    return images.insert(
+    auto handle = images.insert(
         Image{.description = description, .vk_handle = vk_image, .allocation = allocation, .full_view = full_view});
+    write_bindless(handle);
+    return handle;
 }
 
 bul::Handle<Image> Device::create_image(const ImageDescription& description, const std::string& path)
@@ -88,10 +94,29 @@ bul::Handle<Image> Device::create_image(const ImageDescription& description, con
     return create_image(new_description);
 }
 
+bul::Handle<Image> Device::create_image(const ImageDescription& description, const std::vector<uint8_t>& file_data)
+{
+    int width, height, channels;
+    if (!stbi_info_from_memory(file_data.data(), (int)file_data.size(), &width, &height, &channels))
+    {
+        return bul::Handle<Image>::invalid;
+    }
+
+    ImageDescription new_description = description;
+    new_description.width = width;
+    new_description.height = height;
+    new_description.depth = 1;
+
+    return create_image(new_description);
+}
+
 void Device::destroy_image(Image& image)
 {
     if (image.allocation != VK_NULL_HANDLE)
     {
+        VmaAllocationInfo allocation_info{};
+        vmaGetAllocationInfo(allocator, image.allocation, &allocation_info);
+        bul::memory::untrack(bul::memory::Tag::VulkanImages, allocation_info.size);
         vmaDestroyImage(allocator, image.vk_handle, image.allocation);
         image.allocation = VK_NULL_HANDLE;
         image.vk_handle = VK_NULL_HANDLE;
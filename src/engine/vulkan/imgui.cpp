@@ -3,6 +3,7 @@
 // #include <imgui/backends/imgui_impl_glfw.h>
 // #include <imgui/backends/imgui_impl_vulkan.h>
 
+#include "bul/profiler.h"
 #include "bul/window.h"
 
 #include "context.h"
@@ -64,4 +65,62 @@ void imgui_render_draw_data(Command&)
 {
     /* ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), cmd.vk_handle); */
 }
+
+void imgui_profiler(const char* capture_path)
+{
+    ImGui::Begin("Profiler");
+#if !defined(BUL_PROFILE)
+    ImGui::Text("Built without BUL_PROFILE, nothing is recorded");
+#endif
+
+    std::vector<float> history = bul::profiler::frame_history_ms();
+    bul::profiler::FrameRecord frame = bul::profiler::last_frame();
+    ImGui::Text("Frame: %.3f ms", frame.duration_us / 1'000);
+    ImGui::PlotLines("##frames", history.data(), int(history.size()), 0, nullptr, 0, FLT_MAX, ImVec2(0, 60));
+
+    if (bul::profiler::capturing())
+    {
+        if (ImGui::Button("Stop capture"))
+        {
+            bul::profiler::end_capture(capture_path);
+        }
+    }
+    else if (ImGui::Button("Capture"))
+    {
+        bul::profiler::begin_capture();
+    }
+    if (frame.dropped > 0)
+    {
+        ImGui::TextColored(ImVec4(1, 0.4f, 0.4f, 1), "%llu scopes dropped", (unsigned long long)frame.dropped);
+    }
+
+    for (const auto& thread : frame.threads)
+    {
+        ImGui::PushID(int(thread.id));
+        if (ImGui::TreeNodeEx(thread.name.c_str(), ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            // Scopes are sorted by thread then begin, children right after their parent
+            for (const auto& scope : frame.scopes)
+            {
+                if (scope.thread == thread.id)
+                {
+                    ImGui::Text("%*s%s", int(scope.depth * 2), "", scope.name);
+                    ImGui::SameLine(ImGui::GetWindowWidth() - 100);
+                    ImGui::Text("%8.3f ms", scope.duration_us / 1'000);
+                }
+            }
+            ImGui::TreePop();
+        }
+        ImGui::PopID();
+    }
+
+    if (!frame.counters.empty() && ImGui::CollapsingHeader("Counters", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        for (const auto& counter : frame.counters)
+        {
+            ImGui::Text("%s: %g", counter.name, counter.value);
+        }
+    }
+    ImGui::End();
+}
 } // namespace vk
@@ -14,4 +14,8 @@ void imgui_shutdown();
 void imgui_new_frame();
 void imgui_render();
 void imgui_render_draw_data(Command& cmd);
+
+// Live view of bul::profiler: frame times, the scopes of the last frame of each thread, counters, and a button to
+// capture a Chrome trace to capture_path
+void imgui_profiler(const char* capture_path = "profile.json");
 } // namespace vk
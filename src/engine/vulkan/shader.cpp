@@ -9,13 +9,17 @@ namespace vk
 {
 bul::Handle<Shader> Device::create_shader(const std::string& path)
 {
-    std::vector<uint8_t> shader_code;
-    bul::read_file((path + ".spv").c_str(), shader_code);
+    // Mappings are page aligned, the module is created straight from the page cache
+    bul::MappedFile shader_code((path + ".spv").c_str(), bul::MappedFile::Access::Sequential);
+    return create_shader(path, shader_code);
+}
 
+bul::Handle<Shader> Device::create_shader(const std::string& path, std::span<const uint8_t> spirv)
+{
     VkShaderModuleCreateInfo shader_info{};
     shader_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    shader_info.codeSize = shader_code.size();
-    shader_info.pCode = (uint32_t*)shader_code.data();
+    shader_info.codeSize = spirv.size();
+    shader_info.pCode = (const uint32_t*)spirv.data();
 
     VkShaderModule vk_shader = VK_NULL_HANDLE;
     VK_CHECK(vkCreateShaderModule(vk_handle, &shader_info, nullptr, &vk_shader));
@@ -7,6 +7,10 @@
 #include "renderer.h"
 #include "path_tracing_renderer.h"
 
+#include "bul/io.h"
+#include "bul/jobs.h"
+#include "bul/memory.h"
+#include "bul/profiler.h"
 #include "bul/time.h"
 #include "bul/window.h"
 #include "bul/containers/pool.h"
@@ -15,6 +19,9 @@
 
 int main(int, char**)
 {
+    PROFILE_THREAD("Main");
+    bul::jobs::init();
+    bul::io::init();
     try
     {
         bul::window::create("Window");
@@ -24,9 +31,13 @@ int main(int, char**)
         // auto renderer = Renderer::create(context, device, surface);
         auto renderer = PathTracingRenderer::create(context, device, surface);
         renderer.init();
+        // What the scene costs once loaded
+        bul::memory::report();
 
         while (!bul::window::should_close())
         {
+            PROFILE_FRAME();
+            bul::memory::frame();
             bul::time::update();
             bul::window::poll_events();
 
@@ -55,4 +66,6 @@ int main(int, char**)
     {
         std::cerr << "Uncaught exception: " << e.what() << "\n";
     }
+    bul::io::shutdown();
+    bul::jobs::shutdown();
 }
@@ -3,20 +3,22 @@
 #include <functional>
 #include <vector>
 
+#include "bul/hash.h"
+
 template<typename T>
 size_t hash_value(const T& v)
 {
-    return std::hash<T>{}(v);
+    return bul::hash(v);
 }
 
 inline void hash_combine(std::size_t&)
 {}
 
+// The previous hash seeds the hash of the next value
 template <typename T, typename... Rest>
-inline void hash_combine(std::size_t& seed, const T& v, Rest... rest)
+inline void hash_combine(std::size_t& seed, const T& v, const Rest&... rest)
 {
-    std::hash<T> hasher;
-    seed ^= hasher(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed = bul::hash_seeded(v, seed);
     hash_combine(seed, rest...);
 }
 
@@ -27,12 +29,7 @@ struct hash<std::vector<T>>
 {
     size_t operator()(const std::vector<T>& v) const noexcept
     {
-        std::size_t hash = v.size();
-        for (size_t i = 0; i < v.size(); ++i)
-        {
-            hash_combine(hash, v[i]);
-        }
-        return hash;
+        return bul::hash(v);
     }
 };
 } // namespace std